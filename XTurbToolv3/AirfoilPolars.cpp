@@ -0,0 +1,534 @@
+#include "AirfoilPolars.h"
+#include "HelperFunctions.h"
+#include "MappedFile.h"
+#include "RowTokenizer.h"
+#include "Logger.h"
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string_view>
+
+namespace {
+    constexpr double pi = 3.14159265358979323846;
+    constexpr double degree = pi / 180.0;
+    constexpr size_t maxGridPoints = size_t(1) << 16;
+
+    // Linear interpolation in ascending x, held constant outside
+    double interpolate(const std::vector<double>& x, const std::vector<double>& y, double at) {
+        size_t count = x.size();
+        if (count == 1 || at <= x[0]) return y[0];
+        if (at >= x[count - 1]) return y[count - 1];
+        size_t upper = std::upper_bound(x.begin(), x.end(), at) - x.begin();
+        double t = (at - x[upper - 1]) / (x[upper] - x[upper - 1]);
+        return y[upper - 1] + t * (y[upper] - y[upper - 1]);
+    }
+
+    bool onGrid(const AirfoilPolar& polar, double first, double step) {
+        for (double angle : polar.alpha) {
+            double position = (angle - first) / step;
+            if (std::abs(position - std::round(position)) > 1e-6) return false;
+        }
+        return true;
+    }
+
+    // Viterna-Corrigan beyond the stall angle of one side of a polar, in angles measured away from zero on that side
+    struct ViternaBranch {
+        double stall = 0.0;          // Degrees, in (0, 90)
+        double stallLift = 0.0, stallDrag = 0.0, zeroDrag = 0.0;
+        double a1 = 0.0, a2 = 0.0, b1 = 0.0, b2 = 0.0;
+
+        ViternaBranch(double stallDeg, double liftAtStall, double dragAtStall, double maxDrag, double dragAtZero)
+            : stall(stallDeg), stallLift(liftAtStall), stallDrag(dragAtStall), zeroDrag(dragAtZero) {
+            double s = stall * degree;
+            b1 = maxDrag;
+            a1 = b1 / 2.0;
+            a2 = (stallLift - maxDrag * std::sin(s) * std::cos(s)) * std::sin(s) / (std::cos(s) * std::cos(s));
+            b2 = (stallDrag - maxDrag * std::sin(s) * std::sin(s)) / std::cos(s);
+        }
+
+        // Viterna up to 90 degrees, then the mirrored curve with 70 % lift, then linear to zero lift at 180 (trailing edge first)
+        void at(double angle, double& lift, double& drag) const {
+            if (angle <= 90.0) {
+                double x = angle * degree;
+                lift = a1 * std::sin(2.0 * x) + a2 * std::cos(x) * std::cos(x) / std::sin(x);
+                drag = b1 * std::sin(x) * std::sin(x) + b2 * std::cos(x);
+            }
+            else if (angle <= 180.0 - stall) {
+                at(180.0 - angle, lift, drag);
+                lift *= -0.7;
+            }
+            else {
+                double t = (180.0 - angle) / stall;
+                lift = -0.7 * stallLift * t;
+                drag = zeroDrag + t * (stallDrag - zeroDrag);
+            }
+        }
+    };
+
+    // Angles from the table edge out to 180 degrees, on the table's own grid so the extended polar still resamples exactly
+    std::vector<double> extension(double edge, double step) {
+        std::vector<double> angles;
+        size_t count = static_cast<size_t>(std::ceil((180.0 - edge) / step - 1e-6));
+        for (size_t k = 1; k <= count; ++k) angles.push_back(std::min(edge + static_cast<double>(k) * step, 180.0));
+        return angles;
+    }
+
+    struct FileStamp {
+        uintmax_t size = 0;
+        std::filesystem::file_time_type modified;
+        bool operator==(const FileStamp& other) const { return size == other.size && modified == other.modified; }
+    };
+
+    bool stampFile(const std::filesystem::path& path, FileStamp& stamp) {
+        std::error_code ec;
+        stamp.size = std::filesystem::file_size(path, ec);
+        if (ec) return false;
+        stamp.modified = std::filesystem::last_write_time(path, ec);
+        return !ec;
+    }
+
+    struct LoadedPolar {
+        FileStamp stamp;
+        std::shared_ptr<const AirfoilPolar> polar;
+    };
+
+    // The source polar and correction are the full key; the map key is only their hash
+    struct CorrectedPolar {
+        std::shared_ptr<const AirfoilPolar> source;
+        PolarCorrection correction;
+        std::shared_ptr<const AirfoilPolar> polar;
+        uint64_t lastUsed = 0;
+    };
+
+    // Likewise the stations, (corrected) polars and blending the tables were built from
+    struct BuiltTables {
+        std::vector<double> stations;
+        std::vector<std::shared_ptr<const AirfoilPolar>> polars;
+        int blending[2] = {};
+        std::shared_ptr<const SpanwisePolars> tables;
+        uint64_t lastUsed = 0;
+    };
+
+    struct LibraryState {
+        std::mutex mutex;
+        std::map<std::wstring, LoadedPolar> polars;    // By normalised path
+        std::map<uint64_t, CorrectedPolar> corrected;  // By polar hash and correction parameters
+        std::map<uint64_t, BuiltTables> spanwise;      // By polar hashes and blending parameters
+        uint64_t useClock = 0;
+        PolarLibrary::Statistics statistics;
+    };
+
+    // Drops the least recently used entries until at most limit are left
+    template <typename Entry>
+    size_t evictOldest(std::map<uint64_t, Entry>& entries, size_t limit) {
+        size_t evicted = 0;
+        while (entries.size() > limit) {
+            auto oldest = entries.begin();
+            for (auto it = entries.begin(); it != entries.end(); ++it) {
+                if (it->second.lastUsed < oldest->second.lastUsed) oldest = it;
+            }
+            entries.erase(oldest);
+            ++evicted;
+        }
+        return evicted;
+    }
+
+    LibraryState& library() {
+        static LibraryState state;
+        return state;
+    }
+}
+
+// Rows are split with RowTokenizer straight from the mapped file; words come out as NaN, which is what skips title lines
+bool AirfoilPolar::load(const std::wstring& path) {
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        return false;
+    }
+    std::vector<std::pair<double, std::pair<double, double>>> rows;
+    std::vector<double> values;
+    std::string spaced;
+    std::string_view content = file.view();
+    while (!content.empty()) {
+        size_t end = content.find('\n');
+        std::string_view line = content.substr(0, end);
+        content.remove_prefix(end == std::string_view::npos ? content.size() : end + 1);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.find('\t') != std::string_view::npos) {
+            spaced.assign(line);
+            std::replace(spaced.begin(), spaced.end(), '\t', ' ');
+            line = spaced;
+        }
+        values.clear();
+        if (RowTokenizer::tokenize(line, values) >= 3 && !std::isnan(values[0]) && !std::isnan(values[1]) && !std::isnan(values[2])) {
+            rows.push_back({ values[0], { values[1], values[2] } });
+        }
+    }
+    std::sort(rows.begin(), rows.end());
+    alpha.clear();
+    cl.clear();
+    cd.clear();
+    for (const auto& row : rows) {
+        if (!alpha.empty() && row.first == alpha.back()) continue;
+        alpha.push_back(row.first);
+        cl.push_back(row.second.first);
+        cd.push_back(row.second.second);
+    }
+    return !alpha.empty();
+}
+
+void AirfoilPolar::lookup(double alphaDeg, double& liftCoefficient, double& dragCoefficient) const {
+    liftCoefficient = interpolate(alpha, cl, alphaDeg);
+    dragCoefficient = interpolate(alpha, cd, alphaDeg);
+}
+
+uint64_t AirfoilPolar::hash() const {
+    uint64_t result = 14695981039346656037ull;
+    for (const auto* column : { &alpha, &cl, &cd }) {
+        result = hashContent(std::string_view(reinterpret_cast<const char*>(column->data()), column->size() * sizeof(double)), result);
+    }
+    return result;
+}
+
+uint64_t PolarCorrection::hash() const {
+    const double fields[] = { viterna ? 1.0 : 0.0, stallDelay ? 1.0 : 0.0, viterna ? maxDrag : 0.0, stallDelay ? chordOverRadius : 0.0 };
+    return hashContent(std::string_view(reinterpret_cast<const char*>(fields), sizeof(fields)));
+}
+
+bool PolarCorrection::operator==(const PolarCorrection& other) const {
+    return viterna == other.viterna && stallDelay == other.stallDelay && (!viterna || maxDrag == other.maxDrag)
+        && (!stallDelay || chordOverRadius == other.chordOverRadius);
+}
+
+AirfoilPolar PolarCorrection::apply(const AirfoilPolar& polar) const {
+    AirfoilPolar result = polar;
+    if (polar.alpha.size() < 2) {
+        return result;
+    }
+
+    if (stallDelay) {
+        // alpha0 is the zero-lift crossing closest to zero degrees
+        double zeroLift = 0.0;
+        double closest = std::numeric_limits<double>::infinity();
+        for (size_t i = 1; i < result.alpha.size(); ++i) {
+            if (result.cl[i - 1] <= 0.0 && result.cl[i] > 0.0) {
+                double crossing = result.alpha[i - 1] - result.cl[i - 1] * (result.alpha[i] - result.alpha[i - 1]) / (result.cl[i] - result.cl[i - 1]);
+                if (std::abs(crossing) < closest) {
+                    closest = std::abs(crossing);
+                    zeroLift = crossing;
+                }
+            }
+        }
+        const double factor = 3.0 * chordOverRadius * chordOverRadius;
+        for (size_t i = 0; i < result.alpha.size(); ++i) {
+            double angle = result.alpha[i];
+            if (angle <= zeroLift || angle >= 50.0) continue;
+            double fade = angle <= 30.0 ? 1.0 : (50.0 - angle) / 20.0;
+            double potential = 2.0 * pi * (angle - zeroLift) * degree;
+            if (potential > result.cl[i]) result.cl[i] += fade * factor * (potential - result.cl[i]);
+        }
+    }
+
+    if (viterna) {
+        double first = 0.0, step = 1.0;
+        size_t count = 2;
+        PolarTable::gridFor({ &result }, first, step, count);
+        double zeroDrag = interpolate(result.alpha, result.cd, 0.0);
+        AirfoilPolar extended;
+        double low = result.alpha.front(), high = result.alpha.back();
+        if (low < 0.0 && low > -90.0) {
+            ViternaBranch branch(-low, -result.cl.front(), result.cd.front(), maxDrag, zeroDrag);
+            std::vector<double> angles = extension(-low, step);
+            for (auto angle = angles.rbegin(); angle != angles.rend(); ++angle) {
+                double lift, drag;
+                branch.at(*angle, lift, drag);
+                extended.alpha.push_back(-*angle);
+                extended.cl.push_back(-lift);
+                extended.cd.push_back(drag);
+            }
+        }
+        extended.alpha.insert(extended.alpha.end(), result.alpha.begin(), result.alpha.end());
+        extended.cl.insert(extended.cl.end(), result.cl.begin(), result.cl.end());
+        extended.cd.insert(extended.cd.end(), result.cd.begin(), result.cd.end());
+        if (high > 0.0 && high < 90.0) {
+            ViternaBranch branch(high, result.cl.back(), result.cd.back(), maxDrag, zeroDrag);
+            for (double angle : extension(high, step)) {
+                double lift, drag;
+                branch.at(angle, lift, drag);
+                extended.alpha.push_back(angle);
+                extended.cl.push_back(lift);
+                extended.cd.push_back(drag);
+            }
+        }
+        result = std::move(extended);
+    }
+    return result;
+}
+
+PolarCorrection PolarCorrection::forStation(const InputData& input, size_t station) {
+    PolarCorrection correction;
+    correction.viterna = input.VITERNA != 0;
+    correction.stallDelay = input.STALLDELAY != 0;
+    if (input.RTAPER.empty() || input.RTAPER.size() != input.CTAPER.size()) {
+        return correction;
+    }
+
+    // Mean chord by the trapezoidal rule over the tabulated span
+    double area = 0.0;
+    for (size_t i = 1; i < input.RTAPER.size(); ++i) {
+        area += 0.5 * (input.CTAPER[i] + input.CTAPER[i - 1]) * (input.RTAPER[i] - input.RTAPER[i - 1]);
+    }
+    double span = input.RTAPER.back() - input.RTAPER.front();
+    if (area > 0.0 && span > 0.0) {
+        double aspectRatio = span * span / area;
+        correction.maxDrag = aspectRatio < 50.0 ? 1.11 + 0.018 * aspectRatio : 2.01;
+    }
+
+    if (station < input.RAIRF.size()) {
+        double inner = input.RAIRF[station];
+        double outer = station + 1 < input.RAIRF.size() ? input.RAIRF[station + 1] : 1.0;
+        double r = std::max(0.5 * (inner + outer), 1e-3);
+        correction.chordOverRadius = interpolate(input.RTAPER, input.CTAPER, r) / r;
+    }
+    return correction;
+}
+
+PolarTable PolarTable::resample(const AirfoilPolar& polar, double first, double step, size_t count) {
+    PolarTable table;
+    table.first = first;
+    table.step = step;
+    table.inverseStep = 1.0 / step;
+    count = std::max<size_t>(count, 2);
+    table.cl.resize(count);
+    table.cd.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        polar.lookup(first + static_cast<double>(i) * step, table.cl[i], table.cd[i]);
+    }
+    return table;
+}
+
+PolarTable PolarTable::blend(const PolarTable& a, const PolarTable& b, double weight) {
+    PolarTable table = a;
+    for (size_t i = 0; i < table.size(); ++i) {
+        table.cl[i] += weight * (b.cl[i] - a.cl[i]);
+        table.cd[i] += weight * (b.cd[i] - a.cd[i]);
+    }
+    return table;
+}
+
+void PolarTable::gridFor(const std::vector<const AirfoilPolar*>& polars, double& first, double& step, size_t& count) {
+    double low = std::numeric_limits<double>::infinity();
+    double high = -low;
+    double spacing = low;
+    for (const AirfoilPolar* polar : polars) {
+        if (polar->alpha.empty()) continue;
+        low = std::min(low, polar->alpha.front());
+        high = std::max(high, polar->alpha.back());
+        for (size_t i = 1; i < polar->alpha.size(); ++i) spacing = std::min(spacing, polar->alpha[i] - polar->alpha[i - 1]);
+    }
+    if (!std::isfinite(low)) {
+        first = 0.0;
+        step = 1.0;
+        count = 2;
+        return;
+    }
+    first = low;
+    if (!std::isfinite(spacing)) {
+        // Only single-row polars: constant, any grid will do
+        step = 1.0;
+        count = 2;
+        return;
+    }
+
+    // The smallest spacing itself covers evenly spaced polars, the decimal steps polars that are finer in places
+    const double candidates[] = { spacing, 1.0, 0.5, 0.25, 0.2, 0.1, 0.05, 0.025, 0.02, 0.01 };
+    step = std::max(spacing / 4.0, 0.01);
+    for (double candidate : candidates) {
+        if (candidate > spacing * (1.0 + 1e-9)) continue;
+        bool exact = true;
+        for (const AirfoilPolar* polar : polars) exact = exact && onGrid(*polar, first, candidate);
+        if (exact) {
+            step = candidate;
+            break;
+        }
+    }
+    count = static_cast<size_t>(std::ceil((high - first) / step - 1e-6)) + 1;
+    if (count > maxGridPoints) {
+        count = maxGridPoints;
+        step = (high - first) / static_cast<double>(count - 1);
+    }
+    count = std::max<size_t>(count, 2);
+}
+
+SpanwisePolars::SpanwisePolars(const InputData& input, const std::vector<const AirfoilPolar*>& polars) {
+    double first = 0.0, step = 1.0;
+    size_t count = 2;
+    PolarTable::gridFor(polars, first, step, count);
+    for (const AirfoilPolar* polar : polars) {
+        tables.push_back(PolarTable::resample(*polar, first, step, count));
+    }
+    stations.assign(input.RAIRF.begin(), input.RAIRF.begin() + std::min(input.RAIRF.size(), polars.size()));
+    stations.resize(polars.size(), stations.empty() ? 0.0 : stations.back());
+    halfWidth = input.BLENDAIRF ? std::max(input.PERCENTR, 0) / 200.0 : 0.0;
+}
+
+SpanwisePolars::Blend SpanwisePolars::at(double r) const {
+    Blend blend;
+    uint32_t i = 0;
+    while (i + 1 < tables.size() && stations[i + 1] <= r) ++i;
+    blend.lower = blend.upper = i;
+    if (halfWidth <= 0.0) {
+        return blend;
+    }
+    if (i + 1 < tables.size() && r > stations[i + 1] - halfWidth) {
+        blend.upper = i + 1;
+        blend.weight = (r - (stations[i + 1] - halfWidth)) / (2.0 * halfWidth);
+    }
+    else if (i > 0 && r < stations[i] + halfWidth) {
+        blend.lower = i - 1;
+        blend.weight = (r - (stations[i] - halfWidth)) / (2.0 * halfWidth);
+    }
+    return blend;
+}
+
+void SpanwisePolars::lookup(const Blend& blend, double alphaDeg, double& liftCoefficient, double& dragCoefficient) const {
+    tables[blend.lower].lookup(alphaDeg, liftCoefficient, dragCoefficient);
+    if (blend.upper != blend.lower) {
+        double upperLift, upperDrag;
+        tables[blend.upper].lookup(alphaDeg, upperLift, upperDrag);
+        liftCoefficient += blend.weight * (upperLift - liftCoefficient);
+        dragCoefficient += blend.weight * (upperDrag - dragCoefficient);
+    }
+}
+
+PolarTable SpanwisePolars::blended(const Blend& blend) const {
+    if (blend.upper == blend.lower) {
+        return tables[blend.lower];
+    }
+    return PolarTable::blend(tables[blend.lower], tables[blend.upper], blend.weight);
+}
+
+// Parsed under the lock, so concurrent runs asking for the same file wait for the one parse instead of repeating it
+std::shared_ptr<const AirfoilPolar> PolarLibrary::polar(const std::wstring& path, std::wstring& error) {
+    std::filesystem::path normal = std::filesystem::path(path).lexically_normal();
+    FileStamp stamp;
+    if (!stampFile(normal, stamp)) {
+        error = L"Failed to read polar " + path;
+        return nullptr;
+    }
+    LibraryState& state = library();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto found = state.polars.find(normal.wstring());
+    if (found != state.polars.end() && found->second.stamp == stamp) {
+        ++state.statistics.reused;
+        return found->second.polar;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto polar = std::make_shared<AirfoilPolar>();
+    if (!polar->load(normal.wstring())) {
+        error = L"Failed to read polar " + path;
+        return nullptr;
+    }
+    state.statistics.parseMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    ++state.statistics.parsed;
+    LOG_DEBUG(L"Loaded polar " + normal.wstring() + L" (" + std::to_wstring(polar->alpha.size()) + L" rows)");
+    state.polars[normal.wstring()] = { stamp, polar };
+    return polar;
+}
+
+std::shared_ptr<const AirfoilPolar> PolarLibrary::corrected(const std::shared_ptr<const AirfoilPolar>& polar, const PolarCorrection& correction) {
+    uint64_t polarHash = polar->hash();
+    uint64_t key = hashContent(std::string_view(reinterpret_cast<const char*>(&polarHash), sizeof(polarHash)), correction.hash());
+    LibraryState& state = library();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto found = state.corrected.find(key);
+    if (found != state.corrected.end() && found->second.correction == correction && found->second.source->sameRows(*polar)) {
+        found->second.lastUsed = ++state.useClock;
+        ++state.statistics.reused;
+        return found->second.polar;
+    }
+    // New, or a hash collision, whose entry is replaced
+    auto result = std::make_shared<const AirfoilPolar>(correction.apply(*polar));
+    state.corrected[key] = { polar, correction, result, ++state.useClock };
+    ++state.statistics.corrected;
+    state.statistics.evicted += evictOldest(state.corrected, maxCorrected);
+    return result;
+}
+
+// Keyed by content, so the same polar under another path (every run's scratch copy) still finds the tables
+std::shared_ptr<const SpanwisePolars> PolarLibrary::spanwise(const InputData& input, const std::wstring& polarDirectory, std::wstring& error) {
+    size_t count = std::min(input.RAIRF.size(), input.AIRFDATA.size());
+    if (count == 0) {
+        error = L"No airfoils (RAIRF / AIRFDATA) given";
+        return nullptr;
+    }
+    std::vector<std::shared_ptr<const AirfoilPolar>> loaded;
+    std::vector<const AirfoilPolar*> polars;
+    uint64_t key = hashContent(std::string_view(reinterpret_cast<const char*>(input.RAIRF.data()), count * sizeof(double)));
+    for (size_t i = 0; i < count; ++i) {
+        std::filesystem::path path(input.AIRFDATA[i]);
+        if (path.is_relative()) path = std::filesystem::path(polarDirectory) / path;
+        auto polar = PolarLibrary::polar(path.wstring(), error);
+        if (!polar) {
+            return nullptr;
+        }
+        PolarCorrection correction = PolarCorrection::forStation(input, i);
+        if (correction.any()) {
+            polar = corrected(polar, correction);
+        }
+        uint64_t polarHash = polar->hash();
+        key = hashContent(std::string_view(reinterpret_cast<const char*>(&polarHash), sizeof(polarHash)), key);
+        polars.push_back(polar.get());
+        loaded.push_back(std::move(polar));
+    }
+    int blending[2] = { input.BLENDAIRF ? 1 : 0, input.BLENDAIRF ? input.PERCENTR : 0 };
+    key = hashContent(std::string_view(reinterpret_cast<const char*>(blending), sizeof(blending)), key);
+
+    std::vector<double> stations(input.RAIRF.begin(), input.RAIRF.begin() + count);
+    auto sameKey = [&](const BuiltTables& built) {
+        if (built.stations != stations || built.blending[0] != blending[0] || built.blending[1] != blending[1]) return false;
+        for (size_t i = 0; i < count; ++i) {
+            if (built.polars[i] != loaded[i] && !built.polars[i]->sameRows(*loaded[i])) return false;
+        }
+        return true;
+    };
+
+    LibraryState& state = library();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto found = state.spanwise.find(key);
+    if (found != state.spanwise.end() && sameKey(found->second)) {
+        found->second.lastUsed = ++state.useClock;
+        return found->second.tables;
+    }
+    // New, or a hash collision, whose entry is replaced
+    auto tables = std::make_shared<const SpanwisePolars>(input, polars);
+    BuiltTables& built = state.spanwise[key];
+    built.stations = std::move(stations);
+    built.polars = std::move(loaded);
+    built.blending[0] = blending[0];
+    built.blending[1] = blending[1];
+    built.tables = tables;
+    built.lastUsed = ++state.useClock;
+    ++state.statistics.tables;
+    state.statistics.evicted += evictOldest(state.spanwise, maxSpanwise);
+    return tables;
+}
+
+PolarLibrary::Statistics PolarLibrary::statistics() {
+    LibraryState& state = library();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.statistics;
+}
+
+void PolarLibrary::clear() {
+    LibraryState& state = library();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.polars.clear();
+    state.corrected.clear();
+    state.spanwise.clear();
+    state.statistics = Statistics();
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#pragma once
+#include "InputData.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Lift and drag of one airfoil over the angle of attack, read from an XTurb polar file
+struct AirfoilPolar {
+    std::vector<double> alpha; // Degrees, ascending
+    std::vector<double> cl;
+    std::vector<double> cd;
+
+    // Every line with at least three numbers is a row (alpha, cl, cd, ...); title and count lines are skipped
+    bool load(const std::wstring& path);
+    // Linear in alpha, held constant outside the table
+    void lookup(double alphaDeg, double& liftCoefficient, double& dragCoefficient) const;
+    // Content hash of the rows, identifies the polar independently of the file it came from
+    uint64_t hash() const;
+    bool sameRows(const AirfoilPolar& other) const { return alpha == other.alpha && cl == other.cl && cd == other.cd; }
+};
+
+// Post-stall extrapolation (VITERNA) and rotational stall delay (STALLDELAY) for one airfoil of a blade. The stall delay is
+// Snel's: cl moves towards the potential-flow 2 pi (alpha - alpha0) by 3 (c/r)^2 of the difference, fading out between 30 and
+// 50 degrees. Viterna-Corrigan then continues both ends of the (corrected) table to 90 degrees; past 90 the curve is mirrored with
+// 70 % of the lift and goes linearly to zero lift at +-180 degrees, so the result covers the full circle.
+struct PolarCorrection {
+    bool viterna = false;
+    bool stallDelay = false;
+    double maxDrag = 2.01;         // Viterna's CDmax, 1.11 + 0.018 AR (2.01 from AR 50 on)
+    double chordOverRadius = 0.0;  // c/r where the airfoil sits
+
+    bool any() const { return viterna || stallDelay; }
+    uint64_t hash() const;
+    // The parameters of a correction that is off do not count, as in hash()
+    bool operator==(const PolarCorrection& other) const;
+    AirfoilPolar apply(const AirfoilPolar& polar) const;
+
+    // For the polar of RAIRF station i of input's blade: aspect ratio from the &BLADE chord distribution, c/r in the middle of
+    // the span the airfoil covers
+    static PolarCorrection forStation(const InputData& input, size_t station);
+};
+
+// A polar resampled onto a uniform angle-of-attack grid, so a lookup is one multiply, one truncation and an interpolation
+// instead of a search. Values are held constant outside the grid, like AirfoilPolar::lookup.
+struct PolarTable {
+    double first = 0.0;       // Degrees, angle of the first grid point
+    double step = 1.0;        // Degrees
+    double inverseStep = 1.0;
+    std::vector<double> cl;   // At first + i * step, at least two points
+    std::vector<double> cd;
+
+    size_t size() const { return cl.size(); }
+
+    void lookup(double alphaDeg, double& liftCoefficient, double& dragCoefficient) const {
+        double x = std::min(std::max((alphaDeg - first) * inverseStep, 0.0), static_cast<double>(cl.size() - 1));
+        size_t index = std::min(static_cast<size_t>(x), cl.size() - 2);
+        double t = x - static_cast<double>(index);
+        liftCoefficient = cl[index] + t * (cl[index + 1] - cl[index]);
+        dragCoefficient = cd[index] + t * (cd[index + 1] - cd[index]);
+    }
+
+    static PolarTable resample(const AirfoilPolar& polar, double first, double step, size_t count);
+    // (1 - weight) * a + weight * b, both on the same grid
+    static PolarTable blend(const PolarTable& a, const PolarTable& b, double weight);
+    // The coarsest grid that has every angle of the polars on a grid point, so resampling is exact. Polars with angles off
+    // any decimal grid get a quarter of their smallest spacing (at least 0.01 degrees).
+    static void gridFor(const std::vector<const AirfoilPolar*>& polars, double& first, double& step, size_t& count);
+};
+
+// The airfoil tables of one blade: one PolarTable per RAIRF station, all on one grid. Airfoil i applies from RAIRF[i]
+// outwards; with BLENDAIRF the polar changes linearly from one airfoil to the next across PERCENTR % of the radius centred
+// on RAIRF[i].
+class SpanwisePolars {
+public:
+    // The table at a radius: (1 - weight) * tables[lower] + weight * tables[upper]
+    struct Blend {
+        uint32_t lower = 0;
+        uint32_t upper = 0;
+        double weight = 0.0;
+    };
+
+    // One polar per RAIRF station, in RAIRF order
+    SpanwisePolars(const InputData& input, const std::vector<const AirfoilPolar*>& polars);
+
+    Blend at(double r) const;
+    void lookup(const Blend& blend, double alphaDeg, double& liftCoefficient, double& dragCoefficient) const;
+    // A table of its own for a blend, for callers that want a single table per station
+    PolarTable blended(const Blend& blend) const;
+
+    const std::vector<PolarTable>& getTables() const { return tables; }
+
+private:
+    std::vector<PolarTable> tables;
+    std::vector<double> stations; // RAIRF
+    double halfWidth = 0.0;       // Half the blending band, in R; 0 without BLENDAIRF
+};
+
+// Process-wide store of parsed polars and spanwise tables. Every polar file is parsed once (again only when its size or
+// modification time changes) and runs of the same blade get the same read-only tables, however many run concurrently.
+// Corrected polars are kept by polar content hash and correction parameters, so a sweep over operating conditions builds them once.
+// Corrected polars and spanwise tables are found by hash and then checked against the polars and parameters they were built from;
+// beyond maxCorrected and maxSpanwise entries the least recently used are dropped (runs still holding them keep them alive).
+class PolarLibrary {
+public:
+    static constexpr size_t maxCorrected = 256;
+    static constexpr size_t maxSpanwise = 64;
+
+    static std::shared_ptr<const AirfoilPolar> polar(const std::wstring& path, std::wstring& error);
+    static std::shared_ptr<const AirfoilPolar> corrected(const std::shared_ptr<const AirfoilPolar>& polar, const PolarCorrection& correction);
+    // Tables for the RAIRF / AIRFDATA / BLENDAIRF / PERCENTR of input with VITERNA / STALLDELAY applied, relative polar paths
+    // resolved against polarDirectory
+    static std::shared_ptr<const SpanwisePolars> spanwise(const InputData& input, const std::wstring& polarDirectory, std::wstring& error);
+
+    struct Statistics {
+        size_t parsed = 0;        // Polar files read
+        size_t reused = 0;        // Requests answered from memory
+        double parseMs = 0.0;     // Time spent reading polar files
+        size_t corrected = 0;     // Corrected polars built
+        size_t tables = 0;        // SpanwisePolars built
+        size_t evicted = 0;       // Corrected polars and SpanwisePolars dropped to stay within the limits
+    };
+    static Statistics statistics();
+    static void clear();
+};
\ No newline at end of file
@@ -1,49 +1,188 @@
 #include "BEMTOutputParser.h"
+#include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <limits>
 #include "Logger.h"
+#include "MappedFile.h"
+#include "OutputCache.h"
+#include "OutputHandler.h"
+#include "RowTokenizer.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 
-BEMTOutputParser::BEMTOutputParser(const std::wstring& filePath)
-    : OutputFileParser(filePath), inTableSection(false) {
+namespace {
+    // Whitespace characters as seen by operator>> on the header lines
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+    }
+
+    // Same trimming as the wide path: only spaces and tabs
+    std::string_view trim(std::string_view s) {
+        size_t first = s.find_first_not_of(" \t");
+        if (first == std::string_view::npos) return std::string_view();
+        size_t last = s.find_last_not_of(" \t");
+        return s.substr(first, last - first + 1);
+    }
+
+    // Appends narrow ASCII bytes to a wide string without a temporary
+    void appendWidened(std::wstring& out, std::string_view s) {
+        for (char c : s) out.push_back(static_cast<wchar_t>(static_cast<unsigned char>(c)));
+    }
+
+    // Chunks smaller than this are not worth a separate task
+    constexpr size_t minChunkBytes = 1 << 20;
+
+    // Pool used by ChunkParallel when the caller does not provide one
+    ThreadPool& sharedParsePool() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    // Splits the table section into roughly equal chunks. Every chunk except the first starts at the beginning of a --- line,
+    // which is the only place where the parser state is known without parsing what comes before.
+    std::vector<std::string_view> splitAtDelimiters(std::string_view buffer, size_t chunkCount) {
+        std::vector<std::string_view> chunks;
+        size_t chunkStart = 0;
+        for (size_t k = 1; k < chunkCount; ++k) {
+            size_t target = buffer.size() / chunkCount * k;
+            if (target <= chunkStart) continue;
+            size_t lineStart = buffer.rfind('\n', target - 1);
+            lineStart = lineStart == std::string_view::npos ? 0 : lineStart + 1;
+            if (lineStart <= chunkStart) {
+                size_t newline = buffer.find('\n', target);
+                lineStart = newline == std::string_view::npos ? newline : newline + 1;
+            }
+            size_t split = std::string_view::npos;
+            while (lineStart != std::string_view::npos && lineStart < buffer.size()) {
+                size_t lineEnd = buffer.find('\n', lineStart);
+                if (lineEnd == std::string_view::npos) lineEnd = buffer.size();
+                if (buffer.substr(lineStart, lineEnd - lineStart).find("---") != std::string_view::npos) {
+                    split = lineStart;
+                    break;
+                }
+                lineStart = lineEnd + 1;
+            }
+            if (split == std::string_view::npos) break;
+            if (split > chunkStart) {
+                chunks.push_back(buffer.substr(chunkStart, split - chunkStart));
+                chunkStart = split;
+            }
+        }
+        chunks.push_back(buffer.substr(chunkStart));
+        return chunks;
+    }
+
+    // Records what a chunk parser reports so it can be replayed to the caller's handler in file order.
+    // Tables are collected whole and handed over with onTable, so a builder takes them over without copying the rows.
+    class ChunkRecorder : public OutputHandler {
+    public:
+        enum class Kind { HeaderLine, SingleValue, Table };
+        struct Event {
+            Kind kind;
+            size_t index;
+        };
+
+        void onHeaderLine(const std::wstring& line) override {
+            events.push_back({ Kind::HeaderLine, texts.size() });
+            texts.push_back(line);
+        }
+        void onSingleValue(const std::wstring& key, const std::wstring& value) override {
+            events.push_back({ Kind::SingleValue, texts.size() });
+            texts.push_back(key);
+            texts.push_back(value);
+        }
+        void onTableStart(const std::vector<std::wstring>& headers) override {
+            events.push_back({ Kind::Table, tables.size() });
+            tables.emplace_back();
+            tables.back().headers = headers;
+            tables.back().columns.resize(headers.size());
+        }
+        void onRow(const double* values, size_t count) override {
+            auto& columns = tables.back().columns;
+            for (size_t i = 0; i < count && i < columns.size(); ++i) columns[i].push_back(values[i]);
+        }
+
+        void replay(OutputHandler& handler) {
+            for (const Event& event : events) {
+                if (event.kind == Kind::HeaderLine) handler.onHeaderLine(texts[event.index]);
+                else if (event.kind == Kind::SingleValue) handler.onSingleValue(texts[event.index], texts[event.index + 1]);
+                else handler.onTable(std::move(tables[event.index]));
+            }
+        }
+
+    private:
+        std::vector<Event> events;
+        std::vector<std::wstring> texts;
+        std::vector<OutputData::Table> tables;
+    };
+}
+
+BEMTOutputParser::BEMTOutputParser(const std::wstring& filePath, ParseMode mode, ThreadPool* pool)
+    : OutputFileParser(filePath), mode(mode), pool(pool), cacheEnabled(true), inTableSection(false), tableOpen(false), tableRows(0), tableCount(0) {
+}
+
+// Reports a complete row, announcing the table first if this is its first row
+void BEMTOutputParser::addRow(const std::vector<double>& row, OutputHandler& handler) {
+    if (!tableOpen) {
+        handler.onTableStart(tableHeaders);
+        tableOpen = true;
+    }
+    handler.onRow(row.data(), row.size());
+    ++tableRows;
+}
+
+// Closes the current table. Tables without rows were never announced and are dropped, as before.
+void BEMTOutputParser::endTable(OutputHandler& handler) {
+    if (!tableOpen) {
+        return;
+    }
+    LOG_DEBUG(L"Table parsed with " + std::to_wstring(tableRows) + L" rows");
+    handler.onTableEnd();
+    tableOpen = false;
+    tableRows = 0;
+    ++tableCount;
 }
 
-bool BEMTOutputParser::processLine(const std::wstring& line, OutputData& data) {
+bool BEMTOutputParser::processLine(const std::wstring& line, OutputHandler& handler) {
     std::wstring trimmedLine = line;
     trimmedLine.erase(0, trimmedLine.find_first_not_of(L" \t"));
     trimmedLine.erase(trimmedLine.find_last_not_of(L" \t") + 1);
 
     //Log error, add empty line to header text, and mark as processed
     if (trimmedLine.empty()) {
-        Logger::logError(L"Empty line skipped");
-        data.headerText += line + L"\r\n"; // Add to header text
+        LOG_TRACE(L"Empty line skipped");
+        handler.onHeaderLine(line); // Add to header text
         return true;
     }
 
     //Check for table delimiter, handle current table, and update header text
     if (trimmedLine.find(L"---") != std::wstring::npos) {
-        if (inTableSection && !currentTable.headers.empty() && !currentTable.rows.empty()) {
-            data.tables.push_back(currentTable);
-            Logger::logError(L"Table parsed with " + std::to_wstring(currentTable.rows.size()) + L" rows");
+        if (inTableSection) {
+            endTable(handler);
         }
-        currentTable.rows.clear();
         inTableSection = true;
-        data.headerText += line + L"\r\n"; // Add to header text
+        handler.onHeaderLine(line); // Add to header text
         return true;
     }
 
     if (inTableSection) {
         //Log entry into table section for current line
-        Logger::logError(L"Reached table section for line: " + trimmedLine);
-        if (!currentTable.headers.empty()) {
+        LOG_TRACE(L"Reached table section for line: " + trimmedLine);
+        if (!tableHeaders.empty()) {
             //Process a row of data in the table
-            Logger::logError(L"Processing table row: " + trimmedLine);
+            LOG_TRACE(L"Processing table row: " + trimmedLine);
             std::vector<double> row;
             size_t pos = 0, prev = 0;
             while ((pos = trimmedLine.find(L" ", prev)) != std::wstring::npos) {
                 //Extract each token separated by spaces and validate it
                 std::wstring token = trimmedLine.substr(prev, pos - prev);
                 if (!token.empty()) {
-                    Logger::logError(L"Token found: " + token);
+                    LOG_TRACE(L"Token found: " + token);
                     if (token == L"Infinity") {
                         row.push_back(std::numeric_limits<double>::infinity());
                     }
@@ -54,7 +193,7 @@ bool BEMTOutputParser::processLine(const std::wstring& line, OutputData& data) {
                         }
                         catch (...) {
                             //Handle invalid tokens and replace them with NaN
-                            Logger::logError(L"Invalid token '" + token + L"' replaced with NaN");
+                            LOG_TRACE(L"Invalid token '" + token + L"' replaced with NaN");
                             row.push_back(std::numeric_limits<double>::quiet_NaN());
                         }
                     }
@@ -64,7 +203,7 @@ bool BEMTOutputParser::processLine(const std::wstring& line, OutputData& data) {
             //Handle the last token separately
             std::wstring lastToken = trimmedLine.substr(prev);
             if (!lastToken.empty()) {
-                Logger::logError(L"Token found: " + lastToken);
+                LOG_TRACE(L"Token found: " + lastToken);
                 if (lastToken == L"Infinity") {
                     row.push_back(std::numeric_limits<double>::infinity());
                 }
@@ -73,30 +212,30 @@ bool BEMTOutputParser::processLine(const std::wstring& line, OutputData& data) {
                         row.push_back(std::stod(lastToken));
                     }
                     catch (...) {
-                        Logger::logError(L"Invalid token '" + lastToken + L"' replaced with NaN");
+                        LOG_TRACE(L"Invalid token '" + lastToken + L"' replaced with NaN");
                         row.push_back(std::numeric_limits<double>::quiet_NaN());
                     }
                 }
             }
             //Verify the row matches the expected number of columns
-            Logger::logError(L"Parsed " + std::to_wstring(row.size()) + L" values, expected " + std::to_wstring(currentTable.headers.size()));
-            if (!row.empty() && row.size() == currentTable.headers.size()) {
-                //Add the valid row to the table
-                currentTable.rows.push_back(row);
-                Logger::logError(L"Data row added: " + trimmedLine);
+            LOG_TRACE(L"Parsed " + std::to_wstring(row.size()) + L" values, expected " + std::to_wstring(tableHeaders.size()));
+            if (!row.empty() && row.size() == tableHeaders.size()) {
+                //Report the valid row
+                addRow(row, handler);
+                LOG_TRACE(L"Data row added: " + trimmedLine);
             }
             else if (!row.empty()) {
                 //Log a mismatch between row size and expected columns
-                Logger::logError(L"Row size mismatch: got " + std::to_wstring(row.size()) + L", expected " + std::to_wstring(currentTable.headers.size()));
+                LOG_TRACE(L"Row size mismatch: got " + std::to_wstring(row.size()) + L", expected " + std::to_wstring(tableHeaders.size()));
             }
             else {
                 //No valid data parsed from row
-                Logger::logError(L"No valid tokens parsed from row");
+                LOG_TRACE(L"No valid tokens parsed from row");
             }
         }
         else {
             //Handle case where table headers are not set
-            Logger::logError(L"Headers empty in table section");
+            LOG_TRACE(L"Headers empty in table section");
         }
     }
     else {
@@ -106,16 +245,16 @@ bool BEMTOutputParser::processLine(const std::wstring& line, OutputData& data) {
         ss >> firstToken;
         if (firstToken == L"r/R" || firstToken == L"Number") {
             //Set table headers if a valid table start token is detected
-            currentTable.headers.clear();
+            tableHeaders.clear();
             std::wstringstream headerSS(trimmedLine);
             std::wstring header;
             while (headerSS >> header) {
-                currentTable.headers.push_back(header);
+                tableHeaders.push_back(header);
             }
-            Logger::logError(L"Table headers set: " + trimmedLine + L" (" + std::to_wstring(currentTable.headers.size()) + L" columns)");
+            LOG_TRACE(L"Table headers set: " + trimmedLine + L" (" + std::to_wstring(tableHeaders.size()) + L" columns)");
             // If this is the "r/R" table, stop adding to headerText
             if (firstToken != L"r/R") {
-                data.headerText += line + L"\r\n";
+                handler.onHeaderLine(line);
             }
         }
         //Handle key-value pairs for single values
@@ -126,19 +265,266 @@ bool BEMTOutputParser::processLine(const std::wstring& line, OutputData& data) {
                 std::wstring value = trimmedLine.substr(eqPos + 1);
                 key.erase(key.find_last_not_of(L" \t") + 1);
                 value.erase(0, value.find_first_not_of(L" \t"));
-                data.singleValues[key] = value;
-                Logger::logError(L"Single value: " + key + L" = " + value);
+                handler.onSingleValue(key, value);
+                LOG_TRACE(L"Single value: " + key + L" = " + value);
             }
             //Append non-table lines to header text
-            data.headerText += line + L"\r\n"; // Add to header text
+            handler.onHeaderLine(line); // Add to header text
         }
     }
     return true;
 }
 
-//Attempt to open the file and handle errors if the file cannot be opened
+// Narrow counterpart of processLine used by the memory-mapped path. The line is a view into the mapped file, so nothing is copied
+// except the text handed to the handler. Behaviour matches the wide version line for line.
+bool BEMTOutputParser::processLine(std::string_view line, OutputHandler& handler) {
+    std::string_view trimmedLine = trim(line);
+
+    if (trimmedLine.empty()) {
+        lineBuffer.clear();
+        appendWidened(lineBuffer, line);
+        handler.onHeaderLine(lineBuffer);
+        return true;
+    }
+
+    if (trimmedLine.find("---") != std::string_view::npos) {
+        if (inTableSection) {
+            endTable(handler);
+        }
+        inTableSection = true;
+        lineBuffer.clear();
+        appendWidened(lineBuffer, line);
+        handler.onHeaderLine(lineBuffer);
+        return true;
+    }
+
+    if (inTableSection) {
+        if (tableHeaders.empty()) {
+            return true;
+        }
+        //Split on single spaces like the wide path; the tokenizer scans for the boundaries with SIMD
+        rowBuffer.clear();
+        RowTokenizer::tokenize(trimmedLine, rowBuffer);
+        if (!rowBuffer.empty() && rowBuffer.size() == tableHeaders.size()) {
+            addRow(rowBuffer, handler);
+        }
+        else if (!rowBuffer.empty()) {
+            LOG_TRACE(L"Row size mismatch: got " + std::to_wstring(rowBuffer.size()) + L", expected " + std::to_wstring(tableHeaders.size()));
+        }
+        return true;
+    }
+
+    //Header line of a table: first whitespace separated token is r/R or Number
+    size_t tokenEnd = 0;
+    while (tokenEnd < trimmedLine.size() && !isSpace(trimmedLine[tokenEnd])) ++tokenEnd;
+    std::string_view firstToken = trimmedLine.substr(0, tokenEnd);
+    if (firstToken == "r/R" || firstToken == "Number") {
+        tableHeaders.clear();
+        size_t i = 0;
+        while (i < trimmedLine.size()) {
+            while (i < trimmedLine.size() && isSpace(trimmedLine[i])) ++i;
+            size_t start = i;
+            while (i < trimmedLine.size() && !isSpace(trimmedLine[i])) ++i;
+            if (i > start) {
+                std::wstring header;
+                appendWidened(header, trimmedLine.substr(start, i - start));
+                tableHeaders.push_back(std::move(header));
+            }
+        }
+        if (firstToken != "r/R") {
+            lineBuffer.clear();
+            appendWidened(lineBuffer, line);
+            handler.onHeaderLine(lineBuffer);
+        }
+        return true;
+    }
+
+    //Key-value pairs for single values
+    size_t eqPos = trimmedLine.find('=');
+    if (eqPos != std::string_view::npos) {
+        std::string_view key = trimmedLine.substr(0, eqPos);
+        std::string_view value = trimmedLine.substr(eqPos + 1);
+        size_t keyEnd = key.find_last_not_of(" \t");
+        key = keyEnd == std::string_view::npos ? std::string_view() : key.substr(0, keyEnd + 1);
+        size_t valueStart = value.find_first_not_of(" \t");
+        value = valueStart == std::string_view::npos ? std::string_view() : value.substr(valueStart);
+        keyBuffer.clear();
+        appendWidened(keyBuffer, key);
+        valueBuffer.clear();
+        appendWidened(valueBuffer, value);
+        handler.onSingleValue(keyBuffer, valueBuffer);
+    }
+    lineBuffer.clear();
+    appendWidened(lineBuffer, line);
+    handler.onHeaderLine(lineBuffer);
+    return true;
+}
+
+// Builds an OutputData from the streamed contents. A valid sidecar cache replaces the parse, and a fresh parse rebuilds the sidecar.
 bool BEMTOutputParser::parse(OutputData& data) {
-    std::wifstream file(filePath);
+    OutputCache::SourceStamp stamp;
+    bool stamped = cacheEnabled && OutputCache::stampSource(filePath, stamp);
+    if (stamped && OutputCache::load(filePath, stamp, data)) {
+        LOG_INFO(L"Loaded " + filePath + L" from cache with " + std::to_wstring(data.tables.size()) + L" tables");
+        return true;
+    }
+
+    OutputDataBuilder builder(data);
+    if (!parse(builder)) {
+        return false;
+    }
+    if (stamped) {
+        OutputCache::store(filePath, stamp, data);
+    }
+    return true;
+}
+
+// Dispatches to the selected parse mode. The mapped paths fall back to the stream path if the file cannot be mapped.
+bool BEMTOutputParser::parse(OutputHandler& handler) {
+    if (mode == ParseMode::ChunkParallel) {
+        return parseChunked(handler);
+    }
+    if (mode == ParseMode::MemoryMapped) {
+        return parseMapped(handler);
+    }
+    return parseStream(handler);
+}
+
+// Walks the buffer line by line with string_views. getline semantics are kept: the text after the last newline is a line,
+// and a trailing \r (CRLF files read in binary) is dropped like the text-mode stream does.
+// If tableSectionOffset is given, stops after the line that enters the table section and stores where the next line starts.
+bool BEMTOutputParser::processBuffer(std::string_view buffer, OutputHandler& handler, size_t* tableSectionOffset) {
+    size_t pos = 0;
+    while (pos < buffer.size()) {
+        size_t end = buffer.find('\n', pos);
+        if (end == std::string_view::npos) end = buffer.size();
+        std::string_view line = buffer.substr(pos, end - pos);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (!processLine(line, handler)) {
+            return false;
+        }
+        pos = end + 1;
+        if (tableSectionOffset && inTableSection) {
+            break;
+        }
+    }
+    if (tableSectionOffset) {
+        *tableSectionOffset = pos < buffer.size() ? pos : buffer.size();
+    }
+    return true;
+}
+
+// Maps the file and parses it sequentially
+bool BEMTOutputParser::parseMapped(OutputHandler& handler) {
+    MappedFile file(filePath);
+    if (!file.isOpen()) {
+        Logger::logError(L"Failed to map file, falling back to stream parsing: " + filePath);
+        return parseStream(handler);
+    }
+
+    if (!processBuffer(file.view(), handler)) {
+        return false;
+    }
+    endTable(handler);
+
+    LOG_INFO(L"Parsing completed for " + filePath + L" with " + std::to_wstring(tableCount) + L" tables");
+    return true;
+}
+
+// Parses the header part sequentially up to the first --- line. From there on the parser stays in the table section and the
+// table headers no longer change, so every later --- line starts an independent chunk: state is (in table, same headers, no rows).
+// Each chunk records its events and the recordings are replayed in file order, which gives the handler exactly the sequential sequence.
+// The calling thread parses chunks too, so this is safe to call from a task running on the same pool.
+bool BEMTOutputParser::parseChunked(OutputHandler& handler) {
+    MappedFile file(filePath);
+    if (!file.isOpen()) {
+        Logger::logError(L"Failed to map file, falling back to stream parsing: " + filePath);
+        return parseStream(handler);
+    }
+
+    std::string_view buffer = file.view();
+    size_t tableStart = 0;
+    if (!processBuffer(buffer, handler, &tableStart)) {
+        return false;
+    }
+    std::string_view tableSection = buffer.substr(tableStart);
+
+    ThreadPool& workers = pool ? *pool : sharedParsePool();
+    size_t chunkCount = std::min(workers.size() * 4, tableSection.size() / minChunkBytes);
+    std::vector<std::string_view> chunks = splitAtDelimiters(tableSection, chunkCount > 1 ? chunkCount : 1);
+    if (chunks.size() <= 1) {
+        if (!processBuffer(tableSection, handler)) {
+            return false;
+        }
+        endTable(handler);
+        LOG_INFO(L"Parsing completed for " + filePath + L" with " + std::to_wstring(tableCount) + L" tables");
+        return true;
+    }
+
+    // Shared between the caller and the helper tasks. Helpers that start after all chunks are taken return without touching the buffer.
+    struct ChunkState {
+        std::vector<std::string_view> chunks;
+        std::vector<ChunkRecorder> recordings;
+        std::vector<size_t> tableCounts;
+        std::vector<char> succeeded;
+        std::vector<std::wstring> headers;
+        std::wstring filePath;
+        std::atomic<size_t> next{ 0 };
+        size_t done = 0;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto state = std::make_shared<ChunkState>();
+    state->chunks = std::move(chunks);
+    state->recordings.resize(state->chunks.size());
+    state->tableCounts.assign(state->chunks.size(), 0);
+    state->succeeded.assign(state->chunks.size(), 0);
+    state->headers = tableHeaders;
+    state->filePath = filePath;
+
+    auto work = [](ChunkState& shared) {
+        size_t index;
+        while ((index = shared.next.fetch_add(1)) < shared.chunks.size()) {
+            BEMTOutputParser chunkParser(shared.filePath, ParseMode::MemoryMapped);
+            chunkParser.inTableSection = true;
+            chunkParser.tableHeaders = shared.headers;
+            ChunkRecorder& recording = shared.recordings[index];
+            bool ok = chunkParser.processBuffer(shared.chunks[index], recording);
+            if (ok) chunkParser.endTable(recording);
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            shared.tableCounts[index] = chunkParser.tableCount;
+            shared.succeeded[index] = ok ? 1 : 0;
+            if (++shared.done == shared.chunks.size()) shared.finished.notify_all();
+        }
+    };
+    size_t helperCount = std::min(workers.size(), state->chunks.size() - 1);
+    for (size_t i = 0; i < helperCount; ++i) {
+        workers.submit([state, work]() { work(*state); });
+    }
+    work(*state);
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&state]() { return state->done == state->chunks.size(); });
+    }
+
+    // Nothing is reported unless every chunk parsed, so a failure does not leave the handler with a partial table section
+    for (size_t i = 0; i < state->chunks.size(); ++i) {
+        if (!state->succeeded[i]) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < state->recordings.size(); ++i) {
+        state->recordings[i].replay(handler);
+        tableCount += state->tableCounts[i];
+    }
+
+    LOG_INFO(L"Parsing completed for " + filePath + L" with " + std::to_wstring(tableCount) + L" tables in " + std::to_wstring(state->chunks.size()) + L" chunks");
+    return true;
+}
+
+//Attempt to open the file and handle errors if the file cannot be opened
+bool BEMTOutputParser::parseStream(OutputHandler& handler) {
+    std::wifstream file(std::filesystem::path{filePath});
     if (!file.is_open()) {
         Logger::logError(L"Failed to open file: " + filePath);
         return false;
@@ -147,20 +533,17 @@ bool BEMTOutputParser::parse(OutputData& data) {
     //Read each line from the file, log it, and process it, stopping on errors.
     std::wstring line;
     while (std::getline(file, line)) {
-        Logger::logError(L"Reading line: " + line);
-        if (!processLine(line, data)) {
+        LOG_TRACE(L"Reading line: " + line);
+        if (!processLine(line, handler)) {
             file.close();
             return false;
         }
     }
-    //Check and finalize the current table, adding it to the data structure if valid.
-    if (inTableSection && !currentTable.headers.empty() && !currentTable.rows.empty()) {
-        data.tables.push_back(currentTable);
-        Logger::logError(L"Final table parsed with " + std::to_wstring(currentTable.rows.size()) + L" rows");
-    }
+    //Close the final table if it received rows
+    endTable(handler);
 
     //Close the file, log the parsing summary, and signal success.
     file.close();
-    Logger::logError(L"Parsing completed for " + filePath + L" with " + std::to_wstring(data.tables.size()) + L" tables");
+    LOG_INFO(L"Parsing completed for " + filePath + L" with " + std::to_wstring(tableCount) + L" tables");
     return true;
 }
\ No newline at end of file
@@ -1,16 +1,46 @@
 #pragma once
 #include "OutputFileParser.h"
 #include "OutputData.h"
+#include <string_view>
+
+class ThreadPool;
 
 // BEMTOutputParser class is responsible for parsing the output file generated by the BEMT method.
 // It is a little misnamed, since it can handle both Vortex and BEMT output files, but it would be too much work to rename it in the entire hiearchy.
 class BEMTOutputParser : public OutputFileParser {
 public:
-    BEMTOutputParser(const std::wstring& filePath);
+    // Stream reads the file through std::wifstream line by line (the original implementation).
+    // MemoryMapped maps the file and tokenizes the narrow bytes in place, which is much faster for large sweep outputs.
+    // ChunkParallel is MemoryMapped with the table section split at the --- delimiters and parsed on several threads.
+    enum class ParseMode { Stream, MemoryMapped, ChunkParallel };
+
+    // The pool is only used by ChunkParallel; without one a shared parser pool is used.
+    BEMTOutputParser(const std::wstring& filePath, ParseMode mode = ParseMode::MemoryMapped, ThreadPool* pool = nullptr);
     bool parse(OutputData& data) override;
+    bool parse(OutputHandler& handler) override;
+    // parse(OutputData&) reads and writes the .xtc sidecar cache (see OutputCache) unless this is turned off
+    void setCacheEnabled(bool enabled) { cacheEnabled = enabled; }
 
 private:
-    bool processLine(const std::wstring& line, OutputData& data) override;
+    bool parseStream(OutputHandler& handler);
+    bool parseMapped(OutputHandler& handler);
+    bool parseChunked(OutputHandler& handler);
+    bool processBuffer(std::string_view buffer, OutputHandler& handler, size_t* tableSectionOffset = nullptr);
+    bool processLine(const std::wstring& line, OutputHandler& handler) override;
+    bool processLine(std::string_view line, OutputHandler& handler);
+    void addRow(const std::vector<double>& row, OutputHandler& handler);
+    void endTable(OutputHandler& handler);
+
+    ParseMode mode;
+    ThreadPool* pool;
+    bool cacheEnabled;
     bool inTableSection;
-    OutputData::Table currentTable;
+    std::vector<std::wstring> tableHeaders;
+    bool tableOpen;  // onTableStart was sent for the current table
+    size_t tableRows;
+    size_t tableCount; // Tables reported so far, for the log summary
+    std::vector<double> rowBuffer; // Reused for every row in the mapped path to avoid per-row temporaries
+    std::wstring lineBuffer;       // Widened text handed to the handler in the mapped path
+    std::wstring keyBuffer;
+    std::wstring valueBuffer;
 };
\ No newline at end of file
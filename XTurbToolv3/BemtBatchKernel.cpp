@@ -0,0 +1,58 @@
+#include "BemtBatchKernel.h"
+#include "AirfoilPolars.h"
+#include "BemtBatchKernelLoops.h"
+#include "CpuFeatures.h"
+
+void BemtLanes::resize(size_t size) {
+    count = size;
+    size_t padded = (size + BemtBatchKernel::width - 1) / BemtBatchKernel::width * BemtBatchKernel::width;
+    for (auto* column : { &r, &chord, &solidity, &pitchedTwist, &tsr, &a, &ap, &alpha, &phi, &F, &cl, &cd, &dCT, &dCP }) {
+        column->assign(padded, 0.0);
+    }
+    airfoil.assign(padded, 0);
+    iterations.assign(padded, 0);
+    converged.assign(padded, 0);
+}
+
+BemtBatchKernel::BemtBatchKernel(const Settings& settings, const std::vector<PolarTable>& tables) : settings(settings) {
+    if (tables.empty()) {
+        tableCl.assign(2, 0.0);
+        tableCd.assign(2, 0.0);
+        return;
+    }
+    tableFirst = tables.front().first;
+    tableInverseStep = tables.front().inverseStep;
+    tableSize = static_cast<int>(tables.front().size());
+    for (const auto& table : tables) {
+        tableCl.insert(tableCl.end(), table.cl.begin(), table.cl.end());
+        tableCd.insert(tableCd.end(), table.cd.begin(), table.cd.end());
+    }
+}
+
+BemtBatchKernel::Implementation BemtBatchKernel::bestImplementation() {
+#ifdef XTURB_X86
+    static const Implementation best = CpuFeatures::hasAVX2FMA() ? Implementation::AVX2 : Implementation::Generic;
+    return best;
+#else
+    return Implementation::Generic;
+#endif
+}
+
+void BemtBatchKernel::solve(BemtLanes& lanes) const {
+    solve(lanes, bestImplementation());
+}
+
+void BemtBatchKernel::solve(BemtLanes& lanes, Implementation implementation) const {
+#ifdef XTURB_X86
+    if (implementation == Implementation::AVX2) {
+        solveAVX2(lanes, 0, lanes.size());
+        return;
+    }
+#endif
+    solveGeneric(lanes, 0, lanes.size());
+}
+
+// The same lane loops, compiled once for the baseline instruction set and once for AVX2 / FMA (BemtBatchKernelAVX2.cpp)
+void BemtBatchKernel::solveGeneric(BemtLanes& lanes, size_t first, size_t last) const {
+    solveRange<Implementation::Generic>(lanes, first, last);
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct PolarTable;
+
+// Blade element lanes in structure-of-arrays layout: lane i is one radial station at one operating point. Inputs are set by the
+// caller, the kernel fills the results. Every array has paddedSize() entries; the lanes past size() are padding and never iterated.
+struct BemtLanes {
+    // Inputs
+    std::vector<double> r;            // r/R
+    std::vector<double> chord;        // c/R
+    std::vector<double> solidity;
+    std::vector<double> pitchedTwist; // Twist plus pitch, degrees
+    std::vector<double> tsr;
+    std::vector<uint32_t> airfoil;    // Index into the kernel's polar tables
+    // Induction the iteration starts from (resize() sets 0, a cold start), replaced by the converged values
+    std::vector<double> a, ap;
+
+    // Results
+    std::vector<double> alpha, phi, F, cl, cd, dCT, dCP;
+    std::vector<uint32_t> iterations;
+    std::vector<uint8_t> converged;
+
+    void resize(size_t count);
+    size_t size() const { return count; }
+    size_t paddedSize() const { return r.size(); }
+
+private:
+    size_t count = 0;
+};
+
+// Solves BEMT induction for many stations and operating points at once. Lanes are streamed through width slots; every step is the
+// same straight-line arithmetic for all slots (selects instead of branches, the polar lookup an index computation on a uniform grid,
+// atan2 / exp / acos as polynomials), so the compiler turns the slot loops into SIMD code. A slot whose lane converged is masked
+// out of the updates and takes the next lane, so one slow lane does not hold up the others. Results match NativeBemtSolver's scalar iteration
+// to the accuracy of the polynomials (about 1e-9 in the angles).
+class BemtBatchKernel {
+public:
+    static constexpr size_t width = 8; // Slots: one AVX-512 or two AVX2 registers of doubles
+    // Generic is whatever the compiler vectorized the slot loops to for the baseline target; AVX2 is the same code built for AVX2 / FMA
+    enum class Implementation { Generic, AVX2 };
+
+    struct Settings {
+        int blades = 3;
+        double root = 0.0;           // r/R of the root, for the root loss
+        bool tipLoss = true;
+        bool rootLoss = false;
+        double axialRelax = 1.0;
+        double tangentialRelax = 1.0;
+        double tolerance = 1e-6;     // On the change of a and a' per iteration
+        unsigned maxIterations = 1000;
+        double maxTangentialInduction = 1.0;
+    };
+
+    // The tables must share one grid, as the tables of a SpanwisePolars do
+    BemtBatchKernel(const Settings& settings, const std::vector<PolarTable>& tables);
+
+    void solve(BemtLanes& lanes) const;
+    void solve(BemtLanes& lanes, Implementation implementation) const;
+    static Implementation bestImplementation();
+    const Settings& getSettings() const { return settings; }
+
+private:
+    void solveGeneric(BemtLanes& lanes, size_t first, size_t last) const;
+    void solveAVX2(BemtLanes& lanes, size_t first, size_t last) const; // BemtBatchKernelAVX2.cpp
+    // BemtBatchKernelLoops.h; one instantiation per implementation, each in the file built for it
+    template <Implementation> void solveRange(BemtLanes& lanes, size_t first, size_t last) const;
+
+    Settings settings;
+    // All tables laid end to end; a lane's lookup is the grid index plus its table's offset
+    double tableFirst = 0.0, tableInverseStep = 1.0;
+    int tableSize = 2;
+    std::vector<double> tableCl, tableCd;
+};
\ No newline at end of file
@@ -0,0 +1,6 @@
+// Built with -mavx2 -mfma (/arch:AVX2), and only called when CpuFeatures::hasAVX2FMA()
+#include "BemtBatchKernelLoops.h"
+
+void BemtBatchKernel::solveAVX2(BemtLanes& lanes, size_t first, size_t last) const {
+    solveRange<Implementation::AVX2>(lanes, first, last);
+}
\ No newline at end of file
@@ -0,0 +1,250 @@
+#pragma once
+// The lane loops of BemtBatchKernel, included by BemtBatchKernel.cpp and BemtBatchKernelAVX2.cpp so they are compiled once for the
+// baseline instruction set and once for AVX2 / FMA. Everything here has internal linkage or is instantiated per implementation, so
+// neither file's copy can stand in for the other's (see CpuFeatures.h).
+#include "BemtBatchKernel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifndef XTURB_FORCE_INLINE
+#ifdef _MSC_VER
+#define XTURB_FORCE_INLINE __forceinline
+#else
+#define XTURB_FORCE_INLINE inline __attribute__((always_inline))
+#endif
+#endif
+
+namespace {
+    constexpr double pi = 3.14159265358979323846;
+    constexpr double degree = pi / 180.0;
+    constexpr size_t W = BemtBatchKernel::width;
+
+    inline uint64_t bits(double value) {
+        uint64_t result;
+        std::memcpy(&result, &value, sizeof(result));
+        return result;
+    }
+
+    inline double fromBits(uint64_t value) {
+        double result;
+        std::memcpy(&result, &value, sizeof(result));
+        return result;
+    }
+
+    // atan2 without branches: the octant is folded with selects, then atan on |z| <= tan(pi/8) as an odd series (error < 1e-10)
+    inline double atan2Poly(double y, double x) {
+        double ax = std::abs(x), ay = std::abs(y);
+        double z = std::min(ax, ay) / std::max(std::max(ax, ay), 1e-300);
+        bool reduced = z > 0.41421356237309503;
+        double folded = (z - 1.0) / (z + 1.0);
+        double zr = reduced ? folded : z;
+        double s = zr * zr;
+        double p = 1.0 / 21.0;
+        p = -1.0 / 19.0 + s * p;
+        p = 1.0 / 17.0 + s * p;
+        p = -1.0 / 15.0 + s * p;
+        p = 1.0 / 13.0 + s * p;
+        p = -1.0 / 11.0 + s * p;
+        p = 1.0 / 9.0 + s * p;
+        p = -1.0 / 7.0 + s * p;
+        p = 1.0 / 5.0 + s * p;
+        p = -1.0 / 3.0 + s * p;
+        double t = (reduced ? pi / 4.0 : 0.0) + zr + zr * s * p;
+        double complement = pi / 2.0 - t;
+        t = ay > ax ? complement : t;
+        double supplement = pi - t;
+        t = x < 0.0 ? supplement : t;
+        double negated = -t;
+        return y < 0.0 ? negated : t;
+    }
+
+    // e^x for x <= 0: x = k ln2 + r with |r| <= ln2 / 2, e^r as a Taylor series, 2^k assembled in the exponent bits
+    inline double expNegative(double x) {
+        constexpr double roundMagic = 6755399441055744.0; // 1.5 * 2^52: adding it rounds to an integer in the low mantissa bits
+        x = std::max(x, -700.0);
+        double shifted = x * 1.4426950408889634 + roundMagic;
+        double k = shifted - roundMagic;
+        double r = x - k * 0.693147180369123816490 - k * 1.90821492927058770002e-10;
+        double p = 1.0 / 39916800.0;
+        p = 1.0 / 3628800.0 + r * p;
+        p = 1.0 / 362880.0 + r * p;
+        p = 1.0 / 40320.0 + r * p;
+        p = 1.0 / 5040.0 + r * p;
+        p = 1.0 / 720.0 + r * p;
+        p = 1.0 / 120.0 + r * p;
+        p = 1.0 / 24.0 + r * p;
+        p = 1.0 / 6.0 + r * p;
+        p = 0.5 + r * p;
+        p = 1.0 + r * p;
+        p = 1.0 + r * p;
+        uint64_t exponent = bits(shifted) - bits(roundMagic) + 1023;
+        return p * fromBits(exponent << 52);
+    }
+
+    // 2/pi acos(e^-f), with acos(x) = atan2(sqrt(1 - x^2), x)
+    inline double prandtlPoly(double f) {
+        double x = expNegative(-std::max(f, 0.0));
+        return 2.0 / pi * atan2Poly(std::sqrt(std::max(1.0 - x * x, 0.0)), x);
+    }
+}
+
+// The block is W slots, each working on one lane. A slot whose lane converged (or ran out of iterations) hands the results back and
+// takes the next lane of the range, so slots do not sit idle while the slowest lane of a fixed block finishes. The refill is the
+// only per-lane branch, and it is only taken in iterations in which some lane retired.
+template <BemtBatchKernel::Implementation>
+XTURB_FORCE_INLINE void BemtBatchKernel::solveRange(BemtLanes& lanes, size_t first, size_t last) const {
+    constexpr size_t none = static_cast<size_t>(-1);
+    const double blades = settings.blades;
+    const double root = settings.root;
+    const double maxIterations = settings.maxIterations;
+    const double tipWeight = settings.tipLoss ? 1.0 : 0.0, rootWeight = settings.rootLoss ? 1.0 : 0.0; // Losses that are off count as 1
+    const double top = tableSize - 1;
+    const double* lift = tableCl.data();
+    const double* drag = tableCd.data();
+
+    // Slot state in local arrays, so the compiler knows nothing aliases them
+    double r[W], chord[W], solidity[W], twist[W], localSpeed[W], tsr[W];
+    int base[W];
+    size_t slotLane[W];
+    double active[W], a[W], ap[W], iterations[W], converged[W];
+    double alphaOut[W], sinOut[W], cosOut[W], phiOut[W], FOut[W], clOut[W], cdOut[W];
+    size_t next = first;
+
+    // Drained slots keep the inputs of their last lane, so their (ignored) arithmetic stays finite
+    auto take = [&](size_t l) {
+        slotLane[l] = next < last ? next++ : none;
+        active[l] = slotLane[l] != none ? 1.0 : 0.0;
+        a[l] = ap[l] = iterations[l] = converged[l] = 0.0;
+        alphaOut[l] = sinOut[l] = cosOut[l] = phiOut[l] = clOut[l] = cdOut[l] = 0.0;
+        FOut[l] = 1.0;
+        if (slotLane[l] == none) {
+            return;
+        }
+        size_t lane = slotLane[l];
+        a[l] = lanes.a[lane];
+        ap[l] = lanes.ap[lane];
+        r[l] = lanes.r[lane];
+        chord[l] = lanes.chord[lane];
+        solidity[l] = lanes.solidity[lane];
+        twist[l] = lanes.pitchedTwist[lane];
+        tsr[l] = lanes.tsr[lane];
+        localSpeed[l] = tsr[l] * r[l];
+        base[l] = static_cast<int>(lanes.airfoil[lane]) * tableSize;
+    };
+
+    // Blade element loads with the final induction, per unit r/R and normalised with 1/2 rho V^2 pi R^2
+    auto hand = [&](size_t l) {
+        size_t lane = slotLane[l];
+        double w2 = (1.0 - a[l]) * (1.0 - a[l]) + localSpeed[l] * localSpeed[l] * (1.0 + ap[l]) * (1.0 + ap[l]);
+        double load = w2 * blades * chord[l] / pi;
+        lanes.a[lane] = a[l];
+        lanes.ap[lane] = ap[l];
+        lanes.alpha[lane] = alphaOut[l];
+        lanes.phi[lane] = phiOut[l] / degree;
+        lanes.F[lane] = FOut[l];
+        lanes.cl[lane] = clOut[l];
+        lanes.cd[lane] = cdOut[l];
+        lanes.dCT[lane] = load * (clOut[l] * cosOut[l] + cdOut[l] * sinOut[l]);
+        lanes.dCP[lane] = load * (clOut[l] * sinOut[l] - cdOut[l] * cosOut[l]) * r[l] * tsr[l];
+        lanes.iterations[lane] = static_cast<uint32_t>(iterations[l]);
+        lanes.converged[lane] = converged[l] != 0.0;
+    };
+
+    if (first >= last) {
+        return;
+    }
+    for (size_t l = 0; l < W; ++l) {
+        take(l);
+        if (slotLane[l] == none) {
+            // Fewer lanes than slots: the idle ones compute on a copy of slot 0
+            r[l] = r[0]; chord[l] = chord[0]; solidity[l] = solidity[0]; twist[l] = twist[0]; tsr[l] = tsr[0]; localSpeed[l] = localSpeed[0];
+            base[l] = base[0];
+        }
+    }
+
+    size_t busy = std::min(W, last - first);
+    while (busy > 0) {
+        double sinPhi[W], cosPhi[W], sinRaw[W], cosRaw[W], phi[W], alpha[W];
+        for (size_t l = 0; l < W; ++l) {
+            double axial = 1.0 - a[l];
+            double tangential = localSpeed[l] * (1.0 + ap[l]);
+            double speed = std::max(std::sqrt(axial * axial + tangential * tangential), 1e-300);
+            sinRaw[l] = axial / speed;
+            cosRaw[l] = tangential / speed;
+            sinPhi[l] = std::max(std::abs(sinRaw[l]), 1e-6);
+            cosPhi[l] = std::copysign(std::max(std::abs(cosRaw[l]), 1e-6), cosRaw[l]);
+            phi[l] = atan2Poly(axial, tangential);
+            alpha[l] = phi[l] / degree - twist[l];
+        }
+
+        // Grid position on the uniform polar table, then linear interpolation (32-bit indices, so the loads become gathers)
+        double cl[W], cd[W];
+        for (size_t l = 0; l < W; ++l) {
+            double x = std::min(std::max((alpha[l] - tableFirst) * tableInverseStep, 0.0), top);
+            int index = std::min(static_cast<int>(x), tableSize - 2);
+            double t = x - index;
+            int at = base[l] + index;
+            cl[l] = lift[at] + t * (lift[at + 1] - lift[at]);
+            cd[l] = drag[at] + t * (drag[at + 1] - drag[at]);
+        }
+
+        // Tip and root loss factors side by side, so one loop evaluates all 2 * W of them
+        double loss[2 * W];
+        for (size_t l = 0; l < W; ++l) {
+            loss[l] = 0.5 * blades * (1.0 - r[l]) / (r[l] * sinPhi[l]);
+            loss[W + l] = 0.5 * blades * (r[l] - root) / (r[l] * sinPhi[l]);
+        }
+        for (size_t l = 0; l < 2 * W; ++l) {
+            loss[l] = prandtlPoly(loss[l]);
+        }
+
+        double retired = 0.0, limited = 0.0;
+        for (size_t l = 0; l < W; ++l) {
+            double F = std::max((1.0 + tipWeight * (loss[l] - 1.0)) * (1.0 + rootWeight * (loss[W + l] - 1.0)), 1e-4);
+
+            double cn = cl[l] * cosPhi[l] + cd[l] * sinRaw[l];
+            double ct = cl[l] * sinRaw[l] - cd[l] * cosPhi[l];
+            double sin2 = sinPhi[l] * sinPhi[l];
+            double k = solidity[l] * cn / (4.0 * F * sin2);
+            double momentum = k / (1.0 + k);
+            // Buhl's high-induction branch is computed for every lane and selected
+            double thrust = solidity[l] * (1.0 - a[l]) * (1.0 - a[l]) * cn / sin2;
+            double discriminant = std::max(thrust * (50.0 - 36.0 * F) + 12.0 * F * (3.0 * F - 4.0), 0.0);
+            double buhl = (18.0 * F - 20.0 - 3.0 * std::sqrt(discriminant)) / (36.0 * F - 50.0);
+            double aNew = momentum > 0.4 ? buhl : momentum;
+            double kp = solidity[l] * ct / (4.0 * F * sinPhi[l] * cosPhi[l]);
+            double bounded = std::min(std::max(kp / std::max(1.0 - kp, 1e-3), -settings.maxTangentialInduction), settings.maxTangentialInduction);
+            double apNew = kp < 1.0 - 1e-3 ? bounded : settings.maxTangentialInduction;
+
+            // Masked update: mask is 1 for lanes still iterating and 0 for converged ones, whose values then stay as they are
+            double mask = active[l];
+            double da = aNew - a[l], dap = apNew - ap[l];
+            alphaOut[l] += mask * (alpha[l] - alphaOut[l]);
+            phiOut[l] += mask * (phi[l] - phiOut[l]);
+            sinOut[l] += mask * (sinRaw[l] - sinOut[l]);
+            cosOut[l] += mask * (cosRaw[l] - cosOut[l]);
+            FOut[l] += mask * (F - FOut[l]);
+            clOut[l] += mask * (cl[l] - clOut[l]);
+            cdOut[l] += mask * (cd[l] - cdOut[l]);
+            a[l] += mask * settings.axialRelax * da;
+            ap[l] += mask * settings.tangentialRelax * dap;
+            iterations[l] += mask;
+            limited += iterations[l] >= maxIterations ? mask : 0.0;
+            double done = std::abs(da) < settings.tolerance && std::abs(dap) < settings.tolerance ? 1.0 : 0.0;
+            converged[l] = std::max(converged[l], mask * done);
+            active[l] = mask * (1.0 - done);
+            retired += mask * done;
+        }
+        if (retired == 0.0 && limited == 0.0) {
+            continue;
+        }
+        for (size_t l = 0; l < W; ++l) {
+            if (slotLane[l] != none && (active[l] == 0.0 || iterations[l] >= maxIterations)) {
+                hand(l);
+                take(l);
+                if (slotLane[l] == none) --busy;
+            }
+        }
+    }
+}
\ No newline at end of file
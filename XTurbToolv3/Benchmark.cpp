@@ -0,0 +1,364 @@
+// Micro-benchmarks for the output processing and native solver hot paths. Like TestParser.cpp this is a standalone harness and
+// not part of the XTurbToolv3 project: build it in its own console project (or with any compiler) together with the sources it
+// includes.
+#include "RowTokenizer.h"
+#include "NativeBemtSolver.h"
+#include "NativeHvmSolver.h"
+#include "OutputData.h"
+#include "Logger.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    // Rows as the solver writes them: leading blanks, E-format values separated by runs of spaces, occasional Infinity
+    std::vector<std::string> makeRows(size_t count, size_t columns) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> dist(-50.0, 50.0);
+        std::vector<std::string> rows;
+        rows.reserve(count);
+        char buffer[32];
+        for (size_t r = 0; r < count; ++r) {
+            std::string row = "  ";
+            for (size_t c = 0; c < columns; ++c) {
+                if (r % 97 == 0 && c == 3) {
+                    row += "Infinity";
+                }
+                else {
+                    snprintf(buffer, sizeof(buffer), "%.6E", dist(rng));
+                    row += buffer;
+                }
+                row += "   ";
+            }
+            rows.push_back(row.substr(2, row.size() - 5)); // Trimmed, as processLine hands it over
+        }
+        return rows;
+    }
+
+    // The row loop BEMTOutputParser used before the tokenizer: wide strings, find/substr and std::stod in a try block
+    size_t legacyTokenize(const std::wstring& trimmedLine, std::vector<double>& row) {
+        size_t pos = 0, prev = 0;
+        auto convert = [&row](const std::wstring& token) {
+            if (token == L"Infinity") {
+                row.push_back(std::numeric_limits<double>::infinity());
+                return;
+            }
+            try {
+                row.push_back(std::stod(token));
+            }
+            catch (...) {
+                row.push_back(std::numeric_limits<double>::quiet_NaN());
+            }
+        };
+        while ((pos = trimmedLine.find(L" ", prev)) != std::wstring::npos) {
+            std::wstring token = trimmedLine.substr(prev, pos - prev);
+            if (!token.empty()) convert(token);
+            prev = pos + 1;
+        }
+        std::wstring lastToken = trimmedLine.substr(prev);
+        if (!lastToken.empty()) convert(lastToken);
+        return row.size();
+    }
+
+    template <typename Function>
+    double timeMs(Function function) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void report(const wchar_t* name, double ms, size_t bytes, double checksum) {
+        wchar_t line[160];
+        swprintf(line, 160, L"%-28ls %9.2f ms %9.1f MB/s  (checksum %.6g)", name, ms, bytes / 1e6 / (ms / 1e3), checksum);
+        Logger::logError(line);
+    }
+
+    void benchmarkRowTokenizer() {
+        const std::vector<std::string> rows = makeRows(200000, 12);
+        std::vector<std::wstring> wideRows;
+        size_t bytes = 0;
+        for (const auto& row : rows) {
+            wideRows.emplace_back(row.begin(), row.end());
+            bytes += row.size();
+        }
+        std::vector<double> values;
+        values.reserve(64);
+
+        double checksum = 0;
+        double ms = timeMs([&]() {
+            for (const auto& row : wideRows) {
+                values.clear();
+                legacyTokenize(row, values);
+                checksum += values[0];
+            }
+        });
+        report(L"legacy wstring + stod", ms, bytes, checksum);
+
+        const std::pair<const wchar_t*, RowTokenizer::Implementation> implementations[] = {
+            { L"RowTokenizer scalar", RowTokenizer::Implementation::Scalar },
+            { L"RowTokenizer SSE2", RowTokenizer::Implementation::SSE2 },
+            { L"RowTokenizer AVX2", RowTokenizer::Implementation::AVX2 },
+        };
+        for (const auto& [name, implementation] : implementations) {
+            if (implementation == RowTokenizer::Implementation::AVX2 && RowTokenizer::bestImplementation() != implementation) {
+                continue; // CPU (or build) without AVX2
+            }
+            if (implementation != RowTokenizer::Implementation::Scalar && RowTokenizer::bestImplementation() == RowTokenizer::Implementation::Scalar) {
+                continue; // Not an x86 build
+            }
+            checksum = 0;
+            ms = timeMs([&]() {
+                for (const auto& row : rows) {
+                    values.clear();
+                    RowTokenizer::tokenize(row, values, implementation);
+                    checksum += values[0];
+                }
+            });
+            report(name, ms, bytes, checksum);
+        }
+    }
+
+    // Hands one parse result to a number of consumers the way the UI does (batch result -> display windows -> graphs) and checks
+    // with the column byte counter that the tables exist once. The old copy-per-window hand-off is shown for comparison.
+    void benchmarkSnapshotHandOff() {
+        const size_t consumers = 8;
+        OutputData parsed;
+        std::vector<double> row(12);
+        for (size_t t = 0; t < 200; ++t) {
+            OutputData::Table table;
+            table.headers.assign(row.size(), L"col");
+            for (size_t r = 0; r < 1000; ++r) {
+                for (size_t c = 0; c < row.size(); ++c) row[c] = static_cast<double>(r * c);
+                table.addRow(row);
+            }
+            parsed.tables.push_back(std::move(table));
+        }
+        const size_t dataBytes = ColumnMemory::current();
+        wchar_t line[160];
+
+        ColumnMemory::resetPeak();
+        double ms = timeMs([&]() {
+            std::vector<OutputData> windows(consumers, parsed);
+        });
+        swprintf(line, 160, L"%-28ls %9.2f ms  peak %.2fx data", L"copy per window", ms, static_cast<double>(ColumnMemory::peak()) / dataBytes);
+        Logger::logError(line);
+
+        ColumnMemory::resetPeak();
+        ms = timeMs([&]() {
+            OutputSnapshot snapshot = std::make_shared<const OutputData>(std::move(parsed));
+            std::vector<OutputSnapshot> windows(consumers, snapshot);
+            std::vector<OutputData::ColumnView> graphs;
+            for (const auto& window : windows) {
+                for (const auto& table : window->tables) graphs.push_back(table.column(1));
+            }
+        });
+        swprintf(line, 160, L"%-28ls %9.2f ms  peak %.2fx data", L"shared snapshot", ms, static_cast<double>(ColumnMemory::peak()) / dataBytes);
+        Logger::logError(line);
+    }
+
+    // Parse time of a 721-row polar (-180..180 degrees in half degree steps), then lift / drag lookups at random angles on the
+    // parsed rows (binary search) and on the resampled uniform table
+    void benchmarkPolars() {
+        std::filesystem::path path = std::filesystem::temp_directory_path() / "xturb_benchmark.polar";
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file << "Benchmark polar\n 721\n";
+            char buffer[96];
+            for (int i = -360; i <= 360; ++i) {
+                double alpha = 0.5 * i;
+                double radians = alpha * 3.14159265358979 / 180.0;
+                snprintf(buffer, sizeof(buffer), "%8.2f %10.5f %10.5f\n", alpha, 1.1 * std::sin(2.0 * radians), 0.01 + std::abs(std::sin(radians)));
+                file << buffer;
+            }
+        }
+        wchar_t line[160];
+        const int parses = 200;
+        AirfoilPolar polar;
+        double ms = timeMs([&]() {
+            for (int i = 0; i < parses; ++i) polar.load(path.wstring());
+        });
+        swprintf(line, 160, L"%-28ls %9.3f ms per file (%zu rows)", L"polar parse", ms / parses, polar.alpha.size());
+        Logger::logError(line);
+
+        std::wstring error;
+        PolarLibrary::clear();
+        PolarLibrary::polar(path.wstring(), error);
+        ms = timeMs([&]() {
+            for (int i = 0; i < parses; ++i) PolarLibrary::polar(path.wstring(), error);
+        });
+        swprintf(line, 160, L"%-28ls %9.3f ms per request", L"PolarLibrary (cached)", ms / parses);
+        Logger::logError(line);
+
+        const size_t lookups = 4000000;
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> dist(-180.0, 180.0);
+        std::vector<double> angles(4096);
+        for (double& angle : angles) angle = dist(rng);
+        double first = 0.0, step = 1.0;
+        size_t count = 2;
+        PolarTable::gridFor({ &polar }, first, step, count);
+        PolarTable table = PolarTable::resample(polar, first, step, count);
+
+        double checksum = 0.0;
+        ms = timeMs([&]() {
+            for (size_t i = 0; i < lookups; ++i) {
+                double cl, cd;
+                polar.lookup(angles[i % angles.size()], cl, cd);
+                checksum += cl + cd;
+            }
+        });
+        swprintf(line, 160, L"%-28ls %9.1f M lookups/s  (checksum %.6g)", L"search in polar rows", lookups / 1e3 / ms, checksum);
+        Logger::logError(line);
+
+        checksum = 0.0;
+        ms = timeMs([&]() {
+            for (size_t i = 0; i < lookups; ++i) {
+                double cl, cd;
+                table.lookup(angles[i % angles.size()], cl, cd);
+                checksum += cl + cd;
+            }
+        });
+        swprintf(line, 160, L"%-28ls %9.1f M lookups/s  (checksum %.6g, step %.2g)", L"uniform table", lookups / 1e3 / ms, checksum, step);
+        Logger::logError(line);
+        std::filesystem::remove(path);
+    }
+
+    // Thin airfoil lift up to stall, then flat, with a quadratic drag bucket
+    AirfoilPolar syntheticPolar() {
+        AirfoilPolar polar;
+        for (double alpha = -20.0; alpha <= 30.0; alpha += 0.5) {
+            polar.alpha.push_back(alpha);
+            polar.cl.push_back(2.0 * 3.14159265358979 * std::min(std::max(alpha, -10.0), 12.0) * 3.14159265358979 / 180.0);
+            polar.cd.push_back(0.008 + 0.0004 * alpha * alpha);
+        }
+        return polar;
+    }
+
+    // A Cp-vs-TSR grid of the default input (NREL Phase VI blade, 41 stations) on the synthetic polar. Scalar is NativeBemtSolver::evaluate per point, batch is evaluateGrid on the best
+    // kernel implementation for the CPU, every point cold and then warm-started along the continuation path.
+    void benchmarkBemtGrid() {
+        InputData input;
+        input.METHOD = InputData::METHOD_BEMT;
+        NativeBemtSolver solver(input, std::vector<AirfoilPolar>{ syntheticPolar() });
+        std::vector<std::pair<double, double>> grid;
+        for (int p = 0; p < 10; ++p) {
+            for (int t = 0; t < 40; ++t) grid.emplace_back(1.0 + 0.3 * t, -2.0 + p);
+        }
+        wchar_t line[160];
+
+        std::vector<NativeBemtSolver::OperatingPoint> reference;
+        double ms = timeMs([&]() {
+            for (const auto& [tsr, pitch] : grid) reference.push_back(solver.evaluate(tsr, pitch));
+        });
+        swprintf(line, 160, L"%-28ls %9.2f ms", L"scalar per point", ms);
+        Logger::logError(line);
+
+        for (bool continuation : { false, true }) {
+            solver.setContinuation(continuation);
+            std::vector<NativeBemtSolver::OperatingPoint> points;
+            ms = timeMs([&]() {
+                points = solver.evaluateGrid(grid);
+            });
+            double deviation = 0.0;
+            size_t iterations = 0;
+            for (size_t i = 0; i < points.size(); ++i) {
+                deviation = std::max(deviation, std::abs(points[i].CP - reference[i].CP));
+                iterations += points[i].iterations;
+            }
+            swprintf(line, 160, L"%-28ls %9.2f ms  max |dCP| %.2g  %8zu iterations  (%ls)", continuation ? L"batch kernel, warm starts" : L"batch kernel",
+                ms, deviation, iterations, BemtBatchKernel::bestImplementation() == BemtBatchKernel::Implementation::AVX2 ? L"AVX2" : L"generic");
+            Logger::logError(line);
+        }
+    }
+
+    // One HVM operating point (TSR 7) of the default blade over JX and NSEC, with the tree at its default accuracy and, while the
+    // wake is small enough to wait for, every segment summed directly. The wake is rebuilt a fixed number of times so every case
+    // does the same iterations; dCP is the tree's deviation from the direct sum.
+    void benchmarkHvmScaling() {
+        wchar_t line[200];
+        for (int elements : { 10, 20, 40 }) {
+            for (int sectors : { 12, 24, 48 }) {
+                InputData input;
+                input.METHOD = InputData::METHOD_HVM;
+                input.JX = elements;
+                input.NSEC = sectors;
+                input.XTREFFTZ = 4.0;
+                NativeHvmSolver solver(input, std::vector<AirfoilPolar>{ syntheticPolar() });
+                NativeHvmSolver::Settings settings = solver.getSettings();
+                settings.maxWakeIterations = 4;
+                settings.wakeTolerance = 0.0;
+                solver.setSettings(settings);
+                NativeHvmSolver::Statistics tree;
+                double cp = solver.evaluate(7.0, 0.0, &tree).CP;
+                swprintf(line, 200, L"JX %3d NSEC %3d %7zu segments  tree %9.1f ms (matrix %7.1f ms) %6u it %12zu interactions", elements,
+                    sectors, tree.segments, tree.seconds * 1e3, tree.assemblySeconds * 1e3, tree.iterations, tree.interactions);
+                std::wstring text = line;
+                if (tree.segments <= 16000) {
+                    settings.accuracy = 0.0;
+                    solver.setSettings(settings);
+                    NativeHvmSolver::Statistics direct;
+                    double reference = solver.evaluate(7.0, 0.0, &direct).CP;
+                    swprintf(line, 200, L"  direct %9.1f ms  dCP %.2g", direct.seconds * 1e3, std::abs(cp - reference));
+                    text += line;
+                }
+                Logger::logError(text);
+            }
+        }
+    }
+
+    // An HVM TSR sweep of the default blade (JX 20, NSEC 12, XTREFFTZ 4), every point started from BEMT and then each from the
+    // solution of the one before; dCP is the largest difference between the two
+    void benchmarkHvmContinuation() {
+        InputData input;
+        input.METHOD = InputData::METHOD_HVM;
+        input.JX = 20;
+        input.NSEC = 12;
+        input.XTREFFTZ = 4.0;
+        NativeHvmSolver solver(input, std::vector<AirfoilPolar>{ syntheticPolar() });
+        std::vector<std::pair<double, double>> sweep;
+        for (int t = 0; t <= 12; ++t) sweep.emplace_back(3.0 + 0.5 * t, 0.0);
+        wchar_t line[160];
+        std::vector<NativeBemtSolver::OperatingPoint> cold;
+        for (bool continuation : { false, true }) {
+            NativeHvmSolver::Settings settings = solver.getSettings();
+            settings.continuation = continuation;
+            solver.setSettings(settings);
+            std::vector<NativeBemtSolver::OperatingPoint> points;
+            double ms = timeMs([&]() {
+                points = solver.evaluateGrid(sweep);
+            });
+            size_t iterations = 0;
+            double deviation = 0.0;
+            for (size_t i = 0; i < points.size(); ++i) {
+                iterations += points[i].iterations / input.JX;
+                if (continuation) deviation = std::max(deviation, std::abs(points[i].CP - cold[i].CP));
+            }
+            swprintf(line, 160, L"%-28ls %9.1f ms  %6zu circulation iterations  max |dCP| %.2g", continuation ? L"warm starts" : L"cold starts",
+                ms, iterations, deviation);
+            Logger::logError(line);
+            cold = points;
+        }
+    }
+}
+
+int main() {
+    Logger::logError(L"Row tokenizer (200000 rows x 12 columns):");
+    benchmarkRowTokenizer();
+    Logger::logError(L"Output hand-off to 8 windows (200 tables x 1000 rows x 12 columns):");
+    benchmarkSnapshotHandOff();
+    Logger::logError(L"Airfoil polars:");
+    benchmarkPolars();
+    Logger::logError(L"BEMT Cp grid (400 operating points x 41 stations):");
+    benchmarkBemtGrid();
+    Logger::logError(L"HVM wake scaling (TSR 7, 4 wakes, XTREFFTZ 4):");
+    benchmarkHvmScaling();
+    Logger::logError(L"HVM continuation (13 points, TSR 3 to 9):");
+    benchmarkHvmContinuation();
+    return 0; // No pause needed; check Output window in VS
+}
\ No newline at end of file
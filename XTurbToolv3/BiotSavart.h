@@ -0,0 +1,40 @@
+#pragma once
+#include <cmath>
+
+#ifndef XTURB_FORCE_INLINE
+#ifdef _MSC_VER
+#define XTURB_FORCE_INLINE __forceinline
+#else
+#define XTURB_FORCE_INLINE inline __attribute__((always_inline))
+#endif
+#endif
+
+// GCC at -O2 does not inline a lambda called from two places, which leaves a lane loop scalar
+#ifdef _MSC_VER
+#define XTURB_LAMBDA_INLINE
+#else
+#define XTURB_LAMBDA_INLINE __attribute__((always_inline))
+#endif
+
+// The straight vortex segment kernel shared by VortexTree and InfluenceMatrix, inlined into their (vectorized) loops. Static, as
+// those loops are also built for AVX2 (see CpuFeatures.h).
+namespace BiotSavart {
+    constexpr double fourPi = 4.0 * 3.14159265358979323846;
+
+    // Velocity of a unit segment from p1 to p2 at t is factor * (r1 x r2), with r1 = t - p1 (a) and r2 = t - p2 (b) and the cross
+    // product returned in c. |r1 x r2|^2 = h^2 L^2 for distance h from the line, so the singular 1 / (h^2 L^2) becomes
+    // 1 / sqrt(h^4 + core^4) L^2: a Vatistas (n = 2) core, finite on the filament.
+    static XTURB_FORCE_INLINE double segmentFactor(double ax, double ay, double az, double bx, double by, double bz, double core4,
+        double& cx, double& cy, double& cz) {
+        double lx = ax - bx, ly = ay - by, lz = az - bz;
+        cx = ay * bz - az * by;
+        cy = az * bx - ax * bz;
+        cz = ax * by - ay * bx;
+        double cross2 = cx * cx + cy * cy + cz * cz;
+        double length2 = lx * lx + ly * ly + lz * lz;
+        double na = std::sqrt(ax * ax + ay * ay + az * az) + 1e-300;
+        double nb = std::sqrt(bx * bx + by * by + bz * bz) + 1e-300;
+        double along = (lx * ax + ly * ay + lz * az) / na - (lx * bx + ly * by + lz * bz) / nb;
+        return along / (fourPi * (std::sqrt(cross2 * cross2 + core4 * length2 * length2) + 1e-300));
+    }
+}
\ No newline at end of file
@@ -6,8 +6,15 @@
 #include "HelperFunctions.h"
 #include "BEMTOutputParser.h"
 #include <algorithm>
-#include <thread>
+#include <chrono>
+#include <cwchar>
 #include <fstream>
+#include <memory>
+
+namespace {
+    // Iteration rows can arrive thousands of times per second; the window title only needs a few updates per second
+    constexpr auto progressInterval = std::chrono::milliseconds(200);
+}
 
 // Constructor: Initialize with parent window and position/size
 Container::Container(HWND parent, HINSTANCE hInstance, int x, int y, int width, int height, const std::wstring& xturbExeName)
@@ -26,8 +33,8 @@ Container::Container(HWND parent, HINSTANCE hInstance, int x, int y, int width,
     rhoairInput(nullptr), muairInput(nullptr), npreInput(nullptr), vwindInput(nullptr),
     rpmpresInput(nullptr), pitchpreInput(nullptr), methodInput(nullptr), jxInput(nullptr),
     cosdistrInput(nullptr), gnuplotInput(nullptr), aviscInput(nullptr), rlossInput(nullptr),
-    tiplossInput(nullptr), axrelaxInput(nullptr), atrelaxInput(nullptr), optimInput(nullptr),
-    twistGraph(nullptr), chordGraph(nullptr), xturbRunner(nullptr), exeDir(L"")
+    tiplossInput(nullptr), axrelaxInput(nullptr), atrelaxInput(nullptr), optimInput(nullptr), abortDivergenceInput(nullptr),
+    twistGraph(nullptr), chordGraph(nullptr), runScheduler(nullptr), resultCache(nullptr), batchParser(nullptr), exeDir(L"")
 {
     this->hInstance = hInstance;
     this->hwnd = parent;
@@ -47,8 +54,13 @@ Container::Container(HWND parent, HINSTANCE hInstance, int x, int y, int width,
         exeDir = L".";
     }
 
-    // Initialize XTurbRunner with the provided executable name
-    xturbRunner = new XTurbRunner(exeDir + xturbExeName);
+    // Runs are scheduled into exeDir\runs\run_NNNN, the solver and its polars are linked in from exeDir
+    runScheduler = new RunScheduler(exeDir + xturbExeName, exeDir + L"runs");
+    // Repeated runs of an unchanged input are answered from exeDir\cache, which is kept below 2 GB
+    resultCache = new ResultCache(exeDir + L"cache", 2ull << 30);
+    runScheduler->setResultCache(resultCache);
+    runScheduler->enableWarmStart(); // Short BEMT runs are dominated by process start-up otherwise
+    batchParser = new OutputBatchParser();
 }
 
 // Destructor: Clean up resources
@@ -68,10 +80,30 @@ Container::~Container() {
     controls.clear();
     delete twistGraph;
     delete chordGraph;
-    delete xturbRunner;
+    if (runScheduler) {
+        Logger::logError(runScheduler->launchLatency().summary());
+        runScheduler->cancelPending(); // Kills the solvers still running, so only runs solved in-process are waited for
+    }
+    delete runScheduler;
+    runScheduler = nullptr;
+    delete resultCache; // After the scheduler, whose runs may still be storing results
+    resultCache = nullptr;
+    {
+        // Messages from here on are dropped; the ones posted but never handled are freed
+        std::lock_guard<std::mutex> lock(posted->mutex);
+        posted->closing = true;
+        for (RunRecord* record : posted->records) delete record;
+        for (BatchParseResult* result : posted->results) delete result;
+        for (RunProgress* update : posted->progress) delete update;
+        posted->records.clear();
+        posted->results.clear();
+        posted->progress.clear();
+    }
+    if (batchParser) batchParser->cancelPending();
+    delete batchParser; // Only waits for the files being parsed right now
+    batchParser = nullptr;
     for (auto window : displayWindows) delete window; // Clean up all display windows
     for (auto* selector : fileSelectors) delete selector;
-    xturbRunner = nullptr;
     displayWindows.clear();
     fileSelectors.clear();
 }
@@ -796,6 +828,13 @@ bool Container::validateInputs(std::wstring& errorMessage) {
         }
     }
 
+    if (abortDivergenceInput) {
+        std::wstring abortText = abortDivergenceInput->getText();
+        if (!isValidInteger(abortText) || (_wtoi(abortText.c_str()) != 0 && _wtoi(abortText.c_str()) != 1)) {
+            errorMessage += L"Abort Diverging Runs must be 0 (No) or 1 (Yes).\n";
+        }
+    }
+
     // &HVM section validation
     if (aviscInput) {
         std::wstring aviscText = aviscInput->getText();
@@ -1099,6 +1138,9 @@ void Container::create(HINSTANCE hInstance, int nCmdShow) {
     cosdistrInput->setDefaultText(L"1");
     addLabeledInput(L"Gnuplot Output (0-2):", gnuplotInput, standardLabelWidth, standardInputWidth, standardInputHeight);
     gnuplotInput->setDefaultText(L"2");
+    // A diverged run otherwise only wastes the rest of its timeout; off by default, as the solver sometimes recovers
+    addLabeledInput(L"Abort Diverging Runs (0/1):", abortDivergenceInput, standardLabelWidth, standardInputWidth, standardInputHeight);
+    abortDivergenceInput->setDefaultText(L"0");
 
     // &HVM section header
     Label* hvmHeader = new Label(hwnd, hInstance, 0, currentY - scrollPos, 150, 20, L"HVM Parameters");
@@ -1159,6 +1201,25 @@ void Container::create(HINSTANCE hInstance, int nCmdShow) {
     ShowWindow(hwnd, SW_SHOW);
     UpdateWindow(hwnd);
 }
+// Hands the files to the batch parser. The result is posted back as WM_USER + 103, so the UI thread never waits for parsing.
+void Container::parseOutputFiles(const std::vector<std::wstring>& files) {
+    HWND target = hwnd;
+    std::shared_ptr<PostedMessages> pending = posted;
+    batchParser->parseFiles(files, [target, pending](BatchParseResult&& result) {
+        std::lock_guard<std::mutex> lock(pending->mutex);
+        if (pending->closing) {
+            return;
+        }
+        BatchParseResult* message = new BatchParseResult(std::move(result));
+        if (PostMessage(target, WM_USER + 103, 0, (LPARAM)message)) {
+            pending->results.insert(message);
+        }
+        else {
+            delete message; // Container window is already gone
+        }
+    });
+}
+
 // Handle messages specific to the container
 LRESULT Container::handleMessage(UINT msg, WPARAM wParam, LPARAM lParam) {
     if (!isValid) {
@@ -1244,14 +1305,16 @@ LRESULT Container::handleMessage(UINT msg, WPARAM wParam, LPARAM lParam) {
                 //Handle custom message: re-enable Run button and show result of XTurb execution, launching new FileSelectorWindow if successful
     case WM_USER + 101: {
         Logger::logError(L"WM_USER + 101 received with wParam=" + std::to_wstring(wParam));
-        HWND runButton = (HWND)lParam;
-        EnableWindow(runButton, TRUE);
+        RunRecord* record = reinterpret_cast<RunRecord*>(lParam);
+        {
+            std::lock_guard<std::mutex> lock(posted->mutex);
+            posted->records.erase(record);
+        }
         if (wParam == 1) {
-            MessageBoxW(hwnd, L"XTurb executed successfully.", L"Success", MB_OK | MB_ICONINFORMATION);
+            MessageBoxW(hwnd, (record->label + L" executed successfully.").c_str(), L"Success", MB_OK | MB_ICONINFORMATION);
             Logger::logError(L"Showing FileSelectorWindow");
-            runNumber++;
-            std::wstring title = L"File Selector XTurb Run " + std::to_wstring(runNumber);
-            FileSelectorWindow* newSelector = new FileSelectorWindow(hInstance, hwnd, exeDir);
+            std::wstring title = L"File Selector XTurb " + record->label;
+            FileSelectorWindow* newSelector = new FileSelectorWindow(hInstance, hwnd, record->directory);
             newSelector->create(hInstance, SW_SHOW);
             if (!newSelector->getHwnd()) {
                 Logger::logError(L"FileSelectorWindow creation failed");
@@ -1263,26 +1326,93 @@ LRESULT Container::handleMessage(UINT msg, WPARAM wParam, LPARAM lParam) {
                 fileSelectors.push_back(newSelector);
             }
         }
+        else if (record->timedOut) {
+            const wchar_t* reason = record->limitHit == RunLimit::Inactivity ? L"produced no output for too long"
+                : record->limitHit == RunLimit::CpuTime ? L"exceeded its CPU time limit" : L"exceeded its time limit";
+            MessageBoxW(hwnd, (record->label + L" " + reason + L" after " + std::to_wstring(record->attempts) + L" attempt(s). See " + record->directory).c_str(),
+                L"Error", MB_OK | MB_ICONERROR);
+        }
+        else if (record->aborted) {
+            MessageBoxW(hwnd, (record->label + L" diverged and was stopped. See " + record->directory).c_str(), L"Error", MB_OK | MB_ICONERROR);
+        }
         else {
-            MessageBoxW(hwnd, L"XTurb execution failed.", L"Error", MB_OK | MB_ICONERROR);
+            MessageBoxW(hwnd, (record->label + L" failed. See " + record->directory).c_str(), L"Error", MB_OK | MB_ICONERROR);
         }
+        SetWindowTextW(GetAncestor(hwnd, GA_ROOT), L"XTurb Tool");
+        delete record;
         return 0;
     }
 
-                      // Handle file selection: parse selected file and open a new DataDisplayWindow to display its contents
+                      // Handle solver progress: shown in the title of the main window while the run is going
+    case WM_USER + 105: {
+        RunProgress* update = reinterpret_cast<RunProgress*>(lParam);
+        {
+            std::lock_guard<std::mutex> lock(posted->mutex);
+            posted->progress.erase(update);
+        }
+        const SolverProgress& progress = update->progress;
+        wchar_t status[160];
+        switch (progress.kind) {
+        case SolverProgress::Kind::Iteration:
+            if (progress.quantity.empty()) {
+                swprintf(status, 160, L"iteration %d", progress.iteration);
+            }
+            else {
+                swprintf(status, 160, L"iteration %d, %ls = %.3e", progress.iteration, progress.quantity.c_str(), progress.change);
+            }
+            break;
+        case SolverProgress::Kind::Converged:
+            swprintf(status, 160, L"converged in %d iterations", progress.iteration);
+            break;
+        case SolverProgress::Kind::NotConverged:
+            swprintf(status, 160, L"case did not converge");
+            break;
+        case SolverProgress::Kind::Diverged:
+            swprintf(status, 160, L"diverged");
+            Logger::logError(update->label + L" diverged: " + progress.line);
+            break;
+        }
+        SetWindowTextW(GetAncestor(hwnd, GA_ROOT), (L"XTurb Tool - " + update->label + L": " + status).c_str());
+        delete update;
+        return 0;
+    }
+
+                      // Handle file selection: parse selected file in the background, the DataDisplayWindow is opened on WM_USER + 103
     case WM_USER + 102: { // File selected
         FileSelectorWindow* selector = reinterpret_cast<FileSelectorWindow*>(lParam);
         std::wstring filePath = selector->getSelectedFile();
         Logger::logError(L"Opening file: " + filePath);
-        OutputData outputData;
-        BEMTOutputParser parser(filePath);
-        if (parser.parse(outputData)) {
-            std::wstring fileName = filePath.substr(filePath.find_last_of(L"\\") + 1);
+        parseOutputFiles({ filePath });
+        return 0;
+    }
+
+                      // Handle "Open All": parse every output file of the run in parallel
+    case WM_USER + 104: {
+        FileSelectorWindow* selector = reinterpret_cast<FileSelectorWindow*>(lParam);
+        std::vector<std::wstring> files = selector->getFilePaths();
+        Logger::logError(L"Opening " + std::to_wstring(files.size()) + L" output files");
+        parseOutputFiles(files);
+        return 0;
+    }
+
+                      // Background parse finished: open a DataDisplayWindow per parsed file
+    case WM_USER + 103: {
+        BatchParseResult* result = reinterpret_cast<BatchParseResult*>(lParam);
+        {
+            std::lock_guard<std::mutex> lock(posted->mutex);
+            posted->results.erase(result);
+        }
+        for (auto& [filePath, outputData] : result->outputs) {
+            std::wstring fileName = filePath.substr(filePath.find_last_of(L"\\/") + 1);
             DataDisplayWindow* displayWindow = new DataDisplayWindow(hInstance, hwnd, outputData, fileName);
             displayWindow->create(hInstance, SW_SHOW);
             displayWindows.push_back(displayWindow);
             ShowWindow(displayWindow->getHwnd(), SW_SHOW);
         }
+        for (const auto& filePath : result->failedFiles) {
+            Logger::logError(L"Failed to parse output file: " + filePath);
+        }
+        delete result;
         return 0;
     }
     case WM_COMMAND: {
@@ -1398,14 +1528,46 @@ LRESULT Container::handleMessage(UINT msg, WPARAM wParam, LPARAM lParam) {
             }
             checkFile.close();
 
-            HWND runButtonHandle = sourceControl->getHandle();
-            EnableWindow(runButtonHandle, FALSE);
-            Logger::logError(L"Starting XTurbRunner with exe: " + xturbRunner->getExePath());
-            std::thread([this, inputFilePath, runButtonHandle]() {
-                bool success = xturbRunner->run(inputFilePath);
-                Logger::logError(L"XTurbRunner finished with success: " + std::to_wstring(success));
-                PostMessage(hwnd, WM_USER + 101, success ? 1 : 0, (LPARAM)runButtonHandle);
-                }).detach();
+            // Runs no longer share any files, so the button stays enabled and further runs simply queue up
+            runScheduler->setAbortOnDivergence(abortDivergenceInput && _wtoi(abortDivergenceInput->getText().c_str()) == 1);
+            runNumber++;
+            HWND target = hwnd;
+            Logger::logError(L"Scheduling XTurb run " + std::to_wstring(runNumber) + L" with exe: " + runScheduler->getSolverPath());
+            std::wstring label = L"Run " + std::to_wstring(runNumber);
+            std::shared_ptr<PostedMessages> pending = posted;
+            auto lastPosted = std::make_shared<std::chrono::steady_clock::time_point>();
+            runScheduler->submit(inputData, label, [target, pending](const RunRecord& record) {
+                Logger::logError(L"XTurb " + record.label + L" finished in " + record.directory);
+                std::lock_guard<std::mutex> lock(pending->mutex);
+                if (pending->closing) {
+                    return;
+                }
+                RunRecord* message = new RunRecord(record);
+                if (PostMessage(target, WM_USER + 101, record.state == RunRecord::State::Succeeded ? 1 : 0, (LPARAM)message)) {
+                    pending->records.insert(message);
+                }
+                else {
+                    delete message; // Container window is already gone
+                }
+            }, [target, pending, label, lastPosted](size_t, const SolverProgress& progress) {
+                // Called from the run's worker thread only, so the throttle state needs no lock
+                auto now = std::chrono::steady_clock::now();
+                if (progress.kind == SolverProgress::Kind::Iteration && now - *lastPosted < progressInterval) {
+                    return;
+                }
+                *lastPosted = now;
+                std::lock_guard<std::mutex> lock(pending->mutex);
+                if (pending->closing) {
+                    return;
+                }
+                RunProgress* message = new RunProgress{ label, progress };
+                if (PostMessage(target, WM_USER + 105, 0, (LPARAM)message)) {
+                    pending->progress.insert(message);
+                }
+                else {
+                    delete message;
+                }
+            });
         }
 
         // Handle input field changes
@@ -4,9 +4,13 @@
 #include "Logger.h"
 #include "InputData.h"
 #include "Graph.h"
-#include "XTurbRunner.h"
+#include "RunScheduler.h"
 #include "FileSelectorWindow.h"
 #include "DataDisplayWindow.h"
+#include "OutputBatchParser.h"
+#include <memory>
+#include <mutex>
+#include <set>
 #include <vector>
 
 // This manages the main container window and its controls (Graph, Input fields, etc.)
@@ -40,7 +44,24 @@ private:
     int scrollPos;
 
     // Input fields for data collection
-	XTurbRunner* xturbRunner;
+    RunScheduler* runScheduler; // Runs the solver in isolated scratch directories, finished runs arrive as WM_USER + 101, progress as WM_USER + 105
+    ResultCache* resultCache; // Results of earlier runs, keyed by input, solver and polar contents
+    OutputBatchParser* batchParser; // Parses output files off the UI thread, results arrive as WM_USER + 103
+    // Posted with WM_USER + 105 while a run is in progress
+    struct RunProgress {
+        std::wstring label;
+        SolverProgress progress;
+    };
+    // Objects posted as WM_USER + 101, 103 and 105 and not handled yet. Shared with the run and parse handlers, which post nothing
+    // once the window is closing; objects still in the message queue then are freed by the destructor.
+    struct PostedMessages {
+        std::mutex mutex;
+        bool closing = false;
+        std::set<RunRecord*> records;
+        std::set<BatchParseResult*> results;
+        std::set<RunProgress*> progress;
+    };
+    std::shared_ptr<PostedMessages> posted = std::make_shared<PostedMessages>();
     InputField* nameInput;
     InputField* bnInput;
     InputField* rootInput;
@@ -111,6 +132,7 @@ private:
     InputField* axrelaxInput;
     InputField* atrelaxInput;
     InputField* optimInput;
+    InputField* abortDivergenceInput; // Tool setting, not part of the input file: kill runs whose iterations diverge
 
     // Graph objects for Twist and Chord distributions
     TwistGraph* twistGraph;
@@ -123,4 +145,5 @@ private:
     void updateScrollRange();
     bool validateInputs(std::wstring& errorMessage);
     void updateGraphs();
+    void parseOutputFiles(const std::vector<std::wstring>& files);
 };
\ No newline at end of file
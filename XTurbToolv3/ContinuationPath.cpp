@@ -0,0 +1,68 @@
+#include "ContinuationPath.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+ContinuationPath::ContinuationPath(const std::vector<std::pair<double, double>>& points) {
+    const size_t count = points.size();
+    if (count == 0) return;
+    double tsrMin = points[0].first, tsrMax = tsrMin, pitchMin = points[0].second, pitchMax = pitchMin;
+    for (const auto& point : points) {
+        tsrMin = std::min(tsrMin, point.first);
+        tsrMax = std::max(tsrMax, point.first);
+        pitchMin = std::min(pitchMin, point.second);
+        pitchMax = std::max(pitchMax, point.second);
+    }
+    const double tsrScale = tsrMax > tsrMin ? 1.0 / (tsrMax - tsrMin) : 0.0;
+    const double pitchScale = pitchMax > pitchMin ? 1.0 / (pitchMax - pitchMin) : 0.0;
+    for (const auto& point : points) scaled.emplace_back((point.first - tsrMin) * tsrScale, (point.second - pitchMin) * pitchScale);
+
+    // Greedy nearest neighbour tour from the lowest tip speed ratio (lowest pitch among equals)
+    std::vector<bool> visited(count, false);
+    size_t current = std::min_element(points.begin(), points.end()) - points.begin();
+    order.reserve(count);
+    for (;;) {
+        visited[current] = true;
+        order.push_back(current);
+        if (order.size() == count) break;
+        size_t nearest = current;
+        double best = std::numeric_limits<double>::max();
+        for (size_t i = 0; i < count; ++i) {
+            if (visited[i]) continue;
+            double d = distance(current, i);
+            if (d < best) {
+                best = d;
+                nearest = i;
+            }
+        }
+        current = nearest;
+    }
+}
+
+double ContinuationPath::distance(size_t first, size_t second) const {
+    return std::hypot(scaled[first].first - scaled[second].first, scaled[first].second - scaled[second].second);
+}
+
+std::vector<ContinuationPath::Step> ContinuationPath::chain() const {
+    std::vector<Step> steps;
+    for (size_t p = 0; p < order.size(); ++p) steps.push_back({ order[p], p > 0 ? order[p - 1] : none });
+    return steps;
+}
+
+std::vector<std::vector<ContinuationPath::Step>> ContinuationPath::refinement(size_t coldSpacing) const {
+    size_t spacing = 1;
+    while (spacing < coldSpacing) spacing *= 2;
+    std::vector<std::vector<Step>> stages(1);
+    for (size_t p = 0; p < order.size(); p += spacing) stages[0].push_back({ order[p], none });
+    // Positions that are odd multiples of half: both neighbours at +-half are even multiples, solved in an earlier stage (if they exist)
+    for (size_t half = spacing / 2; half > 0; half /= 2) {
+        std::vector<Step> stage;
+        for (size_t p = half; p < order.size(); p += 2 * half) {
+            size_t seed = order[p - half];
+            if (p + half < order.size() && distance(order[p], order[p + half]) < distance(order[p], seed)) seed = order[p + half];
+            stage.push_back({ order[p], seed });
+        }
+        if (!stage.empty()) stages.push_back(std::move(stage));
+    }
+    return stages;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Order in which the operating points of a sweep (TSRANA / PITCHANA, the DESIGN grid, the PREDICTION points) are solved when every
+// solve starts from the converged solution of a neighbour instead of from scratch. The points are chained into a path, nearest
+// neighbour first, with tip speed ratio and pitch each measured relative to their range in the sweep.
+class ContinuationPath {
+public:
+    static constexpr size_t none = static_cast<size_t>(-1);
+
+    // point is an index into the points given to the constructor; seed is the point whose solution it starts from, none for a cold start
+    struct Step {
+        size_t point = 0;
+        size_t seed = none;
+    };
+
+    explicit ContinuationPath(const std::vector<std::pair<double, double>>& points);
+
+    const std::vector<size_t>& getOrder() const { return order; }
+
+    // One point at a time along the path, each seeded by its predecessor; only the first starts cold
+    std::vector<Step> chain() const;
+
+    // Stages for a solver that does many points at once: every coldSpacing-th point of the path (a power of two) starts cold in the
+    // first stage, then each stage halves the spacing, seeding the points in between from the nearer of the two solved either side
+    std::vector<std::vector<Step>> refinement(size_t coldSpacing) const;
+
+private:
+    double distance(size_t first, size_t second) const;
+
+    std::vector<std::pair<double, double>> scaled;
+    std::vector<size_t> order;
+};
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "CpuFeatures.h"
+
+#ifdef XTURB_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+    struct Features {
+        bool avx2 = false;
+        bool fma = false;
+    };
+
+    Features detect() {
+        Features features;
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return features;
+        __cpuid(info, 1);
+        bool fma = (info[2] & (1 << 12)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        if (!osxsave || (_xgetbv(0) & 6) != 6) return features;
+        __cpuidex(info, 7, 0);
+        features.avx2 = (info[1] & (1 << 5)) != 0;
+        features.fma = fma;
+#else
+        features.avx2 = __builtin_cpu_supports("avx2");
+        features.fma = __builtin_cpu_supports("fma");
+#endif
+        return features;
+    }
+
+    const Features& features() {
+        static const Features detected = detect();
+        return detected;
+    }
+}
+
+bool CpuFeatures::hasAVX2() {
+    return features().avx2;
+}
+
+bool CpuFeatures::hasAVX2FMA() {
+    return features().avx2 && features().fma;
+}
+#else
+bool CpuFeatures::hasAVX2() {
+    return false;
+}
+
+bool CpuFeatures::hasAVX2FMA() {
+    return false;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+// Instruction set detection for the kernels with an AVX2 variant. The compiler-vectorized variants live in files of their own
+// (BemtBatchKernelAVX2.cpp, InfluenceMatrixAVX2.cpp, VortexTreeAVX2.cpp), built with -mavx2 -mfma or /arch:AVX2, and are only called
+// when hasAVX2FMA() is true. The loops those files share with the baseline build must have internal linkage (or be templates
+// instantiated per variant): an inline function with external linkage compiled into both could be linked as the AVX2 copy for
+// every caller. Hand-written intrinsics, as in RowTokenizer, can stay in a baseline file behind XTURB_TARGET_AVX2.
+// GCC and Clang also build the kernel files with -fno-math-errno -fno-trapping-math. MSVC has no such switch short of /fp:fast,
+// which would also reorder the lane sums, so its builds stay at /fp:precise.
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define XTURB_X86 1
+#ifdef _MSC_VER
+#define XTURB_TARGET_AVX2
+#else
+#define XTURB_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace CpuFeatures {
+    // Supported by the CPU and the YMM registers saved by the operating system; false off x86
+    bool hasAVX2();
+    // AVX2 and FMA, everything the AVX2 files may use
+    bool hasAVX2FMA();
+}
\ No newline at end of file
@@ -29,10 +29,10 @@ void DataDisplayWindow::RegisterClass(HINSTANCE hInstance) {
 }
 
 // Constructor: initialize DataDisplayWindow with parsed data, parent window, and file info, then log table count
-DataDisplayWindow::DataDisplayWindow(HINSTANCE hInstance, HWND parent, const OutputData& data, const std::wstring& filePath)
-    : Window(), parent(parent), data(data), fileName(filePath) {
+DataDisplayWindow::DataDisplayWindow(HINSTANCE hInstance, HWND parent, OutputSnapshot data, const std::wstring& filePath)
+    : Window(), parent(parent), data(std::move(data)), fileName(filePath) {
     this->hInstance = hInstance;
-    Logger::logError(L"DataDisplayWindow constructed with " + std::to_wstring(data.tables.size()) + L" tables");
+    Logger::logError(L"DataDisplayWindow constructed with " + std::to_wstring(this->data->tables.size()) + L" tables");
 }
 
 // Destructor: delete all dynamically allocated graphs and controls, then clear the containers
@@ -60,7 +60,7 @@ void DataDisplayWindow::create(HINSTANCE hInstance, int nCmdShow) {
     const int spacing = 10;
 
     // Use the headerText from OutputData
-    std::wstring headerText = data.headerText;
+    std::wstring headerText = data->headerText;
 
     // Remove trailing newline
     if (!headerText.empty() && headerText.back() == L'\n') {
@@ -97,27 +97,18 @@ void DataDisplayWindow::create(HINSTANCE hInstance, int nCmdShow) {
     }
 
     // Log how many tables will be used to create graphs
-    Logger::logError(L"Creating graphs for " + std::to_wstring(data.tables.size()) + L" tables");
-    for (const auto& table : data.tables) {
+    Logger::logError(L"Creating graphs for " + std::to_wstring(data->tables.size()) + L" tables");
+    for (size_t t = 0; t < data->tables.size(); ++t) {
+        const auto& table = data->tables[t];
         // Skip tables that don't have at least 2 columns (X and Y axes)
         if (table.headers.size() < 2) {
             Logger::logError(L"Table has fewer than 2 columns, skipping graphs");
             continue;
         }
         // For each column beyond the first, create a graph of column[0] vs column[n]
-        for (size_t col = 1; col < table.headers.size(); ++col) {
-            // Build a new table containing only the two relevant columns
-            OutputData::Table graphTable;
-            graphTable.headers = { table.headers[0], table.headers[col] };
-            // Populate rows for the graph with corresponding column data
-            for (const auto& row : table.rows) {
-                if (row.size() > col) {
-                    graphTable.rows.push_back({ row[0], row[col] });
-                }
-            }
-
-            // Create a GraphControl using the two-column table
-            GraphControl* graph = new GraphControl(hwnd, hInstance, 10, y, 700, 400, graphTable);
+        for (size_t col = 1; col < table.headers.size() && col < table.columnCount(); ++col) {
+            // The graph plots straight from the snapshot's column buffers, no per-graph copy is made
+            GraphControl* graph = new GraphControl(hwnd, hInstance, 10, y, 700, 400, data, t, col);
             graphs.push_back(graph);
             // Retrieve the handle to the graph window
             HWND graphHwnd = graph->getHandle();
@@ -7,7 +7,8 @@
 // This class displays the output data from XTurb in a new window (so it naturally derives from Window)
 class DataDisplayWindow : public Window {
 public:
-    DataDisplayWindow(HINSTANCE hInstance, HWND parent, const OutputData& data, const std::wstring& fileName);
+    // The window and its graphs share the snapshot; nothing from the parse result is copied
+    DataDisplayWindow(HINSTANCE hInstance, HWND parent, OutputSnapshot data, const std::wstring& fileName);
     ~DataDisplayWindow() override;
     void create(HINSTANCE hInstance, int nCmdShow) override;
     LRESULT handleMessage(UINT msg, WPARAM wParam, LPARAM lParam) override;
@@ -15,7 +16,7 @@ public:
 
 private:
     HWND parent;
-    OutputData data;
+    OutputSnapshot data;
     std::wstring fileName;
     std::vector<GraphControl*> graphs;
     std::vector<Control*> controls;
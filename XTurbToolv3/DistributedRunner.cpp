@@ -0,0 +1,291 @@
+#include "DistributedRunner.h"
+#include "BEMTOutputParser.h"
+#include "HelperFunctions.h"
+#include "Logger.h"
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <sstream>
+#include <vector>
+#ifdef _WIN32
+#include "header.h"
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    std::wstring jobName(const std::wstring& session, size_t id) {
+        std::wstring number = std::to_wstring(id);
+        return session + L"_" + std::wstring(number.size() < 6 ? 6 - number.size() : 0, L'0') + number;
+    }
+}
+
+DistributedCoordinator::DistributedCoordinator(const std::wstring& queueRoot, const DistributedOptions& options)
+    : queue(queueRoot), options(options), nextId(1), stopping(false) {
+    std::random_device random;
+    session = to_hex((static_cast<uint64_t>(random()) << 32) | random()).substr(0, 8);
+    queue.clear();
+    queue.setStop(false);
+    monitor = std::thread(&DistributedCoordinator::monitorLoop, this);
+    LOG_INFO(L"Coordinating session " + session + L" in " + queueRoot);
+}
+
+// Jobs that are still open are taken off the queue; workers finish what they already started and the results are dropped
+DistributedCoordinator::~DistributedCoordinator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        for (const auto& entry : jobs) queue.cancel(entry.first);
+    }
+    wake.notify_all();
+    monitor.join();
+}
+
+size_t DistributedCoordinator::submit(const InputData& input, const std::wstring& label, CompletionHandler onComplete) {
+    Job job;
+    job.id = nextId++;
+    job.label = label;
+    job.onComplete = std::move(onComplete);
+    std::wstring name = jobName(session, job.id);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs[name] = job;
+    }
+    if (!queue.post(name, input.serialize())) {
+        complete(name, JobResult());
+    }
+    return job.id;
+}
+
+size_t DistributedCoordinator::workerCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return workers.size();
+}
+
+void DistributedCoordinator::stopWorkers() {
+    queue.setStop(true);
+}
+
+void DistributedCoordinator::monitorLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        lock.unlock();
+        collectResults();
+        checkWorkers();
+        lock.lock();
+        wake.wait_for(lock, std::chrono::milliseconds(options.pollMs), [this]() { return stopping; });
+    }
+}
+
+// Results of unknown jobs are duplicates (a job requeued from a worker that came back after all) or left from other sessions
+void DistributedCoordinator::collectResults() {
+    for (const auto& name : queue.finishedJobs()) {
+        JobResult result;
+        bool readable = queue.takeResult(name, result);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!jobs.count(name)) continue;
+        }
+        if (!readable) result = JobResult();
+        complete(name, std::move(result));
+    }
+}
+
+void DistributedCoordinator::checkWorkers() {
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<std::wstring> present = queue.workers();
+    std::vector<std::wstring> lost;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = workers.begin(); it != workers.end();) {
+            if (std::find(present.begin(), present.end(), it->first) == present.end()) {
+                LOG_INFO(L"Worker " + it->first + L" left");
+                it = workers.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        for (const auto& name : present) {
+            std::string beat;
+            queue.readHeartbeat(name, beat);
+            auto it = workers.find(name);
+            if (it == workers.end()) {
+                LOG_INFO(L"Worker " + name + L" joined");
+                workers[name] = WorkerState{ beat, now };
+            }
+            else if (it->second.beat != beat) {
+                it->second = WorkerState{ beat, now };
+            }
+            else if (now - it->second.changed > std::chrono::milliseconds(options.workerLossMs)) {
+                lost.push_back(name);
+                workers.erase(it);
+            }
+        }
+    }
+
+    for (const auto& worker : lost) {
+        std::vector<std::wstring> requeued = queue.requeueWorker(worker);
+        Logger::logError(L"Lost worker " + worker + L", requeued " + std::to_wstring(requeued.size()) + L" jobs");
+        for (const auto& name : requeued) {
+            bool failed = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                auto job = jobs.find(name);
+                if (job == jobs.end()) {
+                    queue.cancel(name);
+                    continue;
+                }
+                failed = ++job->second.requeues > options.maxRequeues;
+            }
+            if (failed) {
+                queue.cancel(name);
+                Logger::logError(L"Job " + name + L" was with " + std::to_wstring(options.maxRequeues + 1) + L" lost workers, giving up");
+                complete(name, JobResult());
+            }
+        }
+    }
+}
+
+void DistributedCoordinator::complete(const std::wstring& name, JobResult&& result) {
+    Job job;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = jobs.find(name);
+        if (it == jobs.end()) {
+            return;
+        }
+        job = std::move(it->second);
+        jobs.erase(it);
+    }
+    queue.cancel(name); // A copy requeued while the first worker was thought lost
+    LOG_INFO(L"Job " + name + L" (" + job.label + L") " + (result.succeeded ? L"succeeded" : L"failed") + (result.worker.empty() ? L"" : L" on " + result.worker));
+    if (job.onComplete) {
+        job.onComplete(job.id, std::move(result));
+    }
+}
+
+DistributedWorker::DistributedWorker(const std::wstring& queueRoot, RunScheduler& scheduler, const std::wstring& name, const DistributedOptions& options)
+    : queue(queueRoot), scheduler(scheduler), name(name), options(options), running(0), completed(0), beats(0), stopping(false) {}
+
+std::wstring DistributedWorker::defaultName() {
+#ifdef _WIN32
+    wchar_t host[MAX_COMPUTERNAME_LENGTH + 1];
+    DWORD length = MAX_COMPUTERNAME_LENGTH + 1;
+    std::wstring hostName = GetComputerNameW(host, &length) ? std::wstring(host, length) : L"host";
+    return hostName + L"-" + std::to_wstring(GetCurrentProcessId());
+#else
+    char host[256] = {};
+    if (gethostname(host, sizeof(host) - 1) != 0) host[0] = '\0';
+    return string_to_wstring(host[0] ? host : "host") + L"-" + std::to_wstring(getpid());
+#endif
+}
+
+void DistributedWorker::stop() {
+    stopping = true;
+    finished.notify_all();
+}
+
+void DistributedWorker::beat() {
+    auto now = std::chrono::steady_clock::now();
+    if (beats == 0 || now - lastBeat >= std::chrono::milliseconds(options.heartbeatMs)) {
+        queue.heartbeat(name, ++beats);
+        lastBeat = now;
+    }
+}
+
+size_t DistributedWorker::run() {
+    queue.requeueWorker(name, false); // Left by an earlier process of the same name
+    LOG_INFO(L"Worker " + name + L" serving " + queue.getRoot() + L" with " + std::to_wstring(scheduler.maxParallel()) + L" parallel runs");
+    const size_t capacity = scheduler.maxParallel();
+    while (!stopping) {
+        beat();
+        size_t active;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            active = running;
+        }
+        std::vector<std::wstring> backlog = queue.claimed(name);
+        if (active + backlog.size() < capacity + options.prefetch) {
+            std::vector<std::wstring> taken = queue.claim(name, capacity + options.prefetch - active - backlog.size());
+            if (taken.empty() && active + backlog.size() < capacity) {
+                taken = queue.steal(name, capacity - active - backlog.size());
+            }
+            if (!taken.empty()) {
+                backlog = queue.claimed(name);
+            }
+        }
+        for (const auto& job : backlog) {
+            if (active >= capacity) break;
+            std::string input;
+            if (!queue.start(name, job, input)) {
+                continue; // Stolen in the meantime
+            }
+            ++active;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++running;
+            }
+            startJob(job, input);
+        }
+        if (active == 0 && backlog.empty() && queue.stopRequested() && !queue.hasPending()) {
+            break;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait_for(lock, std::chrono::milliseconds(options.pollMs));
+    }
+
+    // Unstarted jobs go back to the others; the running ones are finished, with heartbeats so they are not requeued meanwhile
+    queue.requeueWorker(name, false);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running > 0) {
+        lock.unlock();
+        beat();
+        lock.lock();
+        finished.wait_for(lock, std::chrono::milliseconds(options.pollMs));
+    }
+    lock.unlock();
+    queue.requeueWorker(name, true);
+    LOG_INFO(L"Worker " + name + L" finished " + std::to_wstring(completed) + L" jobs");
+    return completed;
+}
+
+// Reads the job's input back into InputData, so the run gets the scheduler's limits, retries, result cache and warm slots
+void DistributedWorker::startJob(const std::wstring& job, const std::string& text) {
+    auto done = [this, job](JobResult&& result) {
+        result.worker = name;
+        queue.finish(name, job, result);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --running;
+            ++completed;
+        }
+        finished.notify_all();
+    };
+
+    InputData input;
+    std::istringstream stream(text);
+    if (!input.read(stream)) {
+        Logger::logError(L"Job " + job + L" has an unreadable input");
+        done(JobResult());
+        return;
+    }
+    scheduler.submit(input, job, [done](const RunRecord& record) {
+        JobResult result;
+        result.succeeded = record.state == RunRecord::State::Succeeded && (!record.outputFiles.empty() || !record.nativeOutputs.empty());
+        result.wallSeconds = record.wallSeconds;
+        result.cpuSeconds = record.cpuSeconds;
+        for (const auto& [file, data] : record.nativeOutputs) {
+            result.outputs.emplace_back(file, *data);
+        }
+        for (const auto& file : record.outputFiles) {
+            if (!result.succeeded) break;
+            OutputData data;
+            BEMTOutputParser parser(file);
+            parser.setCacheEnabled(false); // Sent back, not read again here
+            result.succeeded = parser.parse(data);
+            result.outputs.emplace_back(std::filesystem::path(file).filename().wstring(), std::move(data));
+        }
+        done(std::move(result));
+    });
+}
\ No newline at end of file
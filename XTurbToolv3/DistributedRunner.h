@@ -0,0 +1,98 @@
+#pragma once
+#include "InputData.h"
+#include "RunScheduler.h"
+#include "WorkQueue.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct DistributedOptions {
+    unsigned pollMs = 200;          // How often the queue directory is scanned
+    unsigned workerLossMs = 15000;  // A worker whose heartbeat did not change for this long is given up and its jobs are requeued
+    unsigned maxRequeues = 3;       // A job that was with this many lost workers fails instead of taking down more of them
+    unsigned heartbeatMs = 1000;    // Workers rewrite their heartbeat this often
+    size_t prefetch = 2;            // Jobs a worker claims beyond the ones it is running
+};
+
+// Serves jobs to DistributedWorker processes on any number of nodes through a WorkQueue directory and collects their results.
+// Workers are only judged by whether their heartbeat changes, on the coordinator's own clock, so the nodes' clocks do not matter.
+// When a worker is lost, its claimed and running jobs go back to the queue for the others. Only one coordinator per queue directory.
+class DistributedCoordinator {
+public:
+    using CompletionHandler = std::function<void(size_t id, JobResult&& result)>;
+
+    explicit DistributedCoordinator(const std::wstring& queueRoot, const DistributedOptions& options = DistributedOptions());
+    ~DistributedCoordinator();
+    DistributedCoordinator(const DistributedCoordinator&) = delete;
+    DistributedCoordinator& operator=(const DistributedCoordinator&) = delete;
+
+    // Queues the input and returns its id. onComplete is called from the coordinator's monitor thread.
+    size_t submit(const InputData& input, const std::wstring& label, CompletionHandler onComplete);
+    size_t workerCount() const;
+    // Workers exit once the queue is empty and their own jobs are done
+    void stopWorkers();
+
+private:
+    struct Job {
+        size_t id = 0;
+        std::wstring label;
+        unsigned requeues = 0;
+        CompletionHandler onComplete;
+    };
+    struct WorkerState {
+        std::string beat;
+        std::chrono::steady_clock::time_point changed;
+    };
+
+    void monitorLoop();
+    void collectResults();
+    void checkWorkers();
+    void complete(const std::wstring& name, JobResult&& result);
+
+    WorkQueue queue;
+    DistributedOptions options;
+    std::wstring session; // Prefix of this coordinator's job names; results of other sessions are dropped
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::map<std::wstring, Job> jobs; // Open jobs by queue name
+    std::map<std::wstring, WorkerState> workers;
+    std::atomic<size_t> nextId;
+    bool stopping;
+    std::thread monitor;
+};
+
+// Runs jobs from a WorkQueue on this node with a RunScheduler and sends the parsed outputs back. It keeps
+// scheduler.maxParallel() + options.prefetch jobs claimed, so the next job is at hand when one finishes, and steals unstarted jobs
+// from the busiest other worker when the queue runs dry.
+class DistributedWorker {
+public:
+    DistributedWorker(const std::wstring& queueRoot, RunScheduler& scheduler, const std::wstring& name, const DistributedOptions& options = DistributedOptions());
+
+    // Serves jobs until the coordinator stops the workers or stop() is called. Returns the number of jobs run.
+    size_t run();
+    void stop();
+
+    // <host>-<process id>, unique per worker process
+    static std::wstring defaultName();
+
+private:
+    void startJob(const std::wstring& job, const std::string& input);
+    void beat();
+
+    WorkQueue queue;
+    RunScheduler& scheduler;
+    std::wstring name;
+    DistributedOptions options;
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t running;
+    size_t completed;
+    uint64_t beats;
+    std::chrono::steady_clock::time_point lastBeat;
+    std::atomic<bool> stopping;
+};
\ No newline at end of file
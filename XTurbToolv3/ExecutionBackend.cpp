@@ -0,0 +1,675 @@
+#include "ExecutionBackend.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#ifdef _WIN32
+#include "header.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#if defined(__linux__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__) || defined(__DragonFly__)
+#define XTURB_HAVE_PIPE2 1
+#endif
+#endif
+
+namespace {
+    double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    const wchar_t* limitName(RunLimit limit) {
+        switch (limit) {
+        case RunLimit::WallTime: return L"wall-clock limit";
+        case RunLimit::Inactivity: return L"inactivity limit";
+        case RunLimit::CpuTime: return L"CPU time limit";
+        default: return L"no limit";
+        }
+    }
+
+    // The execution log, written unbuffered so it can be followed while the solver runs. Opened close-on-exec (not inheritable on
+    // Windows), so solvers that other threads start in the meantime do not inherit it.
+    class LogFile {
+    public:
+        explicit LogFile(const std::wstring& path) {
+#ifdef _WIN32
+            handle = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+#else
+            fd = open(std::filesystem::path(path).string().c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+        }
+        LogFile(const LogFile&) = delete;
+        LogFile& operator=(const LogFile&) = delete;
+
+        ~LogFile() {
+#ifdef _WIN32
+            if (isOpen()) CloseHandle(handle);
+#else
+            if (isOpen()) close(fd);
+#endif
+        }
+
+#ifdef _WIN32
+        bool isOpen() const { return handle != INVALID_HANDLE_VALUE; }
+#else
+        bool isOpen() const { return fd >= 0; }
+#endif
+
+        void write(const char* data, size_t size) {
+            while (size > 0) {
+#ifdef _WIN32
+                DWORD written = 0;
+                if (!WriteFile(handle, data, static_cast<DWORD>(size), &written, nullptr) || written == 0) return;
+#else
+                ssize_t written = ::write(fd, data, size);
+                if (written < 0 && errno == EINTR) continue;
+                if (written <= 0) return;
+#endif
+                data += written;
+                size -= static_cast<size_t>(written);
+            }
+        }
+
+    private:
+#ifdef _WIN32
+        HANDLE handle = INVALID_HANDLE_VALUE;
+#else
+        int fd = -1;
+#endif
+    };
+
+    // Collects the solver output: keeps it for the result, appends it to the XTurb_Execution_Log.txt the batch file used to write
+    // and hands complete lines to request.onLine. A line split across two reads is held back until its end arrives.
+    class OutputSink {
+    public:
+        OutputSink(const ExecutionRequest& request, ExecutionResult& result) : request(request), result(result), lineStart(0) {
+            if (!request.logPath.empty()) {
+                log = std::make_unique<LogFile>(request.logPath);
+                if (!log->isOpen()) {
+                    Logger::logError(L"Failed to write execution log: " + request.logPath);
+                    log.reset();
+                }
+            }
+        }
+
+        // Returns false once onLine has asked to stop the solver
+        bool append(const char* data, size_t size) {
+            result.output.append(data, size);
+            if (log) {
+                log->write(data, size);
+            }
+            if (!request.onLine) {
+                return true;
+            }
+            size_t end;
+            while ((end = result.output.find('\n', lineStart)) != std::string::npos) {
+                bool keepRunning = deliver(end);
+                lineStart = end + 1;
+                if (!keepRunning) return false;
+            }
+            return true;
+        }
+
+        // Delivers an unterminated last line
+        void finish() {
+            if (request.onLine && lineStart < result.output.size()) {
+                deliver(result.output.size());
+                lineStart = result.output.size();
+            }
+        }
+
+    private:
+        bool deliver(size_t end) {
+            std::string_view line(result.output.data() + lineStart, end - lineStart);
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            return request.onLine(line);
+        }
+
+        const ExecutionRequest& request;
+        ExecutionResult& result;
+        std::unique_ptr<LogFile> log;
+        size_t lineStart;
+    };
+}
+
+#ifdef _WIN32
+std::unique_ptr<ExecutionBackend> ExecutionBackend::createDefault() {
+    return std::make_unique<Win32ExecutionBackend>();
+}
+
+namespace {
+    double processCpuSeconds(HANDLE process) {
+        FILETIME created, exited, kernel, user;
+        if (!GetProcessTimes(process, &created, &exited, &kernel, &user)) {
+            return 0.0;
+        }
+        auto ticks = [](const FILETIME& time) { return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime; };
+        return (ticks(kernel) + ticks(user)) * 1e-7; // 100 ns units
+    }
+
+    struct Win32Child {
+        PROCESS_INFORMATION pi = { 0 };
+        HANDLE readPipe = nullptr;
+    };
+
+    // Only the two redirection handles are passed to the child (PROC_THREAD_ATTRIBUTE_HANDLE_LIST), so solvers started in parallel
+    // from other threads never inherit each other's pipes and every pipe closes as soon as its own solver exits.
+    // input must be inheritable; the caller keeps ownership of it.
+    bool spawn(const ExecutionRequest& request, HANDLE input, Win32Child& child) {
+        SECURITY_ATTRIBUTES inheritable = { sizeof(SECURITY_ATTRIBUTES), nullptr, TRUE };
+        HANDLE readPipe = nullptr, writePipe = nullptr;
+        if (!CreatePipe(&readPipe, &writePipe, &inheritable, 0)) {
+            Logger::logError(L"Failed to create output pipe. Error code: " + std::to_wstring(GetLastError()));
+            return false;
+        }
+        SetHandleInformation(readPipe, HANDLE_FLAG_INHERIT, 0);
+
+        HANDLE inherited[2] = { input, writePipe };
+        SIZE_T attributeSize = 0;
+        InitializeProcThreadAttributeList(nullptr, 1, 0, &attributeSize);
+        std::vector<char> attributeBuffer(attributeSize);
+        auto attributes = reinterpret_cast<LPPROC_THREAD_ATTRIBUTE_LIST>(attributeBuffer.data());
+        bool attributesReady = InitializeProcThreadAttributeList(attributes, 1, 0, &attributeSize)
+            && UpdateProcThreadAttribute(attributes, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST, inherited, sizeof(inherited), nullptr, nullptr);
+
+        STARTUPINFOEXW si = {};
+        si.StartupInfo.cb = sizeof(si);
+        si.StartupInfo.dwFlags = STARTF_USESTDHANDLES;
+        si.StartupInfo.hStdInput = input;
+        si.StartupInfo.hStdOutput = writePipe;
+        si.StartupInfo.hStdError = writePipe;
+        si.lpAttributeList = attributesReady ? attributes : nullptr;
+
+        std::wstring commandLine = L"\"" + request.executablePath + L"\"";
+        BOOL success = CreateProcessW(
+            request.executablePath.c_str(),
+            &commandLine[0],
+            nullptr,
+            nullptr,
+            TRUE,
+            CREATE_NO_WINDOW | (attributesReady ? EXTENDED_STARTUPINFO_PRESENT : 0),
+            nullptr,
+            request.workingDirectory.empty() ? nullptr : request.workingDirectory.c_str(),
+            &si.StartupInfo,
+            &child.pi
+        );
+        if (attributesReady) DeleteProcThreadAttributeList(attributes);
+        // The child has its own copy now; closing ours lets the pipe report EOF when the solver exits
+        CloseHandle(writePipe);
+        if (!success) {
+            Logger::logError(L"Failed to start solver. Error code: " + std::to_wstring(GetLastError()));
+            CloseHandle(readPipe);
+            return false;
+        }
+        child.readPipe = readPipe;
+        return true;
+    }
+
+    // Collects the output of a started solver and enforces the limits of the request, counted from start. Closes the child's handles.
+    void supervise(Win32Child& child, const ExecutionRequest& request, std::chrono::steady_clock::time_point start, ExecutionResult& result) {
+        std::atomic<int64_t> lastOutputMs(0);
+        std::atomic<bool> aborted(false); // Set by both threads, copied into result once the reader is joined
+
+        // Drain the pipe on a helper thread so a chatty solver never blocks on a full pipe while we wait for it. Lines reach onLine
+        // from here as they are written; an abort terminates the process, which ends the wait below.
+        OutputSink sink(request, result);
+        std::thread reader([readPipe = child.readPipe, &sink, &aborted, &lastOutputMs, start, process = child.pi.hProcess]() {
+            char buffer[4096];
+            DWORD bytesRead = 0;
+            while (ReadFile(readPipe, buffer, sizeof(buffer), &bytesRead, nullptr) && bytesRead > 0) {
+                lastOutputMs = static_cast<int64_t>(secondsSince(start) * 1000.0);
+                if (!sink.append(buffer, bytesRead) && !aborted.exchange(true)) {
+                    TerminateProcess(process, 1);
+                }
+            }
+            sink.finish();
+        });
+
+        // The limits and the cancel flag are checked every 100 ms while the solver runs
+        while (WaitForSingleObject(child.pi.hProcess, 100) == WAIT_TIMEOUT) {
+            if (request.cancel && request.cancel->load()) {
+                TerminateProcess(child.pi.hProcess, 1);
+                WaitForSingleObject(child.pi.hProcess, INFINITE);
+                aborted = true;
+                break;
+            }
+            int64_t elapsedMs = static_cast<int64_t>(secondsSince(start) * 1000.0);
+            if (elapsedMs >= request.timeoutMs) {
+                result.limitHit = RunLimit::WallTime;
+            }
+            else if (request.inactivityTimeoutMs > 0 && elapsedMs - lastOutputMs >= request.inactivityTimeoutMs) {
+                result.limitHit = RunLimit::Inactivity;
+            }
+            else if (request.cpuLimitSeconds > 0.0 && processCpuSeconds(child.pi.hProcess) >= request.cpuLimitSeconds) {
+                result.limitHit = RunLimit::CpuTime;
+            }
+            if (result.limitHit != RunLimit::None) {
+                Logger::logError(L"Solver stopped by the " + std::wstring(limitName(result.limitHit)) + L" after " + std::to_wstring(elapsedMs) + L" ms");
+                TerminateProcess(child.pi.hProcess, 1);
+                WaitForSingleObject(child.pi.hProcess, INFINITE);
+                result.timedOut = true;
+                break;
+            }
+        }
+        DWORD exitCode = 0;
+        GetExitCodeProcess(child.pi.hProcess, &exitCode);
+        result.exitCode = static_cast<int>(exitCode);
+        result.wallSeconds = secondsSince(start);
+        result.cpuSeconds = processCpuSeconds(child.pi.hProcess);
+        reader.join();
+        result.aborted = aborted;
+
+        CloseHandle(child.readPipe);
+        CloseHandle(child.pi.hProcess);
+        CloseHandle(child.pi.hThread);
+        child = Win32Child();
+        if (result.aborted) {
+            Logger::logError(L"Solver aborted: " + request.executablePath);
+        }
+    }
+
+    // Holds the write end of the solver's stdin pipe until the job's input arrives
+    class Win32PreparedExecution : public PreparedExecution {
+    public:
+        Win32PreparedExecution(const Win32Child& child, HANDLE input) : child(child), input(input) {}
+
+        ~Win32PreparedExecution() override {
+            if (child.pi.hProcess) {
+                TerminateProcess(child.pi.hProcess, 1);
+                WaitForSingleObject(child.pi.hProcess, INFINITE);
+                CloseHandle(child.readPipe);
+                CloseHandle(child.pi.hProcess);
+                CloseHandle(child.pi.hThread);
+            }
+            if (input) CloseHandle(input);
+        }
+
+        ExecutionResult run(const std::string& text, const ExecutionRequest& request) override {
+            ExecutionResult result;
+            if (!child.pi.hProcess) {
+                return result;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            // The solver reads while we write, so even an input larger than the pipe buffer cannot block for long
+            size_t written = 0;
+            DWORD chunk = 0;
+            while (written < text.size() && WriteFile(input, text.data() + written, static_cast<DWORD>(text.size() - written), &chunk, nullptr)) {
+                written += chunk;
+            }
+            CloseHandle(input); // EOF for the solver
+            input = nullptr;
+            result.started = true;
+            result.launchSeconds = secondsSince(start);
+            supervise(child, request, start, result);
+            return result;
+        }
+
+    private:
+        Win32Child child;
+        HANDLE input;
+    };
+}
+
+ExecutionResult Win32ExecutionBackend::execute(const ExecutionRequest& request) {
+    ExecutionResult result;
+    const auto start = std::chrono::steady_clock::now();
+    SECURITY_ATTRIBUTES inheritable = { sizeof(SECURITY_ATTRIBUTES), nullptr, TRUE };
+    HANDLE input = CreateFileW(request.stdinPath.c_str(), GENERIC_READ, FILE_SHARE_READ, &inheritable, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (input == INVALID_HANDLE_VALUE) {
+        Logger::logError(L"Failed to open solver input: " + request.stdinPath);
+        return result;
+    }
+    Win32Child child;
+    bool started = spawn(request, input, child);
+    CloseHandle(input);
+    if (!started) {
+        return result;
+    }
+    result.started = true;
+    result.launchSeconds = secondsSince(start);
+    supervise(child, request, start, result);
+    return result;
+}
+
+// The solver gets the read end of an anonymous pipe as stdin; our write end is not inheritable
+std::unique_ptr<PreparedExecution> Win32ExecutionBackend::prepare(const ExecutionRequest& request) {
+    SECURITY_ATTRIBUTES inheritable = { sizeof(SECURITY_ATTRIBUTES), nullptr, TRUE };
+    HANDLE readInput = nullptr, writeInput = nullptr;
+    if (!CreatePipe(&readInput, &writeInput, &inheritable, 0)) {
+        Logger::logError(L"Failed to create input pipe. Error code: " + std::to_wstring(GetLastError()));
+        return nullptr;
+    }
+    SetHandleInformation(writeInput, HANDLE_FLAG_INHERIT, 0);
+    Win32Child child;
+    bool started = spawn(request, readInput, child);
+    CloseHandle(readInput);
+    if (!started) {
+        CloseHandle(writeInput);
+        return nullptr;
+    }
+    return std::make_unique<Win32PreparedExecution>(child, writeInput);
+}
+#else
+std::unique_ptr<ExecutionBackend> ExecutionBackend::createDefault() {
+    return std::make_unique<PosixExecutionBackend>();
+}
+
+namespace {
+#ifndef XTURB_HAVE_PIPE2
+    bool setCloseOnExec(int fd) {
+        int flags = fcntl(fd, F_GETFD);
+        return flags >= 0 && fcntl(fd, F_SETFD, flags | FD_CLOEXEC) == 0;
+    }
+
+    // Without pipe2 a pipe cannot be created close-on-exec in one step. Creating such pipes and forking are then serialized, so no
+    // solver started from another thread is forked between pipe() and fcntl() and inherits the descriptors.
+    std::mutex& descriptorMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+#endif
+
+    // Both ends close-on-exec, so solvers started from other threads do not inherit them
+    bool makePipe(int fds[2]) {
+#ifdef XTURB_HAVE_PIPE2
+        return pipe2(fds, O_CLOEXEC) == 0;
+#else
+        std::lock_guard<std::mutex> lock(descriptorMutex());
+        if (pipe(fds) != 0) return false;
+        if (setCloseOnExec(fds[0]) && setCloseOnExec(fds[1])) return true;
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+#endif
+    }
+
+    int decodeStatus(int status) {
+        if (WIFEXITED(status)) return WEXITSTATUS(status);
+        if (WIFSIGNALED(status)) return 128 + WTERMSIG(status);
+        return -1;
+    }
+
+    // The CPU limit is enforced by the kernel: SIGXCPU at the soft limit, SIGKILL a second later
+    rlimit cpuLimitFor(const ExecutionRequest& request) {
+        rlimit limit = {};
+        if (request.cpuLimitSeconds > 0.0) {
+            limit.rlim_cur = static_cast<rlim_t>(std::ceil(request.cpuLimitSeconds));
+            limit.rlim_max = limit.rlim_cur + 1;
+        }
+        return limit;
+    }
+
+    struct PosixChild {
+        pid_t pid = -1;
+        int output = -1;
+    };
+
+    // Everything the child needs is prepared before fork, since only async-signal-safe calls are allowed between fork and exec in a
+    // multithreaded process. A close-on-exec status pipe tells the parent whether exec itself failed. The caller keeps input.
+    bool spawn(const ExecutionRequest& request, int input, const rlimit& cpuLimit, PosixChild& child) {
+        const std::string executable = std::filesystem::path(request.executablePath).string();
+        const std::string workingDirectory = std::filesystem::path(request.workingDirectory).string();
+        int output[2], status[2];
+        if (!makePipe(output)) {
+            Logger::logError(L"Failed to create output pipe");
+            return false;
+        }
+        if (!makePipe(status)) {
+            Logger::logError(L"Failed to create status pipe");
+            close(output[0]);
+            close(output[1]);
+            return false;
+        }
+
+#ifndef XTURB_HAVE_PIPE2
+        std::unique_lock<std::mutex> forkLock(descriptorMutex());
+#endif
+        pid_t pid = fork();
+        if (pid == 0) {
+            if ((!workingDirectory.empty() && chdir(workingDirectory.c_str()) != 0)
+                || (cpuLimit.rlim_cur > 0 && setrlimit(RLIMIT_CPU, &cpuLimit) != 0)
+                || dup2(input, STDIN_FILENO) < 0 || dup2(output[1], STDOUT_FILENO) < 0 || dup2(output[1], STDERR_FILENO) < 0) {
+                int error = errno;
+                (void)!write(status[1], &error, sizeof(error));
+                _exit(127);
+            }
+            execl(executable.c_str(), executable.c_str(), static_cast<char*>(nullptr));
+            int error = errno;
+            (void)!write(status[1], &error, sizeof(error));
+            _exit(127);
+        }
+#ifndef XTURB_HAVE_PIPE2
+        forkLock.unlock();
+#endif
+        close(output[1]);
+        close(status[1]);
+        if (pid < 0) {
+            Logger::logError(L"Failed to fork solver process");
+            close(output[0]);
+            close(status[0]);
+            return false;
+        }
+
+        int childError = 0;
+        ssize_t statusBytes;
+        while ((statusBytes = read(status[0], &childError, sizeof(childError))) < 0 && errno == EINTR) {}
+        close(status[0]);
+        if (statusBytes > 0) {
+            Logger::logError(L"Failed to start solver " + request.executablePath + L", errno " + std::to_wstring(childError));
+            close(output[0]);
+            int ignored;
+            while (waitpid(pid, &ignored, 0) < 0 && errno == EINTR) {}
+            return false;
+        }
+        child.pid = pid;
+        child.output = output[0];
+        return true;
+    }
+
+    // Collects the output of a started solver and enforces the limits of the request, counted from start. Reaps the child.
+    void supervise(PosixChild& child, const ExecutionRequest& request, const rlimit& cpuLimit, std::chrono::steady_clock::time_point start, ExecutionResult& result) {
+        // Read until the solver closes its output, a limit is reached, onLine asks to stop or the request is cancelled
+        const auto deadline = start + std::chrono::milliseconds(request.timeoutMs);
+        auto lastOutput = start;
+        OutputSink sink(request, result);
+        char buffer[4096];
+        while (true) {
+            if (request.cancel && request.cancel->load()) {
+                result.aborted = true;
+                kill(child.pid, SIGKILL);
+                break;
+            }
+            auto now = std::chrono::steady_clock::now();
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+            if (remaining <= 0) {
+                result.limitHit = RunLimit::WallTime;
+                break;
+            }
+            if (request.inactivityTimeoutMs > 0) {
+                auto quiet = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastOutput).count();
+                if (quiet >= request.inactivityTimeoutMs) {
+                    result.limitHit = RunLimit::Inactivity;
+                    break;
+                }
+                remaining = std::min<long long>(remaining, request.inactivityTimeoutMs - quiet);
+            }
+            if (request.cancel) remaining = std::min<long long>(remaining, 100);
+            pollfd pfd = { child.output, POLLIN, 0 };
+            int ready = poll(&pfd, 1, static_cast<int>(remaining));
+            if (ready == 0 || (ready < 0 && errno == EINTR)) continue;
+            if (ready < 0) break;
+            ssize_t bytes = read(child.output, buffer, sizeof(buffer));
+            if (bytes < 0 && errno == EINTR) continue;
+            if (bytes <= 0) break;
+            lastOutput = std::chrono::steady_clock::now();
+            if (!sink.append(buffer, static_cast<size_t>(bytes))) {
+                result.aborted = true;
+                kill(child.pid, SIGKILL);
+                break;
+            }
+        }
+        if (!result.aborted) sink.finish();
+        close(child.output);
+
+        // A solver that closed stdout may still be shutting down; give it the rest of the deadline
+        int waitStatus = 0;
+        pid_t waited = 0;
+        rusage usage = {};
+        while (result.limitHit == RunLimit::None && !result.aborted) {
+            waited = wait4(child.pid, &waitStatus, WNOHANG, &usage);
+            if (waited == child.pid || (waited < 0 && errno != EINTR)) break;
+            if (std::chrono::steady_clock::now() >= deadline) {
+                result.limitHit = RunLimit::WallTime;
+                break;
+            }
+            if (request.cancel && request.cancel->load()) {
+                result.aborted = true;
+                break;
+            }
+            usleep(1000);
+        }
+        if (result.limitHit != RunLimit::None || result.aborted) {
+            kill(child.pid, SIGKILL);
+            while ((waited = wait4(child.pid, &waitStatus, 0, &usage)) < 0 && errno == EINTR) {}
+        }
+        result.wallSeconds = secondsSince(start);
+        result.cpuSeconds = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+        if (waited == child.pid && WIFSIGNALED(waitStatus) && result.limitHit == RunLimit::None && cpuLimit.rlim_cur > 0
+            && (WTERMSIG(waitStatus) == SIGXCPU || (WTERMSIG(waitStatus) == SIGKILL && result.cpuSeconds >= cpuLimit.rlim_cur))) {
+            result.limitHit = RunLimit::CpuTime;
+        }
+        result.timedOut = result.limitHit != RunLimit::None;
+        if (result.timedOut) {
+            Logger::logError(L"Solver stopped by the " + std::wstring(limitName(result.limitHit)) + L" after " + std::to_wstring(result.wallSeconds) + L" s");
+        }
+        else if (result.aborted) {
+            Logger::logError(L"Solver aborted: " + request.executablePath);
+        }
+        result.exitCode = waited == child.pid ? decodeStatus(waitStatus) : -1;
+        child = PosixChild();
+    }
+
+    // Writes the whole buffer to a pipe. SIGPIPE (the solver died before reading its input) is blocked for this thread and
+    // discarded, so it shows up as a write error instead of killing the tool.
+    bool writeAll(int fd, const std::string& text) {
+        sigset_t pipeSignal, previous;
+        sigemptyset(&pipeSignal);
+        sigaddset(&pipeSignal, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &pipeSignal, &previous);
+        size_t written = 0;
+        bool failed = false;
+        while (written < text.size()) {
+            ssize_t bytes = write(fd, text.data() + written, text.size() - written);
+            if (bytes < 0 && errno == EINTR) continue;
+            if (bytes <= 0) {
+                failed = true;
+                break;
+            }
+            written += static_cast<size_t>(bytes);
+        }
+        if (failed) {
+            timespec noWait = { 0, 0 };
+            while (sigtimedwait(&pipeSignal, nullptr, &noWait) < 0 && errno == EINTR) {}
+        }
+        pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+        return !failed;
+    }
+
+    // Holds the write end of the solver's stdin pipe until the job's input arrives
+    class PosixPreparedExecution : public PreparedExecution {
+    public:
+        PosixPreparedExecution(const PosixChild& child, int input) : child(child), input(input) {}
+
+        ~PosixPreparedExecution() override {
+            if (input >= 0) close(input);
+            if (child.pid > 0) {
+                kill(child.pid, SIGKILL);
+                int ignored;
+                while (waitpid(child.pid, &ignored, 0) < 0 && errno == EINTR) {}
+                close(child.output);
+            }
+        }
+
+        // The CPU limit of the job is only known now; on Linux it is applied to the waiting process with prlimit,
+        // elsewhere warm runs go without one
+        ExecutionResult run(const std::string& text, const ExecutionRequest& request) override {
+            ExecutionResult result;
+            if (child.pid <= 0) {
+                return result;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            rlimit cpuLimit = cpuLimitFor(request);
+#ifdef __linux__
+            if (cpuLimit.rlim_cur > 0 && prlimit(child.pid, RLIMIT_CPU, &cpuLimit, nullptr) != 0) {
+                cpuLimit = rlimit();
+            }
+#else
+            cpuLimit = rlimit();
+#endif
+            if (!writeAll(input, text)) {
+                Logger::logError(L"Failed to send input to prepared solver " + std::to_wstring(child.pid));
+            }
+            close(input); // EOF for the solver
+            input = -1;
+            result.started = true;
+            result.launchSeconds = secondsSince(start);
+            supervise(child, request, cpuLimit, start, result);
+            return result;
+        }
+
+    private:
+        PosixChild child;
+        int input;
+    };
+}
+
+ExecutionResult PosixExecutionBackend::execute(const ExecutionRequest& request) {
+    ExecutionResult result;
+    const auto start = std::chrono::steady_clock::now();
+    int input = open(std::filesystem::path(request.stdinPath).string().c_str(), O_RDONLY | O_CLOEXEC);
+    if (input < 0) {
+        Logger::logError(L"Failed to open solver input: " + request.stdinPath);
+        return result;
+    }
+    rlimit cpuLimit = cpuLimitFor(request);
+    PosixChild child;
+    bool started = spawn(request, input, cpuLimit, child);
+    close(input);
+    if (!started) {
+        return result;
+    }
+    result.started = true;
+    result.launchSeconds = secondsSince(start);
+    supervise(child, request, cpuLimit, start, result);
+    return result;
+}
+
+// The solver gets the read end of a pipe as stdin; the write end stays with the PreparedExecution
+std::unique_ptr<PreparedExecution> PosixExecutionBackend::prepare(const ExecutionRequest& request) {
+    int input[2];
+    if (!makePipe(input)) {
+        Logger::logError(L"Failed to create input pipe");
+        return nullptr;
+    }
+    PosixChild child;
+    bool started = spawn(request, input[0], rlimit(), child);
+    close(input[0]);
+    if (!started) {
+        close(input[1]);
+        return nullptr;
+    }
+    return std::make_unique<PosixPreparedExecution>(child, input[1]);
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// What to run: the solver executable, started in workingDirectory with stdin read from stdinPath.
+// stdout and stderr are captured together through a pipe and also written to logPath (as they arrive) if one is given.
+struct ExecutionRequest {
+    std::wstring executablePath;
+    std::wstring workingDirectory;
+    std::wstring stdinPath;
+    std::wstring logPath;
+    unsigned timeoutMs = 30000;          // Wall-clock limit
+    unsigned inactivityTimeoutMs = 0;    // Kill the solver if it writes no output for this long; 0 disables
+    double cpuLimitSeconds = 0.0;        // Kill the solver once it has used this much CPU time; 0 disables
+    // Called with every complete output line (without the line break) as soon as the solver writes it, from the thread that
+    // drains the pipe. Returning false kills the solver and marks the result as aborted.
+    std::function<bool(std::string_view line)> onLine;
+    // Set from another thread to kill the solver; checked at least every 100 ms, the result is marked as aborted. May be null.
+    const std::atomic<bool>* cancel = nullptr;
+};
+
+// Which limit of the request stopped the solver
+enum class RunLimit { None, WallTime, Inactivity, CpuTime };
+
+struct ExecutionResult {
+    bool started = false;
+    bool timedOut = false; // Killed by one of the limits, limitHit says which
+    bool aborted = false;  // Killed because onLine asked for it or the request was cancelled
+    RunLimit limitHit = RunLimit::None;
+    int exitCode = -1;
+    double wallSeconds = 0.0;
+    double cpuSeconds = 0.0; // User plus kernel time of the solver process
+    double launchSeconds = 0.0; // From the call until the solver was running with its input
+    std::string output; // Captured stdout and stderr, as the solver wrote them
+};
+
+// A solver process started ahead of time in its working directory. It has loaded and is blocked reading stdin from a pipe, so a
+// job only has to send its input. The destructor kills the process if run() was never called.
+class PreparedExecution {
+public:
+    virtual ~PreparedExecution() = default;
+    // Sends the input and then supervises the run exactly like ExecutionBackend::execute. Only the limits, logPath and onLine of the
+    // request are used; the process already has its executable and working directory. Can be called once.
+    virtual ExecutionResult run(const std::string& input, const ExecutionRequest& request) = 0;
+};
+
+// Starts a solver process and waits for it. XTurbRunner (and everything built on it) only talks to this interface,
+// so the same run logic drives the solver on Windows desktops and on Linux compute nodes.
+class ExecutionBackend {
+public:
+    virtual ~ExecutionBackend() = default;
+    virtual ExecutionResult execute(const ExecutionRequest& request) = 0;
+    // Starts request.executablePath in request.workingDirectory without its input. Null if the backend cannot do that.
+    virtual std::unique_ptr<PreparedExecution> prepare(const ExecutionRequest& request) { (void)request; return nullptr; }
+
+    // The native backend of the platform the tool was built for
+    static std::unique_ptr<ExecutionBackend> createDefault();
+};
+
+#ifdef _WIN32
+// CreateProcessW with the redirections set up on inheritable handles, no cmd.exe or batch file in between
+class Win32ExecutionBackend : public ExecutionBackend {
+public:
+    ExecutionResult execute(const ExecutionRequest& request) override;
+    std::unique_ptr<PreparedExecution> prepare(const ExecutionRequest& request) override;
+};
+#else
+// fork/exec with stdin opened from the input file and stdout/stderr on a pipe
+class PosixExecutionBackend : public ExecutionBackend {
+public:
+    ExecutionResult execute(const ExecutionRequest& request) override;
+    std::unique_ptr<PreparedExecution> prepare(const ExecutionRequest& request) override;
+};
+#endif
\ No newline at end of file
@@ -12,13 +12,14 @@ FileCompressor::FileCompressor(const std::string& directory) : directory_(direct
     }
 }
 
-bool FileCompressor::compressFiles() {
+bool FileCompressor::compressFiles(bool skipMissing) {
     bool allSuccess = true;
     for (const auto& filename : filenames_) {
         std::string inputPath = directory_ + filename;
         std::string outputPath = inputPath + ".gz";
 
         if (!fs::exists(inputPath)) {
+            if (skipMissing) continue;
             std::cerr << "Error: File " << inputPath << " does not exist.\n";
             allSuccess = false;
             continue;
@@ -59,7 +60,7 @@ bool FileCompressor::compressFile(const std::string& inputFile, const std::strin
     zs.avail_in = buffer.size();
     zs.next_in = reinterpret_cast<unsigned char*>(buffer.data());
 
-    std::vector<unsigned char> output(compressBound(buffer.size()));
+    std::vector<unsigned char> output(deflateBound(&zs, buffer.size())); // Includes the gzip header, unlike compressBound
     zs.avail_out = output.size();
     zs.next_out = output.data();
 
@@ -6,7 +6,8 @@
 class FileCompressor {
 public:
     explicit FileCompressor(const std::string& directory);
-    bool compressFiles();
+    // skipMissing: files the solver did not write are not an error (a run only writes the outputs of its modes)
+    bool compressFiles(bool skipMissing = false);
 
 private:
     std::string directory_;
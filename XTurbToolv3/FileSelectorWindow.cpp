@@ -73,6 +73,13 @@ void FileSelectorWindow::create(HINSTANCE hInstance, int nCmdShow) {
         Logger::logError(L"Failed to create select button in FileSelectorWindow");
     }
 
+    // Create Open All Button, parses every listed file in parallel
+    HWND openAllButton = CreateWindowW(L"BUTTON", L"Open All", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
+        260, 70, 100, 30, hwnd, (HMENU)1004, hInstance, nullptr);
+    if (!openAllButton) {
+        Logger::logError(L"Failed to create open all button in FileSelectorWindow");
+    }
+
     // Create Save Output Files Button
     HWND saveButton = CreateWindowW(L"BUTTON", L"Save Output Files", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
         140, 110, 120, 30, hwnd, (HMENU)1003, hInstance, nullptr);
@@ -108,6 +115,15 @@ void FileSelectorWindow::refreshFileList() {
     }
 }
 
+// Full paths of all files in the list
+std::vector<std::wstring> FileSelectorWindow::getFilePaths() const {
+    std::vector<std::wstring> paths;
+    for (const auto& file : files) {
+        paths.push_back(directory + L"\\" + file);
+    }
+    return paths;
+}
+
 LRESULT FileSelectorWindow::handleMessage(UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
     case WM_COMMAND:
@@ -122,6 +138,11 @@ LRESULT FileSelectorWindow::handleMessage(UINT msg, WPARAM wParam, LPARAM lParam
                 Logger::logError(L"No file selected");
             }
         }
+        else if (LOWORD(wParam) == 1004 && HIWORD(wParam) == BN_CLICKED) {
+            if (!files.empty()) {
+                PostMessage(parent, WM_USER + 104, 0, (LPARAM)this);
+            }
+        }
         else if (LOWORD(wParam) == 1003 && HIWORD(wParam) == BN_CLICKED) {
             if (compressor && compressor->compressFiles()) {
                 Logger::logError(L"Successfully compressed output files");
@@ -13,6 +13,7 @@ public:
     void create(HINSTANCE hInstance, int nCmdShow) override;
     LRESULT handleMessage(UINT msg, WPARAM wParam, LPARAM lParam) override;
     std::wstring getSelectedFile() const { return selectedFile; }
+    std::vector<std::wstring> getFilePaths() const;
     void refreshFileList();
     static void RegisterClass(HINSTANCE hInstance);
 
@@ -17,7 +17,7 @@ static LRESULT CALLBACK GraphWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM
         HDC hdc = BeginPaint(hwnd, &ps);
         RECT rect;
         GetClientRect(hwnd, &rect);
-        Logger::logError(L"Graph WM_PAINT called for hwnd " + std::to_wstring(reinterpret_cast<LONG_PTR>(hwnd)));
+        LOG_TRACE(L"Graph WM_PAINT called for hwnd " + std::to_wstring(reinterpret_cast<LONG_PTR>(hwnd)));
         pGraph->draw(hdc, rect);
         EndPaint(hwnd, &ps);
         return 0;
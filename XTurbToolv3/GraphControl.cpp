@@ -4,9 +4,10 @@
 #include <limits> // For std::numeric_limits
 
 // Constructs a GraphControl object, initializes the graph, and logs the result of hwnd creation.
-GraphControl::GraphControl(HWND parent, HINSTANCE hInstance, int x, int y, int width, int height, const OutputData::Table& table)
-    : Graph(parent, hInstance, x, y, width, height), table(table) {
-    Logger::logError(L"GraphControl constructed with " + std::to_wstring(table.rows.size()) + L" rows");
+GraphControl::GraphControl(HWND parent, HINSTANCE hInstance, int x, int y, int width, int height, OutputSnapshot data, size_t table, size_t column)
+    : Graph(parent, hInstance, x, y, width, height), data(std::move(data)), xLabel(this->data->tables[table].headers[0]), yLabel(this->data->tables[table].headers[column]),
+    xValues(this->data->tables[table].column(0)), yValues(this->data->tables[table].column(column)) {
+    Logger::logError(L"GraphControl constructed with " + std::to_wstring(xValues.size()) + L" rows");
     create(); // Explicitly call create()
 
     // Checks if the GraphControl hwnd is initialized and logs the result.
@@ -20,37 +21,36 @@ GraphControl::GraphControl(HWND parent, HINSTANCE hInstance, int x, int y, int w
 
 // Logs the draw function call and handles the case where there is no data to plot.
 void GraphControl::draw(HDC hdc, RECT rect) {
-    Logger::logError(L"GraphControl::draw called for hwnd " + std::to_wstring(reinterpret_cast<LONG_PTR>(getHandle())));
-    if (table.headers.empty() || table.rows.empty()) {
+    LOG_TRACE(L"GraphControl::draw called for hwnd " + std::to_wstring(reinterpret_cast<LONG_PTR>(getHandle())));
+    if (xValues.empty() || yValues.empty()) {
         TextOutW(hdc, rect.left + 10, rect.top + 10, L"No data to plot", 14);
-        Logger::logError(L"No data to plot in GraphControl");
+        LOG_TRACE(L"No data to plot in GraphControl");
         return;
     }
 
     // Logs data processing for graph points, handling invalid (NaN) data points.
-    Logger::logError(L"GraphControl plotting " + std::to_wstring(table.rows.size()) + L" rows");
-    std::vector<double> xData;
-    std::vector<double> yData;
-    for (size_t i = 0; i < table.rows.size(); ++i) {
-        const auto& row = table.rows[i];
-        if (row.size() >= 2) {
-            double x = row[0]; // r/R
-            double y = row[1]; // e.g., Chord/R
-            // Skips the data point and logs an error if either x or y is NaN.
-            if (std::isnan(x) || std::isnan(y)) {
-                Logger::logError(L"Skipping point due to NaN: row " + std::to_wstring(i));
-                continue;
-            }
-            xData.push_back(x);
-            yData.push_back(y);
-            Logger::logError(L"Graph point: " + std::to_wstring(x) + L", " + std::to_wstring(y));
+    LOG_TRACE(L"GraphControl plotting " + std::to_wstring(xValues.size()) + L" rows");
+    xData.clear();
+    yData.clear();
+    xData.reserve(xValues.size());
+    yData.reserve(yValues.size());
+    for (size_t i = 0; i < xValues.size() && i < yValues.size(); ++i) {
+        double x = xValues[i]; // r/R
+        double y = yValues[i]; // e.g., Chord/R
+        // Skips the data point and logs an error if either x or y is NaN.
+        if (std::isnan(x) || std::isnan(y)) {
+            LOG_TRACE(L"Skipping point due to NaN: row " + std::to_wstring(i));
+            continue;
         }
+        xData.push_back(x);
+        yData.push_back(y);
+        LOG_TRACE(L"Graph point: " + std::to_wstring(x) + L", " + std::to_wstring(y));
     }
 
     // Checks if there is insufficient data to plot the graph and displays an error message.
     if (xData.empty() || yData.empty()) {
         TextOutW(hdc, rect.left + 10, rect.top + 10, L"Insufficient data", 17);
-        Logger::logError(L"Insufficient data for graph");
+        LOG_TRACE(L"Insufficient data for graph");
         return;
     }
 
@@ -75,7 +75,7 @@ void GraphControl::draw(HDC hdc, RECT rect) {
     // Checks for invalid graph range and prevents plotting if the range is not valid.
     if (minX >= maxX || minY >= maxY) {
         TextOutW(hdc, rect.left + 10, rect.top + 10, L"No Printable Values", 13);
-        Logger::logError(L"GraphControl: Invalid range for plotting");
+        LOG_TRACE(L"GraphControl: Invalid range for plotting");
         SelectObject(hdc, hOldPen);
         DeleteObject(hPen);
         return;
@@ -113,9 +113,9 @@ void GraphControl::draw(HDC hdc, RECT rect) {
 
     // Axis titles (unchanged)
     SetTextAlign(hdc, TA_CENTER);
-    TextOutW(hdc, graphLeft + graphWidth / 2, graphBottom + 10, table.headers[0].c_str(), table.headers[0].length());
+    TextOutW(hdc, graphLeft + graphWidth / 2, graphBottom + 10, xLabel.c_str(), xLabel.length());
     SetTextAlign(hdc, TA_RIGHT);
-    TextOutW(hdc, graphLeft - 20, graphTop - 35, table.headers[1].c_str(), table.headers[1].length());
+    TextOutW(hdc, graphLeft - 20, graphTop - 35, yLabel.c_str(), yLabel.length());
 
     SelectObject(hdc, hOldPen);
     DeleteObject(hPen);
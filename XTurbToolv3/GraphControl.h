@@ -6,9 +6,17 @@
 // This class creates graphs from the output file. In a seperate file, since it works different than the Twist and Chord Graphs. 
 class GraphControl : public Graph {
 public:
-    GraphControl(HWND parent, HINSTANCE hInstance, int x, int y, int width, int height, const OutputData::Table& table);
+    // Plots column 0 of the table against the given column. The graph keeps views into the table and holds the snapshot to keep them valid.
+    GraphControl(HWND parent, HINSTANCE hInstance, int x, int y, int width, int height, OutputSnapshot data, size_t table, size_t column);
     void draw(HDC hdc, RECT rect) override;
 
 private:
-    OutputData::Table table;
+    OutputSnapshot data;
+    std::wstring xLabel;
+    std::wstring yLabel;
+    OutputData::ColumnView xValues;
+    OutputData::ColumnView yValues;
+    // Valid points of the last paint. Kept between paints so redrawing does not allocate.
+    std::vector<double> xData;
+    std::vector<double> yData;
 };
\ No newline at end of file
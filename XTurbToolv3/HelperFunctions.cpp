@@ -1,15 +1,81 @@
 #include "HelperFunctions.h"
+#ifdef _WIN32
 #include "header.h" // For WideCharToMultiByte
+#endif
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+#include <filesystem>
+#include <random>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 // Helper to convert wstring to string (UTF-8)
 std::string wstring_to_string(const std::wstring& wstr) {
     if (wstr.empty()) return "";
 
+#ifdef _WIN32
     // Converts a wide-character string (UTF-16) to a UTF-8 encoded std::string.
     int size_needed = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, nullptr, 0, nullptr, nullptr);
     std::string result(size_needed - 1, 0);  // -1 to exclude null terminator
     WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, &result[0], size_needed, nullptr, nullptr);
     return result;
+#else
+    // wchar_t holds whole code points (UTF-32) here, so each one is encoded on its own
+    std::string result;
+    result.reserve(wstr.size());
+    for (wchar_t ch : wstr) {
+        uint32_t c = static_cast<uint32_t>(ch);
+        if (c < 0x80) {
+            result += static_cast<char>(c);
+        }
+        else if (c < 0x800) {
+            result += static_cast<char>(0xC0 | (c >> 6));
+            result += static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else if (c < 0x10000) {
+            result += static_cast<char>(0xE0 | (c >> 12));
+            result += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else {
+            result += static_cast<char>(0xF0 | (c >> 18));
+            result += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            result += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+    return result;
+#endif
+}
+
+// Helper to convert string (UTF-8) to wstring
+std::wstring string_to_wstring(const std::string& str) {
+    if (str.empty()) return L"";
+
+#ifdef _WIN32
+    int size_needed = MultiByteToWideChar(CP_UTF8, 0, str.data(), static_cast<int>(str.size()), nullptr, 0);
+    std::wstring result(size_needed, 0);
+    MultiByteToWideChar(CP_UTF8, 0, str.data(), static_cast<int>(str.size()), &result[0], size_needed);
+    return result;
+#else
+    std::wstring result;
+    result.reserve(str.size());
+    for (size_t i = 0; i < str.size();) {
+        unsigned char c = static_cast<unsigned char>(str[i]);
+        size_t length = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 1;
+        uint32_t code = length == 1 ? c : c & (0x3F >> (length - 1));
+        for (size_t k = 1; k < length && i + k < str.size(); ++k) {
+            code = (code << 6) | (static_cast<unsigned char>(str[i + k]) & 0x3F);
+        }
+        result += static_cast<wchar_t>(code);
+        i += length;
+    }
+    return result;
+#endif
 }
 
 // Helper to convert double to string with fixed precision
@@ -27,11 +93,11 @@ std::vector<double> parseCommaSeparatedDoubles(const std::wstring& text) {
     // Splits a wide-character string by commas and converts each token to a double, storing the result in a vector.
     while ((pos = wstr.find(L',')) != std::wstring::npos) {
         std::wstring token = wstr.substr(0, pos);
-        values.push_back(_wtof(token.c_str()));
+        values.push_back(std::wcstod(token.c_str(), nullptr));
         wstr.erase(0, pos + 1);
     }
     if (!wstr.empty()) {
-        values.push_back(_wtof(wstr.c_str()));
+        values.push_back(std::wcstod(wstr.c_str(), nullptr));
     }
     return values;
 }
@@ -51,4 +117,65 @@ std::vector<std::wstring> parseCommaSeparatedWStrings(const std::wstring& text)
         values.push_back(wstr);
     }
     return values;
+}
+
+// Helper to hash content 8 bytes at a time, with the tail mixed in byte by byte
+uint64_t hashContent(std::string_view content, uint64_t seed) {
+    uint64_t hash = seed;
+    size_t i = 0;
+    for (; i + 8 <= content.size(); i += 8) {
+        uint64_t word;
+        std::memcpy(&word, content.data() + i, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    for (; i < content.size(); ++i) {
+        hash = (hash ^ static_cast<unsigned char>(content[i])) * 1099511628211ull;
+    }
+    // Word-wise FNV spreads a change only towards the higher bits; the final mix makes every input bit reach every output bit
+    hash ^= content.size();
+    hash = (hash ^ (hash >> 33)) * 0xFF51AFD7ED558CCDull;
+    hash = (hash ^ (hash >> 33)) * 0xC4CEB9FE1A85EC53ull;
+    return hash ^ (hash >> 33);
+}
+
+// Helper to format a 64-bit value as 16 hex digits
+std::wstring to_hex(uint64_t value) {
+    static const wchar_t digits[] = L"0123456789abcdef";
+    std::wstring text(16, L'0');
+    for (int i = 15; i >= 0; --i, value >>= 4) {
+        text[i] = digits[value & 0xF];
+    }
+    return text;
+}
+
+// Hard links cost nothing and keep scratch directories small; copying is the fallback across volumes or on filesystems without links
+bool linkOrCopyFile(const std::wstring& source, const std::wstring& target) {
+    std::filesystem::path targetPath(target);
+    std::error_code ec;
+    std::filesystem::create_directories(targetPath.parent_path(), ec);
+    std::filesystem::remove(targetPath, ec);
+    std::filesystem::create_hard_link(source, targetPath, ec);
+    if (!ec) {
+        return true;
+    }
+    std::filesystem::copy_file(source, targetPath, std::filesystem::copy_options::overwrite_existing, ec);
+    return !ec;
+}
+
+// The token mixes the process id, the clock and the random device, so even a host whose random device is deterministic differs from
+// the other processes on it
+std::wstring uniqueTempSuffix() {
+    static const std::wstring token = [] {
+#ifdef _WIN32
+        uint64_t pid = GetCurrentProcessId();
+#else
+        uint64_t pid = static_cast<uint64_t>(getpid());
+#endif
+        std::random_device device;
+        uint64_t parts[3] = { pid, static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()),
+            (static_cast<uint64_t>(device()) << 32) ^ device() };
+        return to_hex(hashContent(std::string_view(reinterpret_cast<const char*>(parts), sizeof(parts))));
+    }();
+    static std::atomic<uint64_t> counter{ 0 };
+    return L"." + token + L"-" + std::to_wstring(counter.fetch_add(1)) + L".tmp";
 }
\ No newline at end of file
@@ -1,11 +1,16 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector> 
 
 // convert wstring to string (UTF-8)
 std::string wstring_to_string(const std::wstring& wstr);
 
+// convert UTF-8 string to wstring
+std::wstring string_to_wstring(const std::string& str);
+
 // convert double to string
 std::string to_string(double value);
 
@@ -13,4 +18,18 @@ std::string to_string(double value);
 std::vector<double> parseCommaSeparatedDoubles(const std::wstring& text);
 
 // parse comma-separated values into a vector of wstrings
-std::vector<std::wstring> parseCommaSeparatedWStrings(const std::wstring& text);
\ No newline at end of file
+std::vector<std::wstring> parseCommaSeparatedWStrings(const std::wstring& text);
+
+// 64-bit FNV-1a over 8-byte words with a final mix, for detecting changed content (caches, result keys). Not meant to resist attacks.
+uint64_t hashContent(std::string_view content, uint64_t seed = 14695981039346656037ull);
+
+// fixed width lowercase hex, e.g. for hash based file names
+std::wstring to_hex(uint64_t value);
+
+// ".<process token>-<counter>.tmp" for a temporary file written next to its target and renamed over it. Unique per call, per process
+// and (through a random process token) across hosts sharing a directory, so concurrent writers of one target never share a temp file.
+std::wstring uniqueTempSuffix();
+
+// hard-links target to source (replacing target), copies if linking is not possible (other volume, no link support).
+// Creates the parent directory of target.
+bool linkOrCopyFile(const std::wstring& source, const std::wstring& target);
\ No newline at end of file
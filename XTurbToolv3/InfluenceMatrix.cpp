@@ -0,0 +1,172 @@
+#include "InfluenceMatrix.h"
+#include "CpuFeatures.h"
+#include "InfluenceMatrixTile.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace {
+    using InfluenceTile::TileInput;
+    using InfluenceTile::tileRange;
+
+    void tileGeneric(const TileInput& in, size_t firstTarget, size_t lastTarget, size_t firstGroup, size_t lastGroup) {
+        tileRange(in, firstTarget, lastTarget, firstGroup, lastGroup);
+    }
+
+    // Tiles still to do of one thread, [front, back); the owner takes from the front, thieves from the back
+    struct TileRange {
+        std::mutex mutex;
+        size_t front = 0;
+        size_t back = 0;
+    };
+
+    // Shared between the caller and the helper tasks, so helpers that start after the last tile is done find nothing to do
+    struct AssemblyState {
+        std::unique_ptr<TileRange[]> ranges;
+        size_t participants = 0;
+        size_t total = 0;
+        size_t done = 0;
+        std::atomic<size_t> steals{ 0 };
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+
+    bool takeFront(TileRange& range, size_t& tile) {
+        std::lock_guard<std::mutex> lock(range.mutex);
+        if (range.front == range.back) return false;
+        tile = range.front++;
+        return true;
+    }
+
+    // Moves the back half of the fullest other range to thief's (empty) range; false once every range is empty
+    bool steal(AssemblyState& state, size_t thief) {
+        for (;;) {
+            size_t victim = state.participants, most = 0;
+            for (size_t p = 0; p < state.participants; ++p) {
+                if (p == thief) continue;
+                std::lock_guard<std::mutex> lock(state.ranges[p].mutex);
+                if (state.ranges[p].back - state.ranges[p].front > most) {
+                    most = state.ranges[p].back - state.ranges[p].front;
+                    victim = p;
+                }
+            }
+            if (victim == state.participants) return false;
+            size_t first, last;
+            {
+                std::lock_guard<std::mutex> lock(state.ranges[victim].mutex);
+                TileRange& range = state.ranges[victim];
+                if (range.front == range.back) continue; // Emptied since it was looked at
+                last = range.back;
+                first = range.front + (range.back - range.front) / 2;
+                range.back = first;
+            }
+            std::lock_guard<std::mutex> lock(state.ranges[thief].mutex);
+            state.ranges[thief].front = first;
+            state.ranges[thief].back = last;
+            state.steals.fetch_add(1);
+            return true;
+        }
+    }
+}
+
+InfluenceMatrix::Implementation InfluenceMatrix::bestImplementation() {
+#ifdef XTURB_X86
+    static const Implementation best = CpuFeatures::hasAVX2FMA() ? Implementation::AVX2 : Implementation::Generic;
+    return best;
+#else
+    return Implementation::Generic;
+#endif
+}
+
+void InfluenceMatrix::assemble(const double* x, const double* y, const double* z, size_t targets,
+    const std::vector<VortexTree::Segment>& segments, const std::vector<uint32_t>& groupStart, ThreadPool* pool) {
+    auto started = std::chrono::steady_clock::now();
+    rowCount = targets;
+    columnCount = groupStart.empty() ? 0 : groupStart.size() - 1;
+    cu.assign(rowCount * columnCount, 0.0);
+    cv.assign(rowCount * columnCount, 0.0);
+    cw.assign(rowCount * columnCount, 0.0);
+    tx.assign(x, x + targets);
+    ty.assign(y, y + targets);
+    tz.assign(z, z + targets);
+    const size_t count = segments.size();
+    for (auto* column : { &x1, &y1, &z1, &x2, &y2, &z2, &core4 }) column->resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const VortexTree::Segment& segment = segments[i];
+        x1[i] = segment.x1;
+        y1[i] = segment.y1;
+        z1[i] = segment.z1;
+        x2[i] = segment.x2;
+        y2[i] = segment.y2;
+        z2[i] = segment.z2;
+        core4[i] = segment.core * segment.core * segment.core * segment.core;
+    }
+    groups = groupStart;
+
+    // Source blocks of whole groups, closed once they reach sourceBlock segments
+    sourceBlocks.clear();
+    for (size_t g = 0; g < columnCount; ++g) {
+        if (sourceBlocks.empty() || groups[g] - groups[sourceBlocks.back()] >= sourceBlock) {
+            sourceBlocks.push_back(static_cast<uint32_t>(g));
+        }
+    }
+    sourceBlocks.push_back(static_cast<uint32_t>(columnCount));
+    const size_t targetBlocks = (rowCount + targetBlock - 1) / targetBlock;
+    const size_t tiles = targetBlocks * (sourceBlocks.size() - 1);
+    statistics = Statistics();
+    statistics.tiles = tiles;
+    statistics.interactions = rowCount * count;
+
+    // Consecutive tiles share a source block, so a thread's range reuses the segments it has in cache
+    auto state = std::make_shared<AssemblyState>();
+    state->participants = std::max<size_t>(1, std::min(tiles, pool ? pool->size() + 1 : 1));
+    state->total = tiles;
+    state->ranges = std::make_unique<TileRange[]>(state->participants);
+    for (size_t p = 0; p < state->participants; ++p) {
+        state->ranges[p].front = tiles * p / state->participants;
+        state->ranges[p].back = tiles * (p + 1) / state->participants;
+    }
+    auto work = [this](AssemblyState& shared, size_t participant) {
+        size_t completed = 0, tile;
+        for (;;) {
+            if (!takeFront(shared.ranges[participant], tile)) {
+                if (!steal(shared, participant)) break;
+                continue;
+            }
+            assembleTile(tile);
+            ++completed;
+        }
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.done += completed;
+        if (shared.done == shared.total) shared.finished.notify_all();
+    };
+    for (size_t p = 1; p < state->participants; ++p) {
+        pool->submit([state, work, p]() { work(*state, p); });
+    }
+    work(*state, 0);
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&state]() { return state->done == state->total; });
+    }
+    statistics.steals = state->steals.load();
+    statistics.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+void InfluenceMatrix::assembleTile(size_t tile) {
+    const size_t targetBlocks = (rowCount + targetBlock - 1) / targetBlock;
+    const size_t source = tile / targetBlocks, target = tile % targetBlocks;
+    const TileInput in = { tx.data(), ty.data(), tz.data(), x1.data(), y1.data(), z1.data(), x2.data(), y2.data(), z2.data(), core4.data(),
+        groups.data(), cu.data(), cv.data(), cw.data(), columnCount };
+    const size_t firstTarget = target * targetBlock, lastTarget = std::min(firstTarget + targetBlock, rowCount);
+#ifdef XTURB_X86
+    if (implementation == Implementation::AVX2) {
+        InfluenceTile::tileAVX2(in, firstTarget, lastTarget, sourceBlocks[source], sourceBlocks[source + 1]);
+        return;
+    }
+#endif
+    tileGeneric(in, firstTarget, lastTarget, sourceBlocks[source], sourceBlocks[source + 1]);
+}
\ No newline at end of file
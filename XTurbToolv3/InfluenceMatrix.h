@@ -0,0 +1,60 @@
+#pragma once
+#include "VortexTree.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+// Velocity induced at a set of targets by groups of vortex segments of unit circulation, every segment summed exactly: entry
+// (t, g) is the velocity at target t of all segments of group g. A vortex method whose strengths change but whose wake does not
+// assembles this once per wake and gets the target velocities of any circulation as a matrix-vector product.
+// The segments are copied into structure-of-arrays order, and the matrix is filled in tiles of targetBlock targets by about
+// sourceBlock segments (whole groups), so the segments of a tile stay in cache while every target of the tile passes over them.
+// Tiles are spread over the threads of a pool: each thread starts on a contiguous range of them, and one that runs dry steals the
+// back half of the largest remaining range.
+class InfluenceMatrix {
+public:
+    static constexpr size_t targetBlock = 16;
+    static constexpr size_t sourceBlock = 2048;
+
+    // The segment sums run on AVX2 when the CPU has it (see bestImplementation)
+    enum class Implementation { Generic, AVX2 };
+    static Implementation bestImplementation();
+    void setImplementation(Implementation choice) { implementation = choice; }
+
+    // groupStart holds the first segment of every group and, last, segments.size(); group g is segments[groupStart[g]] up to
+    // segments[groupStart[g + 1] - 1]
+    void assemble(const double* x, const double* y, const double* z, size_t targets, const std::vector<VortexTree::Segment>& segments,
+        const std::vector<uint32_t>& groupStart, ThreadPool* pool = nullptr);
+
+    size_t rows() const { return rowCount; }
+    size_t columns() const { return columnCount; }
+    // Row t of each velocity component, columns() entries
+    const double* u(size_t target) const { return cu.data() + target * columnCount; }
+    const double* v(size_t target) const { return cv.data() + target * columnCount; }
+    const double* w(size_t target) const { return cw.data() + target * columnCount; }
+
+    struct Statistics {
+        size_t tiles = 0;
+        size_t steals = 0;        // Ranges taken over from another thread
+        size_t interactions = 0;  // Targets times segments
+        double seconds = 0.0;
+    };
+    // Of the last assemble()
+    const Statistics& getStatistics() const { return statistics; }
+
+private:
+    void assembleTile(size_t tile);
+
+    Implementation implementation = bestImplementation();
+    size_t rowCount = 0;
+    size_t columnCount = 0;
+    std::vector<double> cu, cv, cw;
+    // Assembly input: targets, segments in SoA order and the tiles' group ranges
+    std::vector<double> tx, ty, tz;
+    std::vector<double> x1, y1, z1, x2, y2, z2, core4;
+    std::vector<uint32_t> groups;
+    std::vector<uint32_t> sourceBlocks; // First group of every source block, then the group count
+    Statistics statistics;
+};
\ No newline at end of file
@@ -0,0 +1,6 @@
+// Built with -mavx2 -mfma (/arch:AVX2), and only called when CpuFeatures::hasAVX2FMA()
+#include "InfluenceMatrixTile.h"
+
+void InfluenceTile::tileAVX2(const TileInput& in, size_t firstTarget, size_t lastTarget, size_t firstGroup, size_t lastGroup) {
+    tileRange(in, firstTarget, lastTarget, firstGroup, lastGroup);
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+// The tile loop of InfluenceMatrix, included by InfluenceMatrix.cpp and InfluenceMatrixAVX2.cpp so it is compiled once for the
+// baseline instruction set and once for AVX2 / FMA. tileRange has internal linkage, so each file keeps its own copy (see
+// CpuFeatures.h).
+#include "BiotSavart.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace InfluenceTile {
+    constexpr size_t W = 8; // Segments per step of the group sums
+
+    struct TileInput {
+        const double *tx, *ty, *tz;
+        const double *x1, *y1, *z1, *x2, *y2, *z2, *core4;
+        const uint32_t* groups;
+        double *u, *v, *w;
+        size_t columns;
+    };
+
+    // tileRange built for AVX2 / FMA (InfluenceMatrixAVX2.cpp)
+    void tileAVX2(const TileInput& in, size_t firstTarget, size_t lastTarget, size_t firstGroup, size_t lastGroup);
+
+    namespace {
+        // Targets [firstTarget, lastTarget) against groups [firstGroup, lastGroup): each group summed W segments at a time into
+        // per-lane sums, so the compiler can vectorize the loop without reordering additions
+        XTURB_FORCE_INLINE void tileRange(const TileInput& in, size_t firstTarget, size_t lastTarget, size_t firstGroup,
+            size_t lastGroup) {
+            for (size_t t = firstTarget; t < lastTarget; ++t) {
+                const double x = in.tx[t], y = in.ty[t], z = in.tz[t];
+                for (size_t g = firstGroup; g < lastGroup; ++g) {
+                    double su[W] = {}, sv[W] = {}, sw[W] = {};
+                    auto add = [&](size_t i, size_t l) XTURB_LAMBDA_INLINE {
+                        double cx, cy, cz;
+                        double factor = BiotSavart::segmentFactor(x - in.x1[i], y - in.y1[i], z - in.z1[i], x - in.x2[i],
+                            y - in.y2[i], z - in.z2[i], in.core4[i], cx, cy, cz);
+                        su[l] += factor * cx;
+                        sv[l] += factor * cy;
+                        sw[l] += factor * cz;
+                    };
+                    size_t i = in.groups[g];
+                    const size_t end = in.groups[g + 1];
+                    for (; i + W <= end; i += W) {
+                        for (size_t l = 0; l < W; ++l) add(i + l, l);
+                    }
+                    for (; i < end; ++i) add(i, 0);
+                    double u = 0.0, v = 0.0, w = 0.0;
+                    for (size_t l = 0; l < W; ++l) {
+                        u += su[l];
+                        v += sv[l];
+                        w += sw[l];
+                    }
+                    in.u[t * in.columns + g] = u;
+                    in.v[t * in.columns + g] = v;
+                    in.w[t * in.columns + g] = w;
+                }
+            }
+        }
+    }
+}
\ No newline at end of file
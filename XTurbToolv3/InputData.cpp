@@ -1,6 +1,92 @@
 #include "InputData.h"
 #include "HelperFunctions.h"
+#include <cwchar>
+#include <cwctype>
+#include <filesystem>
 #include <fstream>
+#include <map>
+#include <sstream>
+
+namespace {
+    const std::map<std::wstring, double InputData::*>& doubleFields() {
+        static const std::map<std::wstring, double InputData::*> fields = {
+            { L"ROOT", &InputData::ROOT }, { L"BTSR", &InputData::BTSR }, { L"ETSR", &InputData::ETSR },
+            { L"BPITCH", &InputData::BPITCH }, { L"EPITCH", &InputData::EPITCH }, { L"BRADIUS", &InputData::BRADIUS },
+            { L"RHOAIR", &InputData::RHOAIR }, { L"MUAIR", &InputData::MUAIR }, { L"AVISC", &InputData::AVISC },
+            { L"DX0", &InputData::DX0 }, { L"XSTR", &InputData::XSTR }, { L"XTREFFTZ", &InputData::XTREFFTZ },
+            { L"OMRELAX", &InputData::OMRELAX }, { L"LN", &InputData::LN }, { L"HN", &InputData::HN }, { L"XN", &InputData::XN },
+            { L"AXRELAX", &InputData::AXRELAX }, { L"ATRELAX", &InputData::ATRELAX },
+        };
+        return fields;
+    }
+
+    const std::map<std::wstring, int InputData::*>& intFields() {
+        static const std::map<std::wstring, int InputData::*> fields = {
+            { L"BN", &InputData::BN }, { L"NTAPER", &InputData::NTAPER }, { L"NTWIST", &InputData::NTWIST }, { L"NAIRF", &InputData::NAIRF },
+            { L"BLENDAIRF", &InputData::BLENDAIRF }, { L"PERCENTR", &InputData::PERCENTR }, { L"STALLDELAY", &InputData::STALLDELAY },
+            { L"VITERNA", &InputData::VITERNA }, { L"NSWEEP", &InputData::NSWEEP }, { L"NDIHED", &InputData::NDIHED },
+            { L"NTWAX", &InputData::NTWAX }, { L"NPIAX", &InputData::NPIAX }, { L"CHECK", &InputData::CHECK }, { L"DESIGN", &InputData::DESIGN },
+            { L"NTSR", &InputData::NTSR }, { L"NPITCH", &InputData::NPITCH }, { L"ANALYSIS", &InputData::ANALYSIS }, { L"NANA", &InputData::NANA },
+            { L"PREDICTION", &InputData::PREDICTION }, { L"NPRE", &InputData::NPRE }, { L"METHOD", &InputData::METHOD }, { L"JX", &InputData::JX },
+            { L"COSDISTR", &InputData::COSDISTR }, { L"GNUPLOT", &InputData::GNUPLOT }, { L"WAKEEXP", &InputData::WAKEEXP },
+            { L"NSEC", &InputData::NSEC }, { L"IB", &InputData::IB }, { L"DIP", &InputData::DIP }, { L"NACMOD", &InputData::NACMOD },
+            { L"RLOSS", &InputData::RLOSS }, { L"TLOSS", &InputData::tipLoss }, { L"TIPLOSS", &InputData::tipLoss }, { L"OPTIM", &InputData::OPTIM },
+        };
+        return fields;
+    }
+
+    const std::map<std::wstring, std::vector<double> InputData::*>& arrayFields() {
+        static const std::map<std::wstring, std::vector<double> InputData::*> fields = {
+            { L"RTAPER", &InputData::RTAPER }, { L"CTAPER", &InputData::CTAPER }, { L"RTWIST", &InputData::RTWIST },
+            { L"DTWIST", &InputData::DTWIST }, { L"RAIRF", &InputData::RAIRF }, { L"RSWEEP", &InputData::RSWEEP },
+            { L"LSWEEP", &InputData::LSWEEP }, { L"RDIHED", &InputData::RDIHED }, { L"LDIHED", &InputData::LDIHED },
+            { L"RTWAX", &InputData::RTWAX }, { L"LTWAX", &InputData::LTWAX }, { L"RPIAX", &InputData::RPIAX },
+            { L"LPIAX", &InputData::LPIAX }, { L"TSRANA", &InputData::TSRANA }, { L"PITCHANA", &InputData::PITCHANA },
+            { L"VWIND", &InputData::VWIND }, { L"RPMPRE", &InputData::RPMPRE }, { L"PITCHPRE", &InputData::PITCHPRE },
+        };
+        return fields;
+    }
+
+    // Splits .inp text into section markers (&BLADE), names followed by '=', quoted strings (quotes kept) and bare values
+    std::vector<std::wstring> namelistTokens(const std::wstring& text) {
+        std::vector<std::wstring> tokens;
+        size_t i = 0;
+        while (i < text.size()) {
+            wchar_t c = text[i];
+            if (c == L' ' || c == L'\t' || c == L'\r' || c == L'\n' || c == L',' || c == 0xFEFF) {
+                ++i;
+            }
+            else if (c == L'=') {
+                tokens.push_back(L"=");
+                ++i;
+            }
+            else if (c == L'\'') {
+                size_t end = text.find(L'\'', i + 1);
+                if (end == std::wstring::npos) end = text.size();
+                tokens.push_back(text.substr(i, end - i + 1));
+                i = end + 1;
+            }
+            else {
+                size_t end = text.find_first_of(L" \t\r\n,=", i);
+                if (end == std::wstring::npos) end = text.size();
+                tokens.push_back(text.substr(i, end - i));
+                i = end;
+            }
+        }
+        return tokens;
+    }
+
+    bool parseValue(const std::wstring& text, double& value) {
+        wchar_t* end = nullptr;
+        value = std::wcstod(text.c_str(), &end);
+        return end != text.c_str() && *end == L'\0';
+    }
+
+    std::wstring unquote(const std::wstring& text) {
+        if (text.size() >= 2 && text.front() == L'\'' && text.back() == L'\'') return text.substr(1, text.size() - 2);
+        return text;
+    }
+}
 
 // Constructor: Set default values
 InputData::InputData()
@@ -37,11 +123,85 @@ InputData::InputData()
 
 // Write the data to a .inp file
 void InputData::writeToFile(const std::wstring& filename) const {
-    std::ofstream file(wstring_to_string(filename), std::ios::out | std::ios::trunc | std::ios::binary);
+    std::ofstream file(std::filesystem::path{filename}, std::ios::out | std::ios::trunc | std::ios::binary);
     if (!file.is_open()) {
         return;
     }
+    write(file);
+    file.close();
+}
 
+bool InputData::readFromFile(const std::wstring& filename) {
+    std::ifstream file(std::filesystem::path{filename}, std::ios::in | std::ios::binary);
+    return file.is_open() && read(file);
+}
+
+bool InputData::read(std::istream& file) {
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::vector<std::wstring> tokens = namelistTokens(string_to_wstring(bytes));
+    for (size_t i = 0; i < tokens.size();) {
+        if (i + 1 >= tokens.size() || tokens[i + 1] != L"=") {
+            ++i; // Section markers and stray tokens
+            continue;
+        }
+        std::wstring key = tokens[i];
+        for (wchar_t& c : key) c = static_cast<wchar_t>(std::towupper(c));
+        std::vector<std::wstring> values;
+        for (i += 2; i < tokens.size() && tokens[i][0] != L'&' && !(i + 1 < tokens.size() && tokens[i + 1] == L"="); ++i) {
+            values.push_back(tokens[i]);
+        }
+
+        if (key == L"NAME" || key == L"AIRFDATA") {
+            std::vector<std::wstring> texts;
+            for (const auto& value : values) texts.push_back(unquote(value));
+            if (key == L"AIRFDATA") AIRFDATA = texts;
+            else name = texts.empty() ? std::wstring() : texts.front();
+            continue;
+        }
+        std::vector<double> numbers(values.size());
+        for (size_t k = 0; k < values.size(); ++k) {
+            if (!parseValue(values[k], numbers[k])) return false;
+        }
+        if (std::vector<double> InputData::* field = arrayField(key)) {
+            this->*field = numbers;
+        }
+        else if (numbers.size() != 1 && (doubleField(key) || intField(key))) {
+            return false;
+        }
+        else if (double InputData::* field = doubleField(key)) {
+            this->*field = numbers.front();
+        }
+        else if (int InputData::* field = intField(key)) {
+            this->*field = static_cast<int>(numbers.front());
+        }
+    }
+    return true;
+}
+
+double InputData::* InputData::doubleField(const std::wstring& name) {
+    auto it = doubleFields().find(name);
+    return it != doubleFields().end() ? it->second : nullptr;
+}
+
+int InputData::* InputData::intField(const std::wstring& name) {
+    auto it = intFields().find(name);
+    return it != intFields().end() ? it->second : nullptr;
+}
+
+std::vector<double> InputData::* InputData::arrayField(const std::wstring& name) {
+    auto it = arrayFields().find(name);
+    return it != arrayFields().end() ? it->second : nullptr;
+}
+
+// The exact .inp text the solver reads. Inputs that serialize the same are the same run, which is what ResultCache keys on.
+std::string InputData::serialize() const {
+    std::ostringstream text(std::ios::out | std::ios::binary);
+    write(text);
+    return text.str();
+}
+
+// Writes the namelist sections in .inp format
+void InputData::write(std::ostream& file) const {
     // Write BOM for UTF-8
     //const unsigned char bom[] = { 0xEF, 0xBB, 0xBF };
     //file.write(reinterpret_cast<const char*>(bom), sizeof(bom));
@@ -273,6 +433,4 @@ void InputData::writeToFile(const std::wstring& filename) const {
     file << "&OPTI\r\n";
     file << "  OPTIM      = " << OPTIM << ",\r\n";
     file << "&END\r\n";
-
-    file.close();
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <istream>
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -59,7 +61,7 @@ struct InputData {
     std::vector<double> PITCHPRE;
 
     // &SOLVER section
-    int METHOD;
+    int METHOD;             // METHOD_HVM or METHOD_BEMT
     int JX;
     int COSDISTR;
     int GNUPLOT;
@@ -88,7 +90,21 @@ struct InputData {
     // &OPTI section
     int OPTIM;
 
+    static constexpr int METHOD_HVM = 1;  // Prescribed wake vortex method
+    static constexpr int METHOD_BEMT = 2; // Blade element momentum theory
+
 	// Helper functions
     InputData();
     void writeToFile(const std::wstring& filename) const;
+    std::string serialize() const;
+    void write(std::ostream& file) const;
+    // Reads .inp text as write() produces it (namelist sections, KEY = value lists). Keys that are missing keep their current
+    // value, unknown keys are skipped. Returns false if a value cannot be read.
+    bool read(std::istream& file);
+    bool readFromFile(const std::wstring& filename);
+
+    // Numeric fields by their .inp name, e.g. L"BPITCH" or L"TLOSS"; nullptr for other names
+    static double InputData::* doubleField(const std::wstring& name);
+    static int InputData::* intField(const std::wstring& name);
+    static std::vector<double> InputData::* arrayField(const std::wstring& name);
 };
\ No newline at end of file
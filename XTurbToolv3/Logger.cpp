@@ -1,7 +1,28 @@
 #include "Logger.h"
+#ifndef _WIN32
+#include "HelperFunctions.h"
+#include <cstdio>
+#endif
+
+namespace {
+    // Visual Studio debug window on Windows; headless builds have none, so they log to stderr and keep stdout free for results
+    void writeDebugOutput(const std::wstring& text) {
+#ifdef _WIN32
+        OutputDebugStringW(text.c_str());
+#else
+        std::fputs(wstring_to_string(text).c_str(), stderr); // As UTF-8 bytes: a wide write would lock stderr to wide output
+#endif
+    }
+}
 
 // Log an error message to the debug output
 void Logger::logError(const std::wstring& message) {
-    OutputDebugStringW((message + L"\n").c_str()); // Output to Visual Studio debug window
+    writeDebugOutput(message + L"\n"); // Output to Visual Studio debug window
     // In a production app, you could also write to a file here
+}
+
+// Log a message with its level tag. Callers normally go through the LOG_* macros, which filter at compile time.
+void Logger::log(LogLevel level, const std::wstring& message) {
+    static const wchar_t* const tags[] = { L"[TRACE] ", L"[DEBUG] ", L"[INFO] ", L"[ERROR] " };
+    writeDebugOutput(tags[static_cast<int>(level)] + message + L"\n");
 }
\ No newline at end of file
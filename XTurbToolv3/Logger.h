@@ -1,9 +1,35 @@
 #pragma once
+#ifdef _WIN32
 #include "header.h" 
+#endif
 #include <string> 
 
+// Severity of a log message. Messages below XTURB_LOG_LEVEL are removed at compile time by the LOG_* macros.
+enum class LogLevel { Trace = 0, Debug = 1, Info = 2, Error = 3 };
+
+// Compile-time log threshold. Debug builds keep everything, release builds drop trace and debug output entirely.
+// Can be overridden from the project settings, e.g. XTURB_LOG_LEVEL=0 to get parser tracing in a release build.
+#ifndef XTURB_LOG_LEVEL
+#ifdef NDEBUG
+#define XTURB_LOG_LEVEL 2
+#else
+#define XTURB_LOG_LEVEL 0
+#endif
+#endif
+
 // Log error messages. Use this throughout the app to log errors
 class Logger {
 public:
     static void logError(const std::wstring& message);
-};
\ No newline at end of file
+    static void log(LogLevel level, const std::wstring& message);
+    static constexpr bool isEnabled(LogLevel level) { return static_cast<int>(level) >= XTURB_LOG_LEVEL; }
+};
+
+// Leveled logging. The message expression is only evaluated when the level is enabled, so disabled levels
+// cost nothing, not even the construction of the temporary strings. Use these in hot loops instead of Logger::logError.
+#define XTURB_LOG(level, message) \
+    do { if constexpr (Logger::isEnabled(level)) { Logger::log(level, message); } } while (0)
+#define LOG_TRACE(message) XTURB_LOG(LogLevel::Trace, message)
+#define LOG_DEBUG(message) XTURB_LOG(LogLevel::Debug, message)
+#define LOG_INFO(message) XTURB_LOG(LogLevel::Info, message)
+#define LOG_ERROR(message) XTURB_LOG(LogLevel::Error, message)
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "MappedFile.h"
+#ifdef _WIN32
+#include "header.h"
+#else
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+// Opens the file and maps it read-only. Empty files are reported as open with an empty view, since Windows refuses to map zero bytes.
+MappedFile::MappedFile(const std::wstring& filePath)
+    : data(nullptr), size(0), opened(false), fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr) {
+    HANDLE file = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        return;
+    }
+    if (fileSize.QuadPart == 0) {
+        opened = true;
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        return;
+    }
+    mappingHandle = mapping;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        return;
+    }
+    data = static_cast<const char*>(view);
+    size = static_cast<size_t>(fileSize.QuadPart);
+    opened = true;
+}
+
+// Unmaps the view and closes both handles
+MappedFile::~MappedFile() {
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+}
+#else
+// POSIX variant of the mapping, so the parsers also work in the headless builds
+MappedFile::MappedFile(const std::wstring& filePath)
+    : data(nullptr), size(0), opened(false) {
+    int fd = ::open(std::filesystem::path(filePath).string().c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return;
+    }
+    if (st.st_size == 0) {
+        ::close(fd);
+        opened = true;
+        return;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps its own reference to the file
+    if (view == MAP_FAILED) {
+        return;
+    }
+    madvise(view, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+    data = static_cast<const char*>(view);
+    size = static_cast<size_t>(st.st_size);
+    opened = true;
+}
+
+MappedFile::~MappedFile() {
+    if (data) munmap(const_cast<char*>(data), size);
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+// Read-only memory mapping of a whole file. Used by the parsers to tokenize output files in place instead of copying them line by line.
+// The view returned by view() stays valid for the lifetime of the MappedFile object.
+class MappedFile {
+public:
+    explicit MappedFile(const std::wstring& filePath);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return opened; }
+    std::string_view view() const { return std::string_view(data, size); }
+
+private:
+    const char* data;
+    size_t size;
+    bool opened;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+};
\ No newline at end of file
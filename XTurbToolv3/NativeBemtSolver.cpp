@@ -0,0 +1,483 @@
+#include "NativeBemtSolver.h"
+#include "BEMTOutputParser.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <map>
+
+namespace {
+    constexpr double pi = 3.14159265358979323846;
+    constexpr double degree = pi / 180.0;
+
+    // Linear interpolation in ascending x, held constant outside
+    double interpolate(const std::vector<double>& x, const std::vector<double>& y, double at) {
+        size_t count = std::min(x.size(), y.size());
+        if (count == 0) return 0.0;
+        if (count == 1 || at <= x[0]) return y[0];
+        if (at >= x[count - 1]) return y[count - 1];
+        size_t upper = std::upper_bound(x.begin(), x.begin() + count, at) - x.begin();
+        double t = (at - x[upper - 1]) / (x[upper] - x[upper - 1]);
+        return y[upper - 1] + t * (y[upper] - y[upper - 1]);
+    }
+
+    // Prandtl loss factor for the distance (in R) to the tip or the root
+    double prandtl(int blades, double distance, double r, double sinPhi) {
+        double f = 0.5 * blades * distance / (r * sinPhi);
+        return 2.0 / pi * std::acos(std::exp(-std::max(f, 0.0)));
+    }
+
+    OutputData::Table makeTable(const std::vector<std::wstring>& headers) {
+        OutputData::Table table;
+        table.headers = headers;
+        table.columns.resize(headers.size());
+        return table;
+    }
+
+    const std::vector<std::wstring>& stationHeaders() {
+        static const std::vector<std::wstring> headers = { L"r/R", L"c/R", L"Twist", L"Alpha", L"Phi", L"a", L"a'", L"F", L"Cl", L"Cd", L"dCT/dr", L"dCP/dr" };
+        return headers;
+    }
+
+    // Tables are paired by kind (first header) and position within that kind
+    std::map<std::wstring, std::vector<const OutputData::Table*>> tablesByKind(const OutputData& data) {
+        std::map<std::wstring, std::vector<const OutputData::Table*>> kinds;
+        for (const auto& table : data.tables) {
+            if (!table.headers.empty()) kinds[table.headers[0]].push_back(&table);
+        }
+        return kinds;
+    }
+}
+
+double NativeValidation::maxRelative() const {
+    double worst = 0.0;
+    for (const auto& column : columns) worst = std::max(worst, column.maxRelative);
+    return worst;
+}
+
+std::wstring NativeValidation::summary() const {
+    std::wstring text = std::to_wstring(columns.size()) + L" columns compared";
+    auto worst = std::max_element(columns.begin(), columns.end(), [](const ColumnDiff& a, const ColumnDiff& b) { return a.maxRelative < b.maxRelative; });
+    if (worst != columns.end()) {
+        text += L", largest deviation " + std::to_wstring(worst->maxRelative * 100.0) + L" % (" + std::to_wstring(worst->maxAbsolute) + L") in "
+            + worst->file + L" table " + std::to_wstring(worst->table + 1) + L" column " + worst->column;
+    }
+    if (!unmatched.empty()) {
+        text += L", " + std::to_wstring(unmatched.size()) + L" unmatched (first: " + unmatched.front() + L")";
+    }
+    return text;
+}
+
+NativeBemtSolver::NativeBemtSolver(const InputData& input, const std::wstring& polarDirectory) : input(input) {
+    polars = PolarLibrary::spanwise(input, polarDirectory, error);
+    if (polars) {
+        prepare();
+    }
+}
+
+NativeBemtSolver::NativeBemtSolver(const InputData& input, const std::vector<AirfoilPolar>& polars) : input(input) {
+    if (polars.empty() || polars.size() > input.RAIRF.size()) {
+        error = L"Expected one polar per RAIRF station";
+        return;
+    }
+    std::vector<AirfoilPolar> corrected;
+    std::vector<const AirfoilPolar*> stationPolars;
+    for (size_t i = 0; i < polars.size(); ++i) {
+        PolarCorrection correction = PolarCorrection::forStation(input, i);
+        corrected.push_back(correction.any() ? correction.apply(polars[i]) : polars[i]);
+    }
+    for (const auto& polar : corrected) stationPolars.push_back(&polar);
+    this->polars = std::make_shared<const SpanwisePolars>(input, stationPolars);
+    prepare();
+}
+
+// JX blade elements between ROOT and the tip, cosine spaced (finer at both ends) with COSDISTR; the stations are the element centres.
+// The iteration settings come from the &BEMT section; relaxation factors outside (0, 1] mean no relaxation.
+void NativeBemtSolver::prepare() {
+    const int elements = std::max(input.JX, 1);
+    const double root = std::clamp(input.ROOT, 0.0, 0.99);
+    std::vector<double> edges(elements + 1);
+    for (int k = 0; k <= elements; ++k) {
+        double s = static_cast<double>(k) / elements;
+        if (input.COSDISTR) s = 0.5 * (1.0 - std::cos(pi * s));
+        edges[k] = root + (1.0 - root) * s;
+    }
+    stations.clear();
+    for (int k = 0; k < elements; ++k) {
+        Station station;
+        station.r = 0.5 * (edges[k] + edges[k + 1]);
+        station.dr = edges[k + 1] - edges[k];
+        station.chord = interpolate(input.RTAPER, input.CTAPER, station.r);
+        station.twist = interpolate(input.RTWIST, input.DTWIST, station.r);
+        station.solidity = input.BN * station.chord / (2.0 * pi * station.r);
+        station.airfoil = polars->at(station.r);
+        stations.push_back(station);
+    }
+
+    // The kernel gets the station tables as they are plus one blended table for every station inside a blending band
+    std::vector<PolarTable> tables = polars->getTables();
+    for (auto& station : stations) {
+        if (station.airfoil.lower == station.airfoil.upper) {
+            station.table = station.airfoil.lower;
+        }
+        else {
+            station.table = static_cast<uint32_t>(tables.size());
+            tables.push_back(polars->blended(station.airfoil));
+        }
+    }
+
+    settings.blades = input.BN;
+    settings.root = root;
+    settings.tipLoss = input.tipLoss != 0;
+    settings.rootLoss = input.RLOSS != 0;
+    settings.axialRelax = input.AXRELAX > 0.0 ? std::min(input.AXRELAX, 1.0) : 1.0;
+    settings.tangentialRelax = input.ATRELAX > 0.0 ? std::min(input.ATRELAX, 1.0) : 1.0;
+    kernel = std::make_unique<BemtBatchKernel>(settings, tables);
+}
+
+// Fixed-point iteration on the induction factors. The new values are blended in with the relaxation factors, which is what keeps
+// the iteration from oscillating near stall.
+NativeBemtSolver::StationResult NativeBemtSolver::solveStation(const Station& station, double tsr, double pitchDeg) const {
+    const double localSpeed = tsr * station.r;
+
+    StationResult result;
+    double a = 0.0, ap = 0.0;
+    for (result.iterations = 1; result.iterations <= settings.maxIterations; ++result.iterations) {
+        double phi = std::atan2(1.0 - a, localSpeed * (1.0 + ap));
+        double sinPhi = std::max(std::abs(std::sin(phi)), 1e-6);
+        double cosPhi = std::copysign(std::max(std::abs(std::cos(phi)), 1e-6), std::cos(phi));
+        double alpha = phi / degree - station.twist - pitchDeg;
+        double cl, cd;
+        polars->lookup(station.airfoil, alpha, cl, cd);
+        double cn = cl * cosPhi + cd * std::sin(phi);
+        double ct = cl * std::sin(phi) - cd * cosPhi;
+
+        double F = 1.0;
+        if (settings.tipLoss) F *= prandtl(settings.blades, 1.0 - station.r, station.r, sinPhi);
+        if (settings.rootLoss) F *= prandtl(settings.blades, station.r - settings.root, station.r, sinPhi);
+        F = std::max(F, 1e-4);
+
+        double k = station.solidity * cn / (4.0 * F * sinPhi * sinPhi);
+        double aNew = k / (1.0 + k);
+        if (aNew > 0.4) {
+            // Buhl's empirical relation for the turbulent wake state, continuous with momentum theory at a = 0.4
+            double thrust = station.solidity * (1.0 - a) * (1.0 - a) * cn / (sinPhi * sinPhi);
+            double discriminant = std::max(thrust * (50.0 - 36.0 * F) + 12.0 * F * (3.0 * F - 4.0), 0.0);
+            aNew = (18.0 * F - 20.0 - 3.0 * std::sqrt(discriminant)) / (36.0 * F - 50.0);
+        }
+        double kp = station.solidity * ct / (4.0 * F * sinPhi * cosPhi);
+        // kp / (1 - kp) has a pole at kp = 1, which small loss factors near the root reach; past it the induction is bounded
+        double apNew = kp < 1.0 - 1e-3 ? std::clamp(kp / (1.0 - kp), -settings.maxTangentialInduction, settings.maxTangentialInduction)
+            : settings.maxTangentialInduction;
+
+        result.phi = phi / degree;
+        result.alpha = alpha;
+        result.F = F;
+        result.cl = cl;
+        result.cd = cd;
+        double da = aNew - a, dap = apNew - ap;
+        a += settings.axialRelax * da;
+        ap += settings.tangentialRelax * dap;
+        if (std::abs(da) < settings.tolerance && std::abs(dap) < settings.tolerance) {
+            result.converged = true;
+            break;
+        }
+    }
+    result.iterations = std::min(result.iterations, settings.maxIterations);
+    result.a = a;
+    result.ap = ap;
+
+    // Blade element loads with the final induction, per unit r/R and normalised with 1/2 rho V^2 pi R^2
+    double phi = result.phi * degree;
+    double w2 = (1.0 - a) * (1.0 - a) + localSpeed * localSpeed * (1.0 + ap) * (1.0 + ap);
+    double cn = result.cl * std::cos(phi) + result.cd * std::sin(phi);
+    double ct = result.cl * std::sin(phi) - result.cd * std::cos(phi);
+    double load = w2 * settings.blades * station.chord / pi;
+    result.dCT = load * cn;
+    result.dCP = load * ct * station.r * tsr;
+    return result;
+}
+
+NativeBemtSolver::OperatingPoint NativeBemtSolver::evaluate(double tsr, double pitchDeg) const {
+    OperatingPoint point;
+    point.tsr = tsr;
+    point.pitch = pitchDeg;
+    point.stations.reserve(stations.size());
+    for (const auto& station : stations) {
+        StationResult result = solveStation(station, tsr, pitchDeg);
+        point.CT += result.dCT * station.dr;
+        point.CP += result.dCP * station.dr;
+        point.iterations += result.iterations;
+        point.converged = point.converged && result.converged;
+        point.stations.push_back(result);
+    }
+    point.CQ = tsr > 0.0 ? point.CP / tsr : 0.0;
+    return point;
+}
+
+std::vector<NativeBemtSolver::OperatingPoint> NativeBemtSolver::evaluateGrid(const std::vector<std::pair<double, double>>& points) const {
+    std::vector<OperatingPoint> results(points.size());
+    if (!continuation || points.size() < 2) {
+        std::vector<ContinuationPath::Step> steps(points.size());
+        for (size_t p = 0; p < points.size(); ++p) steps[p].point = p;
+        solveBatch(points, steps, results);
+        return results;
+    }
+    for (const auto& stage : ContinuationPath(points).refinement(coldSpacing)) solveBatch(points, stage, results);
+    logContinuationSaving(L"BEMT", points, results, [this](const std::vector<std::pair<double, double>>& sample) {
+        std::vector<OperatingPoint> cold(sample.size());
+        std::vector<ContinuationPath::Step> steps(sample.size());
+        for (size_t p = 0; p < sample.size(); ++p) steps[p].point = p;
+        solveBatch(sample, steps, cold);
+        return cold;
+    });
+    return results;
+}
+
+void NativeBemtSolver::logContinuationSaving(const std::wstring& method, const std::vector<std::pair<double, double>>& points,
+    const std::vector<OperatingPoint>& results, const GridEvaluator& coldEvaluate) {
+    if constexpr (Logger::isEnabled(LogLevel::Info)) {
+        std::vector<size_t> warm;
+        for (size_t p = 0; p < results.size(); ++p) {
+            if (results[p].warmStarted) warm.push_back(p);
+        }
+        if (warm.empty()) {
+            return;
+        }
+        // Spread over the warm-started points, so the sample covers the whole path
+        std::vector<std::pair<double, double>> sample;
+        unsigned warmIterations = 0;
+        const size_t count = std::clamp<size_t>(warm.size() / savingSpacing, 1, savingSample);
+        for (size_t i = 0; i < count; ++i) {
+            size_t p = warm[i * warm.size() / count];
+            sample.push_back(points[p]);
+            warmIterations += results[p].iterations;
+        }
+        unsigned coldIterations = 0;
+        for (const auto& point : coldEvaluate(sample)) coldIterations += point.iterations;
+        std::wstring saving = coldIterations > 0
+            ? std::to_wstring(static_cast<int>(std::lround(100.0 * (1.0 - static_cast<double>(warmIterations) / coldIterations)))) + L"%"
+            : L"n/a";
+        LOG_INFO(L"Native " + method + L": " + std::to_wstring(warm.size()) + L" of " + std::to_wstring(points.size())
+            + L" operating points started from a neighbour's solution; " + std::to_wstring(count) + L" of them took "
+            + std::to_wstring(warmIterations) + L" iterations, " + std::to_wstring(coldIterations) + L" when solved again from cold (saving "
+            + saving + L")");
+    }
+}
+
+// The steps' points in one kernel call, each station's induction starting from the same station of the seed point if that converged.
+// Where a station has two converged inductions (negatively loaded root stations far above the design tip speed ratio) a warm start
+// stays with the neighbour's, which is not always the one a cold start finds.
+void NativeBemtSolver::solveBatch(const std::vector<std::pair<double, double>>& points, const std::vector<ContinuationPath::Step>& steps,
+    std::vector<OperatingPoint>& results) const {
+    const size_t count = stations.size();
+    BemtLanes lanes;
+    lanes.resize(steps.size() * count);
+    for (size_t s = 0; s < steps.size(); ++s) {
+        const auto& point = points[steps[s].point];
+        for (size_t k = 0; k < count; ++k) {
+            size_t lane = s * count + k;
+            lanes.r[lane] = stations[k].r;
+            lanes.chord[lane] = stations[k].chord;
+            lanes.solidity[lane] = stations[k].solidity;
+            lanes.pitchedTwist[lane] = stations[k].twist + point.second;
+            lanes.tsr[lane] = point.first;
+            lanes.airfoil[lane] = stations[k].table;
+            const StationResult* seed = steps[s].seed != ContinuationPath::none ? &results[steps[s].seed].stations[k] : nullptr;
+            if (seed && seed->converged) {
+                lanes.a[lane] = seed->a;
+                lanes.ap[lane] = seed->ap;
+            }
+        }
+    }
+    kernel->solve(lanes);
+
+    for (size_t s = 0; s < steps.size(); ++s) {
+        OperatingPoint& point = results[steps[s].point];
+        point = OperatingPoint();
+        point.tsr = points[steps[s].point].first;
+        point.pitch = points[steps[s].point].second;
+        point.warmStarted = steps[s].seed != ContinuationPath::none;
+        point.stations.resize(count);
+        for (size_t k = 0; k < count; ++k) {
+            size_t lane = s * count + k;
+            StationResult& result = point.stations[k];
+            result.alpha = lanes.alpha[lane];
+            result.phi = lanes.phi[lane];
+            result.a = lanes.a[lane];
+            result.ap = lanes.ap[lane];
+            result.F = lanes.F[lane];
+            result.cl = lanes.cl[lane];
+            result.cd = lanes.cd[lane];
+            result.dCT = lanes.dCT[lane];
+            result.dCP = lanes.dCP[lane];
+            result.iterations = lanes.iterations[lane];
+            result.converged = lanes.converged[lane] != 0;
+            point.CT += result.dCT * stations[k].dr;
+            point.CP += result.dCP * stations[k].dr;
+            point.iterations += result.iterations;
+            point.converged = point.converged && result.converged;
+        }
+        point.CQ = point.tsr > 0.0 ? point.CP / point.tsr : 0.0;
+    }
+}
+
+// Summary table of the operating points ("Number" table) followed by one "r/R" table per point. Extra columns (dimensional values of
+// PREDICTION) are appended to the summary. Single values give the best point, which is what the sweeps collect as metrics.
+OutputData NativeBemtSolver::operatingTable(const std::wstring& method, const std::vector<OperatingPoint>& points,
+    const std::vector<std::vector<double>>& extra, const std::vector<std::wstring>& extraHeaders) const {
+    OutputData data;
+    std::vector<std::wstring> headers = { L"Number", L"TSR", L"Pitch", L"CP", L"CT", L"CQ" };
+    headers.insert(headers.end(), extraHeaders.begin(), extraHeaders.end());
+    data.tables.push_back(makeTable(headers));
+    size_t best = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+        const OperatingPoint& point = points[i];
+        std::vector<double> row = { static_cast<double>(i + 1), point.tsr, point.pitch, point.CP, point.CT, point.CQ };
+        if (i < extra.size()) row.insert(row.end(), extra[i].begin(), extra[i].end());
+        data.tables[0].addRow(row);
+        if (point.CP > points[best].CP) best = i;
+        if (!point.converged) {
+            LOG_INFO(L"Native " + method + L": operating point " + std::to_wstring(i + 1) + L" (TSR " + std::to_wstring(point.tsr) + L", pitch "
+                + std::to_wstring(point.pitch) + L") did not converge at every station");
+        }
+    }
+    for (const auto& point : points) {
+        OutputData::Table table = makeTable(stationHeaders());
+        for (size_t k = 0; k < stations.size(); ++k) {
+            const Station& station = stations[k];
+            const StationResult& result = point.stations[k];
+            table.addRow({ station.r, station.chord, station.twist + point.pitch, result.alpha, result.phi, result.a, result.ap, result.F,
+                result.cl, result.cd, result.dCT, result.dCP });
+        }
+        data.tables.push_back(std::move(table));
+    }
+    data.singleValues[L"Operating points"] = std::to_wstring(points.size());
+    if (!points.empty()) {
+        data.singleValues[L"CPmax"] = std::to_wstring(points[best].CP);
+        data.singleValues[L"CT at CPmax"] = std::to_wstring(points[best].CT);
+        data.singleValues[L"TSR at CPmax"] = std::to_wstring(points[best].tsr);
+        data.singleValues[L"Pitch at CPmax"] = std::to_wstring(points[best].pitch);
+    }
+    return data;
+}
+
+bool NativeBemtSolver::solve(NamedOutputs& outputs) {
+    return writeOutputs(L"BEMT", [this](const std::vector<std::pair<double, double>>& points) { return evaluateGrid(points); }, outputs);
+}
+
+bool NativeBemtSolver::writeOutputs(const std::wstring& method, const GridEvaluator& evaluate, NamedOutputs& outputs) {
+    outputs.clear();
+    if (!error.empty() || stations.empty()) {
+        if (error.empty()) error = L"No blade stations";
+        Logger::logError(L"Native " + method + L": " + error);
+        return false;
+    }
+
+    OutputData geometry;
+    geometry.singleValues[L"Name"] = input.name;
+    geometry.singleValues[L"Method"] = method;
+    geometry.singleValues[L"Blades"] = std::to_wstring(input.BN);
+    geometry.singleValues[L"Stations"] = std::to_wstring(stations.size());
+    geometry.tables.push_back(makeTable({ L"r/R", L"dr/R", L"c/R", L"Twist", L"Solidity", L"Airfoil" }));
+    // Airfoil is 1-based; inside a blending band it is fractional, 1.25 being a quarter of the way from airfoil 1 to 2
+    for (const auto& station : stations) {
+        double airfoil = station.airfoil.lower + 1.0 + station.airfoil.weight * (static_cast<double>(station.airfoil.upper) - station.airfoil.lower);
+        geometry.tables[0].addRow({ station.r, station.dr, station.chord, station.twist, station.solidity, airfoil });
+    }
+    outputs.emplace_back(L"XTurb_Output.dat", std::move(geometry));
+
+    if (input.DESIGN) {
+        std::vector<std::pair<double, double>> grid;
+        for (int p = 0; p < std::max(input.NPITCH, 1); ++p) {
+            double pitch = input.NPITCH > 1 ? input.BPITCH + (input.EPITCH - input.BPITCH) * p / (input.NPITCH - 1) : input.BPITCH;
+            for (int t = 0; t < std::max(input.NTSR, 1); ++t) {
+                double tsr = input.NTSR > 1 ? input.BTSR + (input.ETSR - input.BTSR) * t / (input.NTSR - 1) : input.BTSR;
+                grid.emplace_back(tsr, pitch);
+            }
+        }
+        outputs.emplace_back(L"XTurb_Output1.dat", operatingTable(method, evaluate(grid), {}, {}));
+    }
+    if (input.ANALYSIS) {
+        std::vector<std::pair<double, double>> grid;
+        for (size_t i = 0; i < std::min(input.TSRANA.size(), input.PITCHANA.size()); ++i) {
+            grid.emplace_back(input.TSRANA[i], input.PITCHANA[i]);
+        }
+        outputs.emplace_back(L"XTurb_Output2.dat", operatingTable(method, evaluate(grid), {}, {}));
+    }
+    if (input.PREDICTION) {
+        // Dimensional: TSR from RPM and wind speed, power and thrust from RHOAIR and BRADIUS
+        std::vector<std::pair<double, double>> grid;
+        size_t count = std::min({ input.VWIND.size(), input.RPMPRE.size(), input.PITCHPRE.size() });
+        for (size_t i = 0; i < count; ++i) {
+            double wind = input.VWIND[i];
+            grid.emplace_back(wind > 0.0 ? input.RPMPRE[i] * 2.0 * pi / 60.0 * input.BRADIUS / wind : 0.0, input.PITCHPRE[i]);
+        }
+        std::vector<OperatingPoint> points = evaluate(grid);
+        std::vector<std::vector<double>> extra;
+        const double area = pi * input.BRADIUS * input.BRADIUS;
+        for (size_t i = 0; i < count; ++i) {
+            double wind = input.VWIND[i];
+            double dynamicPressure = 0.5 * input.RHOAIR * wind * wind;
+            extra.push_back({ wind, input.RPMPRE[i], points[i].CP * dynamicPressure * area * wind / 1000.0, points[i].CT * dynamicPressure * area });
+        }
+        outputs.emplace_back(L"XTurb_Output3.dat", operatingTable(method, points, extra, { L"V", L"RPM", L"P[kW]", L"T[N]" }));
+    }
+    return true;
+}
+
+NativeValidation NativeBemtSolver::validate(const NamedOutputs& outputs, const std::wstring& directory) {
+    NativeValidation validation;
+    for (const auto& [file, native] : outputs) {
+        std::filesystem::path path = std::filesystem::path(directory) / file;
+        OutputData external;
+        BEMTOutputParser parser(path.wstring());
+        parser.setCacheEnabled(false);
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec) || !parser.parse(external)) {
+            validation.unmatched.push_back(file);
+            continue;
+        }
+        auto nativeKinds = tablesByKind(native);
+        auto externalKinds = tablesByKind(external);
+        size_t tableIndex = 0;
+        for (const auto& [kind, nativeTables] : nativeKinds) {
+            const auto& externalTables = externalKinds[kind];
+            for (size_t t = 0; t < nativeTables.size(); ++t, ++tableIndex) {
+                if (t >= externalTables.size()) {
+                    validation.unmatched.push_back(file + L" " + kind + L" table " + std::to_wstring(t + 1));
+                    continue;
+                }
+                const OutputData::Table& mine = *nativeTables[t];
+                const OutputData::Table& theirs = *externalTables[t];
+                for (size_t c = 0; c < mine.headers.size(); ++c) {
+                    auto match = std::find(theirs.headers.begin(), theirs.headers.end(), mine.headers[c]);
+                    if (match == theirs.headers.end()) {
+                        validation.unmatched.push_back(file + L" " + kind + L" table " + std::to_wstring(t + 1) + L" column " + mine.headers[c]);
+                        continue;
+                    }
+                    OutputData::ColumnView reference = theirs.column(match - theirs.headers.begin());
+                    OutputData::ColumnView values = mine.column(c);
+                    NativeValidation::ColumnDiff diff;
+                    diff.file = file;
+                    diff.table = tableIndex;
+                    diff.column = mine.headers[c];
+                    diff.rows = std::min(values.size(), reference.size());
+                    double scale = 0.0;
+                    for (size_t i = 0; i < diff.rows; ++i) {
+                        scale = std::max(scale, std::abs(reference[i]));
+                        diff.maxAbsolute = std::max(diff.maxAbsolute, std::abs(values[i] - reference[i]));
+                    }
+                    diff.maxRelative = diff.maxAbsolute > 0.0 ? diff.maxAbsolute / std::max(scale, std::numeric_limits<double>::min()) : 0.0;
+                    if (values.size() != reference.size()) {
+                        validation.unmatched.push_back(file + L" " + kind + L" table " + std::to_wstring(t + 1) + L" has " + std::to_wstring(values.size())
+                            + L" rows, the solver's " + std::to_wstring(reference.size()));
+                    }
+                    validation.columns.push_back(diff);
+                }
+            }
+        }
+    }
+    return validation;
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+#include "AirfoilPolars.h"
+#include "BemtBatchKernel.h"
+#include "ContinuationPath.h"
+#include "InputData.h"
+#include "OutputData.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Parsed outputs keyed by the file name the external solver would have written (XTurb_Output1.dat, ...)
+using NamedOutputs = std::vector<std::pair<std::wstring, OutputData>>;
+
+// Deviation of the native results from the external solver's output files, column by column
+struct NativeValidation {
+    struct ColumnDiff {
+        std::wstring file;
+        size_t table = 0;
+        std::wstring column;
+        size_t rows = 0;
+        double maxAbsolute = 0.0;
+        double maxRelative = 0.0; // Relative to the column's largest magnitude, so values near zero do not dominate
+    };
+    std::vector<ColumnDiff> columns;
+    std::vector<std::wstring> unmatched; // Files, tables and columns that only one of the two has
+
+    double maxRelative() const;
+    std::wstring summary() const;
+};
+
+// Blade element momentum solver for METHOD_BEMT inputs, run in-process instead of starting the external executable.
+// Per radial station it iterates the axial and tangential induction with Prandtl tip (TLOSS) and root (RLOSS) losses,
+// the Buhl high-induction correction and the relaxation factors AXRELAX / ATRELAX, then integrates thrust and torque.
+// Geometry is interpolated linearly from the &BLADE stations; sweep, dihedral and the HVM settings do not apply to BEMT.
+// VITERNA and STALLDELAY are applied to the polars once, by PolarLibrary (see PolarCorrection).
+// Outputs: XTurb_Output.dat (blade geometry), XTurb_Output1.dat (DESIGN grid), XTurb_Output2.dat (ANALYSIS points) and
+// XTurb_Output3.dat (PREDICTION points), each with a "Number" summary table and one "r/R" table per operating point.
+// The operating points of a run are solved together by BemtBatchKernel; evaluate() is the scalar reference for a single point.
+// With continuation the points are solved in ContinuationPath refinement stages, each point's induction starting from that of a
+// solved neighbour (the Info log compares the iterations with cold solves of a sample of the same points). It is off by default
+// (RunScheduler::setContinuation, XTurbCli --continuation): stations with two induction solutions (typically near the root) can
+// settle on a different one than a cold start finds, which moved CP by up to 0.008 on the benchmark blade.
+class NativeBemtSolver {
+public:
+    static bool supports(const InputData& input) { return input.METHOD == InputData::METHOD_BEMT; }
+
+    // Relative polar paths are resolved against polarDirectory, as the external solver resolves them against its directory.
+    // The tables come from PolarLibrary, so solvers for the same blade share them.
+    NativeBemtSolver(const InputData& input, const std::wstring& polarDirectory);
+    // With polars already in memory, one per RAIRF station; VITERNA and STALLDELAY are applied to them
+    NativeBemtSolver(const InputData& input, const std::vector<AirfoilPolar>& polars);
+
+    bool solve(NamedOutputs& outputs);
+    const std::wstring& getError() const { return error; }
+
+    // Compares outputs with the XTurb_Output*.dat files of the same names in directory
+    static NativeValidation validate(const NamedOutputs& outputs, const std::wstring& directory);
+
+    struct Station {
+        double r = 0.0;      // r/R
+        double dr = 0.0;     // Width of the blade element, in R
+        double chord = 0.0;  // c/R
+        double twist = 0.0;  // Degrees
+        double solidity = 0.0;
+        SpanwisePolars::Blend airfoil; // AIRFDATA entries and their blend at r
+        uint32_t table = 0;  // Index into the batch kernel's tables
+    };
+
+    struct StationResult {
+        double alpha = 0.0, phi = 0.0, a = 0.0, ap = 0.0, F = 1.0, cl = 0.0, cd = 0.0;
+        double dCT = 0.0, dCP = 0.0;
+        unsigned iterations = 0;
+        bool converged = false;
+    };
+
+    struct OperatingPoint {
+        double tsr = 0.0;
+        double pitch = 0.0;   // Degrees
+        double CP = 0.0, CT = 0.0, CQ = 0.0;
+        unsigned iterations = 0; // Summed over the stations
+        bool converged = true;
+        bool warmStarted = false; // Started from the solution of a neighbouring point
+        std::vector<StationResult> stations;
+    };
+
+    // One operating point at the given tip speed ratio and pitch; the stations come from the input
+    OperatingPoint evaluate(double tsr, double pitchDeg) const;
+    // All (tip speed ratio, pitch) points at once, every station of every point a lane of the batch kernel
+    std::vector<OperatingPoint> evaluateGrid(const std::vector<std::pair<double, double>>& points) const;
+    // With continuation every coldSpacing-th point along the path starts cold and the others from a solved neighbour; without it
+    // every point starts cold, all in one batch
+    static constexpr size_t coldSpacing = 8;
+    void setContinuation(bool enabled) { continuation = enabled; }
+    const std::vector<Station>& getStations() const { return stations; }
+    const SpanwisePolars& getPolars() const { return *polars; }
+    bool isValid() const { return error.empty() && !stations.empty(); }
+
+    // The geometry file and the DESIGN / ANALYSIS / PREDICTION files for this blade with any solver for the operating points;
+    // solve() passes evaluateGrid, NativeHvmSolver its own evaluation. method goes into the files and the log messages.
+    using GridEvaluator = std::function<std::vector<OperatingPoint>(const std::vector<std::pair<double, double>>& points)>;
+    bool writeOutputs(const std::wstring& method, const GridEvaluator& evaluate, NamedOutputs& outputs);
+    // Logs how many iterations the warm-started points saved, measured by solving some of them again with coldEvaluate: one in
+    // every savingSpacing, at least one and at most savingSample, so the measurement costs a few percent of the grid.
+    static constexpr size_t savingSample = 4;
+    static constexpr size_t savingSpacing = 16;
+    static void logContinuationSaving(const std::wstring& method, const std::vector<std::pair<double, double>>& points,
+        const std::vector<OperatingPoint>& results, const GridEvaluator& coldEvaluate);
+
+private:
+    void prepare();
+    StationResult solveStation(const Station& station, double tsr, double pitchDeg) const;
+    void solveBatch(const std::vector<std::pair<double, double>>& points, const std::vector<ContinuationPath::Step>& steps,
+        std::vector<OperatingPoint>& results) const;
+    OutputData operatingTable(const std::wstring& method, const std::vector<OperatingPoint>& points,
+        const std::vector<std::vector<double>>& extra, const std::vector<std::wstring>& extraHeaders) const;
+
+    InputData input;
+    std::shared_ptr<const SpanwisePolars> polars;
+    std::vector<Station> stations;
+    BemtBatchKernel::Settings settings;
+    std::unique_ptr<BemtBatchKernel> kernel;
+    bool continuation = false;
+    std::wstring error;
+};
\ No newline at end of file
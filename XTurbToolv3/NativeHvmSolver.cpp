@@ -0,0 +1,328 @@
+#include "NativeHvmSolver.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+    constexpr double pi = 3.14159265358979323846;
+    constexpr double degree = pi / 180.0;
+    constexpr size_t parallelTargets = 64; // Fewer targets are evaluated on the calling thread
+    constexpr double wakeRelax = 0.5;      // The flow speed responds smoothly to the wake; OMRELAX is for the circulation
+
+    // Nodes of the trailing vortex lines: axial position, axial flow speed inside the wake and helix angle, the same for every line
+    struct WakeNodes {
+        std::vector<double> x;
+        std::vector<double> flow;
+        std::vector<double> angle;
+    };
+
+    // DX0 behind the blade, growing geometrically to maxStep at XSTR, then maxStep to the Trefftz plane
+    std::vector<double> axialNodes(const InputData& input, double maxStep) {
+        const double length = input.XTREFFTZ > 0.0 ? input.XTREFFTZ : 1.0;
+        double step = std::clamp(input.DX0, 1e-6, maxStep);
+        double growth = input.XSTR > maxStep && step < maxStep ? (input.XSTR - step) / (input.XSTR - maxStep) : 1.0;
+        std::vector<double> x = { 0.0 };
+        while (x.back() < length) {
+            x.push_back(std::min(x.back() + step, length));
+            step = std::min(step * growth, maxStep);
+        }
+        return x;
+    }
+
+    // The filaments sit on the edge of the wake, so they travel at the mean of the flow inside it and the wind outside
+    void updateAngles(WakeNodes& nodes, double tsr) {
+        nodes.angle.assign(nodes.x.size(), 0.0);
+        for (size_t s = 1; s < nodes.x.size(); ++s) {
+            double speed = 0.5 + 0.25 * (nodes.flow[s - 1] + nodes.flow[s]);
+            nodes.angle[s] = nodes.angle[s - 1] + tsr * (nodes.x[s] - nodes.x[s - 1]) / speed;
+        }
+    }
+}
+
+NativeHvmSolver::NativeHvmSolver(const InputData& input, const std::wstring& polarDirectory) : blade(input, polarDirectory), input(input) {}
+
+NativeHvmSolver::NativeHvmSolver(const InputData& input, const std::vector<AirfoilPolar>& polars) : blade(input, polars), input(input) {}
+
+void NativeHvmSolver::setSettings(const Settings& newSettings) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    if (newSettings.threads != settings.threads) {
+        pool.reset();
+    }
+    settings = newSettings;
+}
+
+// Started by the first evaluation, so the threads are only created once and with the final Settings::threads
+ThreadPool* NativeHvmSolver::threadPool() const {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    if (!pool) {
+        pool = std::make_unique<ThreadPool>(settings.threads);
+    }
+    return pool.get();
+}
+
+// Segments are grouped by the circulation they carry: bound first (element j, blade b at j * BN + b), then the trailing lines
+// (edge k, blade b, step s at JX * BN + (k * BN + b) * steps + s). Bound segments run from root to tip with the element's
+// circulation, trailing segments downstream with the difference of the circulations either side of their edge, so every node
+// conserves circulation.
+NativeBemtSolver::OperatingPoint NativeHvmSolver::evaluate(double tsr, double pitchDeg, Statistics* statistics, const WarmStart* start,
+    WarmStart* solved) const {
+    auto started = std::chrono::steady_clock::now();
+    if (!blade.isValid()) {
+        NativeBemtSolver::OperatingPoint empty;
+        empty.tsr = tsr;
+        empty.pitch = pitchDeg;
+        empty.converged = false;
+        return empty;
+    }
+    const auto& stations = blade.getStations();
+    const size_t elements = stations.size();
+    const size_t blades = static_cast<size_t>(std::max(input.BN, 1));
+    const double omega = input.OMRELAX > 0.0 ? std::min(input.OMRELAX, 1.0) : 1.0;
+
+    // BEMT gives the starting circulation and the mean induction the first wake is laid out with, unless a neighbour's solution does
+    const bool warm = start && start->gamma.size() == elements && start->wakeX.size() > 1 && start->wakeX.size() == start->wakeFlow.size();
+    NativeBemtSolver::OperatingPoint point;
+    if (warm) {
+        point.tsr = tsr;
+        point.pitch = pitchDeg;
+        point.stations.resize(elements);
+        point.warmStarted = true;
+    }
+    else {
+        point = blade.evaluate(tsr, pitchDeg);
+    }
+    std::vector<double> gamma(elements), edges(elements + 1), cores(elements + 1);
+    double induction = 0.0, area = 0.0;
+    edges[0] = stations[0].r - 0.5 * stations[0].dr;
+    for (size_t j = 0; j < elements; ++j) {
+        const auto& station = stations[j];
+        const auto& result = point.stations[j];
+        double axial = 1.0 - result.a, tangential = tsr * station.r * (1.0 + result.ap);
+        gamma[j] = warm ? start->gamma[j] : 0.5 * std::sqrt(axial * axial + tangential * tangential) * station.chord * result.cl;
+        induction += result.a * station.r * station.dr;
+        area += station.r * station.dr;
+        edges[j + 1] = edges[j] + station.dr;
+    }
+    induction = std::clamp(warm ? 1.0 - start->wakeFlow[0] : induction / area, 0.0, 0.45);
+    for (size_t k = 0; k <= elements; ++k) {
+        double width = k == 0 ? stations[0].dr : k == elements ? stations[elements - 1].dr : 0.5 * (stations[k - 1].dr + stations[k].dr);
+        cores[k] = input.AVISC * 0.5 * width;
+    }
+
+    // The first wake has the momentum theory flow, 1 - a at the rotor falling to 1 - 2a far downstream; the filaments of the
+    // slowest part of it advance 2 pi (1 - a) / tsr per revolution
+    const double maxStep = tsr > 0.0 ? std::min(2.0 * pi * (1.0 - induction) / (tsr * std::max(input.NSEC, 4)), 0.5) : 0.5;
+    WakeNodes nodes;
+    nodes.x = axialNodes(input, maxStep);
+    for (double x : nodes.x) {
+        if (!warm) {
+            nodes.flow.push_back(1.0 - induction * (1.0 + x / std::sqrt(1.0 + x * x)));
+            continue;
+        }
+        // The neighbour's wake may have other nodes; its flow speed is interpolated, held constant past its ends
+        size_t upper = std::upper_bound(start->wakeX.begin(), start->wakeX.end(), x) - start->wakeX.begin();
+        upper = std::clamp<size_t>(upper, 1, start->wakeX.size() - 1);
+        double t = std::clamp((x - start->wakeX[upper - 1]) / (start->wakeX[upper] - start->wakeX[upper - 1]), 0.0, 1.0);
+        nodes.flow.push_back(start->wakeFlow[upper - 1] + t * (start->wakeFlow[upper] - start->wakeFlow[upper - 1]));
+    }
+    const size_t steps = nodes.x.size() - 1;
+    const size_t lines = blades * (elements + 1);
+    const size_t boundCount = blades * elements;
+    std::vector<double> strengths(boundCount + lines * steps);
+
+    // Velocities of the lifting line of blade 0, which lies on the y axis; the other blades follow by symmetry
+    std::vector<double> cx(elements, 0.0), cy(elements), cz(elements, 0.0), u(elements), w(elements);
+    for (size_t j = 0; j < elements; ++j) cy[j] = stations[j].r;
+    // The flow speed is relaxed over the first half of the wake; further down the induced velocity falls off towards the
+    // end of the wake at the Trefftz plane, so those nodes keep the speed of the last relaxed one
+    size_t relaxed = 1;
+    while (relaxed < nodes.x.size() && nodes.x[relaxed] <= 0.5 * nodes.x.back()) ++relaxed;
+    std::vector<double> nx, ny, nz, nu, nv, nw, speeds, influenceU(elements * elements), influenceW(elements * elements);
+    std::vector<uint32_t> groupStart;
+    for (size_t j = 0; j < elements; ++j) groupStart.push_back(static_cast<uint32_t>(j * blades));
+    for (size_t k = 0; k <= elements + 1; ++k) groupStart.push_back(static_cast<uint32_t>(boundCount + k * blades * steps));
+
+    Statistics local;
+    VortexTree tree;
+    tree.setAccuracy(settings.accuracy);
+    InfluenceMatrix matrix;
+    std::vector<VortexTree::Segment> segments(strengths.size());
+    bool converged = false, wakeConverged = false;
+    const unsigned maxWakeIterations = std::max(settings.maxWakeIterations, 1u);
+    for (unsigned wakeIteration = 0; wakeIteration < maxWakeIterations; ++wakeIteration) {
+        updateAngles(nodes, tsr);
+        for (size_t b = 0; b < blades; ++b) {
+            double azimuth = 2.0 * pi * b / blades;
+            for (size_t j = 0; j < elements; ++j) {
+                VortexTree::Segment& segment = segments[j * blades + b];
+                segment.x1 = segment.x2 = 0.0;
+                segment.y1 = edges[j] * std::cos(azimuth);
+                segment.z1 = edges[j] * std::sin(azimuth);
+                segment.y2 = edges[j + 1] * std::cos(azimuth);
+                segment.z2 = edges[j + 1] * std::sin(azimuth);
+                segment.core = input.AVISC * 0.5 * stations[j].dr;
+            }
+            for (size_t k = 0; k <= elements; ++k) {
+                size_t first = boundCount + (k * blades + b) * steps;
+                double previous[3] = { 0.0, edges[k] * std::cos(azimuth), edges[k] * std::sin(azimuth) };
+                for (size_t s = 1; s <= steps; ++s) {
+                    double radius = input.WAKEEXP ? edges[k] * std::sqrt(nodes.flow[0] / nodes.flow[s]) : edges[k];
+                    double next[3] = { nodes.x[s], radius * std::cos(azimuth - nodes.angle[s]), radius * std::sin(azimuth - nodes.angle[s]) };
+                    segments[first + s - 1] = { previous[0], previous[1], previous[2], next[0], next[1], next[2], cores[k] };
+                    std::copy(next, next + 3, previous);
+                }
+            }
+        }
+        ++local.wakeBuilds;
+
+        // The wake stays put while the circulation iterates, so the control point velocities are a fixed linear function of it:
+        // bound group j carries gamma j and trailing group k gamma k-1 - gamma k, which folds into one JX by JX matrix per component
+        matrix.assemble(cx.data(), cy.data(), cz.data(), elements, segments, groupStart, threadPool());
+        local.interactions += matrix.getStatistics().interactions;
+        local.assemblySeconds += matrix.getStatistics().seconds;
+        local.steals += matrix.getStatistics().steals;
+        for (size_t i = 0; i < elements; ++i) {
+            const double* rowU = matrix.u(i);
+            const double* rowW = matrix.w(i);
+            for (size_t j = 0; j < elements; ++j) {
+                influenceU[i * elements + j] = rowU[j] - rowU[elements + j] + rowU[elements + j + 1];
+                influenceW[i * elements + j] = rowW[j] - rowW[elements + j] + rowW[elements + j + 1];
+            }
+        }
+
+        // Circulation from the polars at the induced angle of attack, relaxed with OMRELAX. The trailing lines either side of a
+        // small element pass close to its control point, so the plain fixed-point iteration overshoots there; scaling each step by
+        // the slope of circulation against itself (the matrix diagonal, with thin airfoil lift) makes it a Newton step per station.
+        converged = false;
+        for (unsigned iteration = 0; iteration < settings.maxIterations && !converged; ++iteration) {
+            for (size_t i = 0; i < elements; ++i) {
+                double su = 0.0, sw = 0.0;
+                for (size_t j = 0; j < elements; ++j) {
+                    su += influenceU[i * elements + j] * gamma[j];
+                    sw += influenceW[i * elements + j] * gamma[j];
+                }
+                u[i] = su;
+                w[i] = sw;
+            }
+            ++local.iterations;
+
+            double change = 0.0, largest = 1e-6;
+            for (size_t j = 0; j < elements; ++j) {
+                const auto& station = stations[j];
+                auto& result = point.stations[j];
+                // The blade moves towards +z, so the air meets it at 1 + u axially and tsr r - w tangentially
+                double axial = 1.0 + u[j], tangential = tsr * station.r - w[j];
+                double phi = std::atan2(axial, tangential);
+                result.phi = phi / degree;
+                result.alpha = result.phi - station.twist - pitchDeg;
+                blade.getPolars().lookup(station.airfoil, result.alpha, result.cl, result.cd);
+                double speed2 = axial * axial + tangential * tangential;
+                double target = 0.5 * std::sqrt(speed2) * station.chord * result.cl;
+                change = std::max(change, std::abs(target - gamma[j]));
+                largest = std::max(largest, std::abs(target));
+                double slope = pi * station.chord * (tangential * influenceU[j * elements + j] + axial * influenceW[j * elements + j]) /
+                    std::sqrt(speed2);
+                gamma[j] += omega * (target - gamma[j]) / (1.0 - std::min(slope, 0.0));
+
+                result.a = -u[j];
+                result.ap = tsr > 0.0 ? -w[j] / (tsr * station.r) : 0.0;
+                result.F = 1.0;
+                double load = speed2 * input.BN * station.chord / pi;
+                result.dCT = load * (result.cl * std::cos(phi) + result.cd * std::sin(phi));
+                result.dCP = load * (result.cl * std::sin(phi) - result.cd * std::cos(phi)) * station.r * tsr;
+            }
+            converged = change < settings.tolerance * largest;
+        }
+        for (size_t j = 0; j < elements; ++j) {
+            for (size_t b = 0; b < blades; ++b) strengths[j * blades + b] = gamma[j];
+        }
+        for (size_t k = 0; k <= elements; ++k) {
+            double trailing = (k > 0 ? gamma[k - 1] : 0.0) - (k < elements ? gamma[k] : 0.0);
+            std::fill(strengths.begin() + groupStart[elements + k], strengths.begin() + groupStart[elements + k + 1], trailing);
+        }
+        tree.build(segments);
+        tree.setStrengths(strengths);
+
+        // Flow speed: the area-weighted mean axial velocity at the station radii on the helix halfway between two blades,
+        // where the velocity is smooth; on the filaments themselves it is dominated by the nearest lines
+        nx.clear();
+        ny.clear();
+        nz.clear();
+        for (size_t j = 0; j < elements; ++j) {
+            for (size_t s = 0; s < relaxed; ++s) {
+                double radius = input.WAKEEXP ? stations[j].r * std::sqrt(nodes.flow[0] / nodes.flow[s]) : stations[j].r;
+                double azimuth = pi / blades - nodes.angle[s];
+                nx.push_back(nodes.x[s]);
+                ny.push_back(radius * std::cos(azimuth));
+                nz.push_back(radius * std::sin(azimuth));
+            }
+        }
+        nu.assign(nx.size(), 0.0);
+        nv.assign(nx.size(), 0.0);
+        nw.assign(nx.size(), 0.0);
+        local.interactions += tree.evaluate(nx.data(), ny.data(), nz.data(), nx.size(), nu.data(), nv.data(), nw.data(),
+            nx.size() >= parallelTargets ? threadPool() : nullptr);
+        double wakeChange = 0.0;
+        speeds.resize(nodes.x.size());
+        for (size_t s = 0; s < nodes.x.size(); ++s) {
+            size_t at = std::min(s, relaxed - 1);
+            double sum = 0.0;
+            for (size_t j = 0; j < elements; ++j) sum += stations[j].r * stations[j].dr * (1.0 + nu[j * relaxed + at]);
+            speeds[s] = std::clamp(sum / area, 0.1, 1.2);
+            wakeChange = std::max(wakeChange, std::abs(speeds[s] - nodes.flow[s]));
+        }
+        // Checked before the iteration limit, so a wake that settles on the last iteration still counts as converged. The
+        // results were computed in the current wake, so it is not moved once the loop ends.
+        wakeConverged = converged && wakeChange < settings.wakeTolerance;
+        if (wakeConverged || wakeIteration + 1 == maxWakeIterations) break;
+        for (size_t s = 0; s < nodes.x.size(); ++s) nodes.flow[s] += wakeRelax * (speeds[s] - nodes.flow[s]);
+    }
+
+    point.CT = point.CP = 0.0;
+    point.iterations = 0;
+    point.converged = converged && wakeConverged;
+    for (size_t j = 0; j < elements; ++j) {
+        auto& result = point.stations[j];
+        result.iterations = local.iterations;
+        result.converged = point.converged;
+        point.CT += result.dCT * stations[j].dr;
+        point.CP += result.dCP * stations[j].dr;
+        point.iterations += result.iterations;
+    }
+    point.CQ = tsr > 0.0 ? point.CP / tsr : 0.0;
+    if (solved) {
+        solved->gamma = gamma;
+        solved->wakeX = nodes.x;
+        solved->wakeFlow = nodes.flow;
+    }
+
+    if (statistics) {
+        local.segments = segments.size();
+        local.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        *statistics = local;
+    }
+    return point;
+}
+
+std::vector<NativeBemtSolver::OperatingPoint> NativeHvmSolver::evaluateGrid(const std::vector<std::pair<double, double>>& points) const {
+    std::vector<NativeBemtSolver::OperatingPoint> results(points.size());
+    if (!settings.continuation) {
+        for (size_t p = 0; p < points.size(); ++p) results[p] = evaluate(points[p].first, points[p].second);
+        return results;
+    }
+    std::vector<WarmStart> states(points.size());
+    for (const auto& step : ContinuationPath(points).chain()) {
+        const WarmStart* start = step.seed != ContinuationPath::none ? &states[step.seed] : nullptr;
+        results[step.point] = evaluate(points[step.point].first, points[step.point].second, nullptr, start, &states[step.point]);
+    }
+    NativeBemtSolver::logContinuationSaving(L"HVM", points, results, [this](const std::vector<std::pair<double, double>>& sample) {
+        std::vector<NativeBemtSolver::OperatingPoint> cold;
+        for (const auto& point : sample) cold.push_back(evaluate(point.first, point.second));
+        return cold;
+    });
+    return results;
+}
+
+bool NativeHvmSolver::solve(NamedOutputs& outputs) {
+    return blade.writeOutputs(L"HVM", [this](const std::vector<std::pair<double, double>>& points) { return evaluateGrid(points); }, outputs);
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+#include "NativeBemtSolver.h"
+#include "InfluenceMatrix.h"
+#include "ThreadPool.h"
+#include "VortexTree.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Helicoidal vortex method for METHOD_HVM inputs, run in-process instead of starting the external executable.
+// Each blade is a lifting line of JX elements with a trailing vortex line from every element edge, convected downstream along a
+// helix. The circulation is iterated to agree with the polars (relaxed by OMRELAX), then the axial flow speed inside the wake is
+// relaxed towards the induced velocity between the blades' vortex sheets and the wake rebuilt, until both settle. The filaments
+// travel at the mean of that flow and the wind, as they sit on the edge of the wake.
+// The &HVM settings are read as follows: XTREFFTZ is the wake length in R (the Trefftz plane), NSEC the wake segments per
+// revolution, DX0 the first axial step behind the blade, stretched geometrically to the NSEC step over the first XSTR, WAKEEXP
+// lets the wake radius follow the convection speed (continuity) instead of staying cylindrical, and AVISC is the vortex core
+// radius in element widths. IB, DIP, NACMOD and LN / HN / XN (hub and nacelle modelling) are not used.
+// While the circulation iterates the wake is frozen, so the velocities at the lifting line come from an InfluenceMatrix assembled
+// once per wake; the flow speed samples in the wake come from VortexTree, whose cost grows with N log N in the segments.
+// With Settings::continuation, evaluateGrid solves the points one after the other along a ContinuationPath, each starting from the
+// circulation and wake flow of the point before it instead of from BEMT. Off by default, as the warm-started results are not
+// identical to cold ones.
+// The outputs are those of NativeBemtSolver with Method HVM; a is the axial and a' the tangential induction at the lifting line.
+class NativeHvmSolver {
+public:
+    static bool supports(const InputData& input) { return input.METHOD == InputData::METHOD_HVM; }
+
+    // As NativeBemtSolver's constructors; its BEMT solution is the starting point of the circulation
+    NativeHvmSolver(const InputData& input, const std::wstring& polarDirectory);
+    NativeHvmSolver(const InputData& input, const std::vector<AirfoilPolar>& polars);
+
+    struct Settings {
+        double accuracy = 0.3;       // VortexTree opening angle for the wake flow speed; 0 evaluates every segment directly
+        size_t threads = 0;          // For the influence matrix and wake velocities, 0 means one per core
+        double tolerance = 1e-5;     // On the circulation, relative to its largest value
+        unsigned maxIterations = 500; // Circulation iterations per wake
+        unsigned maxWakeIterations = 20;
+        double wakeTolerance = 1e-3;  // On the convection speed, in units of the wind speed
+        bool continuation = false;   // Warm starts in evaluateGrid
+    };
+    // Not while evaluations are running
+    void setSettings(const Settings& newSettings);
+    const Settings& getSettings() const { return settings; }
+
+    struct Statistics {
+        size_t segments = 0;         // Vortex segments of the final wake
+        unsigned iterations = 0;     // Circulation iterations, summed over the wakes
+        unsigned wakeBuilds = 0;
+        size_t interactions = 0;     // Segment and tree node evaluations, see VortexTree::evaluate
+        double assemblySeconds = 0.0; // Spent in InfluenceMatrix::assemble
+        size_t steals = 0;           // Tile ranges taken over between threads during assembly
+        double seconds = 0.0;
+    };
+
+    bool solve(NamedOutputs& outputs);
+    const std::wstring& getError() const { return blade.getError(); }
+
+    // Converged state of a solved point, from which a neighbouring point can start
+    struct WarmStart {
+        std::vector<double> gamma;    // Circulation per element
+        std::vector<double> wakeX;    // Wake nodes and the axial flow speed at them
+        std::vector<double> wakeFlow;
+    };
+    // Starts from start if given (and for the same blade), else from the BEMT solution; solved receives the converged state
+    NativeBemtSolver::OperatingPoint evaluate(double tsr, double pitchDeg, Statistics* statistics = nullptr, const WarmStart* start = nullptr,
+        WarmStart* solved = nullptr) const;
+    std::vector<NativeBemtSolver::OperatingPoint> evaluateGrid(const std::vector<std::pair<double, double>>& points) const;
+    const std::vector<NativeBemtSolver::Station>& getStations() const { return blade.getStations(); }
+
+private:
+    ThreadPool* threadPool() const;
+
+    NativeBemtSolver blade;
+    InputData input;
+    Settings settings;
+    mutable std::mutex poolMutex;
+    mutable std::unique_ptr<ThreadPool> pool;
+};
\ No newline at end of file
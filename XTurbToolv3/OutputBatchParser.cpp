@@ -0,0 +1,105 @@
+#include "OutputBatchParser.h"
+#include "BEMTOutputParser.h"
+#include "Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+
+namespace {
+    // Shared state of one batch. Every file gets its own slot, so the workers never need a lock while parsing.
+    struct Batch {
+        std::vector<std::wstring> files;
+        std::vector<OutputData> outputs;
+        std::vector<char> succeeded;
+        std::atomic<size_t> remaining{ 0 };
+        OutputBatchParser::CompletionHandler onComplete;
+    };
+
+    // Moves the slots into shared snapshots once every file is done. The tables change owner, they are not copied.
+    BatchParseResult collect(Batch& batch) {
+        BatchParseResult result;
+        for (size_t i = 0; i < batch.files.size(); ++i) {
+            if (batch.succeeded[i]) {
+                result.outputs[batch.files[i]] = std::make_shared<const OutputData>(std::move(batch.outputs[i]));
+            }
+            else {
+                result.failedFiles.push_back(batch.files[i]);
+            }
+        }
+        return result;
+    }
+
+    bool isOutputFile(const std::filesystem::path& path) {
+        std::wstring filename = path.filename().wstring();
+        return filename.find(L"XTurb_Output") == 0 && path.extension() == L".dat";
+    }
+}
+
+OutputBatchParser::OutputBatchParser(size_t threadCount) : pool(threadCount) {}
+
+// Same filter as the FileSelectorWindow list. Results are sorted so the batch order is stable.
+std::vector<std::wstring> OutputBatchParser::findOutputFiles(const std::wstring& directory, bool recursive) {
+    std::vector<std::wstring> files;
+    std::error_code ec;
+    if (recursive) {
+        for (auto it = std::filesystem::recursive_directory_iterator(directory, ec); !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+            if (it->is_regular_file() && isOutputFile(it->path())) files.push_back(it->path().wstring());
+        }
+    }
+    else {
+        for (auto it = std::filesystem::directory_iterator(directory, ec); !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+            if (it->is_regular_file() && isOutputFile(it->path())) files.push_back(it->path().wstring());
+        }
+    }
+    if (ec) {
+        Logger::logError(L"Failed to list output files in " + directory);
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+std::future<BatchParseResult> OutputBatchParser::parseFiles(const std::vector<std::wstring>& files) {
+    auto promise = std::make_shared<std::promise<BatchParseResult>>();
+    std::future<BatchParseResult> future = promise->get_future();
+    parseFiles(files, [promise](BatchParseResult&& result) { promise->set_value(std::move(result)); });
+    return future;
+}
+
+std::future<BatchParseResult> OutputBatchParser::parseDirectory(const std::wstring& directory, bool recursive) {
+    return parseFiles(findOutputFiles(directory, recursive));
+}
+
+void OutputBatchParser::cancelPending() {
+    size_t dropped = pool.clearPending();
+    if (dropped > 0) {
+        LOG_INFO(L"Batch parse cancelled, " + std::to_wstring(dropped) + L" queued tasks dropped");
+    }
+}
+
+// Queues one task per file. The task that brings the remaining count to zero assembles the result and calls the handler.
+void OutputBatchParser::parseFiles(const std::vector<std::wstring>& files, CompletionHandler onComplete) {
+    if (files.empty()) {
+        onComplete(BatchParseResult());
+        return;
+    }
+
+    auto batch = std::make_shared<Batch>();
+    batch->files = files;
+    batch->outputs.resize(files.size());
+    batch->succeeded.assign(files.size(), 0);
+    batch->remaining = files.size();
+    batch->onComplete = std::move(onComplete);
+
+    // Large files are additionally split into chunks on the same pool; the parser handles being called from a pool task
+    ThreadPool* workers = &pool;
+    for (size_t i = 0; i < files.size(); ++i) {
+        pool.submit([batch, i, workers]() {
+            BEMTOutputParser parser(batch->files[i], BEMTOutputParser::ParseMode::ChunkParallel, workers);
+            batch->succeeded[i] = parser.parse(batch->outputs[i]) ? 1 : 0;
+            if (batch->remaining.fetch_sub(1) == 1) {
+                LOG_INFO(L"Batch parse finished for " + std::to_wstring(batch->files.size()) + L" files");
+                batch->onComplete(collect(*batch));
+            }
+        });
+    }
+}
\ No newline at end of file
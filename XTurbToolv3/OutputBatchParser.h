@@ -0,0 +1,40 @@
+#pragma once
+#include "OutputData.h"
+#include "ThreadPool.h"
+#include <functional>
+#include <future>
+#include <map>
+#include <string>
+#include <vector>
+
+// Result of a batch parse: one snapshot per successfully parsed file, keyed by the full file path
+struct BatchParseResult {
+    std::map<std::wstring, OutputSnapshot> outputs;
+    std::vector<std::wstring> failedFiles;
+};
+
+// Parses sets of XTurb_Output*.dat files in parallel on a thread pool. Nothing in here blocks the calling thread,
+// so the UI can hand a whole run (or a directory of archived runs) over and continue processing messages.
+class OutputBatchParser {
+public:
+    using CompletionHandler = std::function<void(BatchParseResult&&)>;
+
+    explicit OutputBatchParser(size_t threadCount = 0);
+
+    // Collects the XTurb_Output*.dat files in a directory, optionally including all subdirectories (archived runs)
+    static std::vector<std::wstring> findOutputFiles(const std::wstring& directory, bool recursive = false);
+
+    // Parses all files and returns the result through a future
+    std::future<BatchParseResult> parseFiles(const std::vector<std::wstring>& files);
+    std::future<BatchParseResult> parseDirectory(const std::wstring& directory, bool recursive = false);
+
+    // Parses all files and calls onComplete from the worker that finishes last. No thread waits for the batch.
+    void parseFiles(const std::vector<std::wstring>& files, CompletionHandler onComplete);
+
+    // Drops every file that is not being parsed yet, so the destructor only waits for the files already in progress. Batches
+    // that lose a file never complete: their handlers are not called and their futures report a broken promise.
+    void cancelPending();
+
+private:
+    ThreadPool pool;
+};
\ No newline at end of file
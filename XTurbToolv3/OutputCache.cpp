@@ -0,0 +1,259 @@
+#include "OutputCache.h"
+#include "HelperFunctions.h"
+#include "OutputData.h"
+#include "MappedFile.h"
+#include "Logger.h"
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+namespace {
+    // Bump the version whenever the layout below changes; older sidecars are then simply rebuilt
+    constexpr char cacheMagic[4] = { 'X', 'T', 'C', '1' };
+    constexpr uint32_t cacheVersion = 2; // 2: source hash with the final mix of hashContent
+
+    // Fixed-size header at the start of the sidecar. The payload follows directly:
+    //   u64 singleValueCount, { string key, string value }...
+    //   string headerText
+    //   u64 tableCount, { u64 columnCount, u64 rowCount, string header..., double column[rowCount]... }...
+    // Strings are a u64 length followed by raw wchar_t units. Everything is in native byte order, the sidecar is not meant to be shared.
+    struct CacheHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t wcharSize;
+        uint32_t reserved;
+        uint64_t sourceSize;
+        int64_t sourceModified;
+        uint64_t sourceHash;
+        uint64_t payloadSize;
+    };
+
+    bool hashSource(const std::wstring& sourcePath, uint64_t& hash) {
+        MappedFile source(sourcePath);
+        if (!source.isOpen()) {
+            return false;
+        }
+        hash = hashContent(source.view());
+        return true;
+    }
+
+    // Bounds-checked reader over the mapped payload. Any overrun marks the sidecar as corrupt.
+    class PayloadReader {
+    public:
+        explicit PayloadReader(std::string_view payload) : payload(payload), pos(0) {}
+
+        bool read(void* out, size_t bytes) {
+            if (bytes > payload.size() - pos) return false;
+            std::memcpy(out, payload.data() + pos, bytes);
+            pos += bytes;
+            return true;
+        }
+        bool readSize(uint64_t& value) { return read(&value, sizeof(value)); }
+        bool readString(std::wstring& out) {
+            uint64_t length;
+            if (!readSize(length) || length > (payload.size() - pos) / sizeof(wchar_t)) return false;
+            out.resize(static_cast<size_t>(length));
+            return read(&out[0], static_cast<size_t>(length) * sizeof(wchar_t));
+        }
+        bool readColumn(OutputData::Column& out, uint64_t rows) {
+            if (rows > (payload.size() - pos) / sizeof(double)) return false;
+            out.resize(static_cast<size_t>(rows));
+            return read(out.data(), static_cast<size_t>(rows) * sizeof(double));
+        }
+        bool atEnd() const { return pos == payload.size(); }
+
+    private:
+        std::string_view payload;
+        size_t pos;
+    };
+
+    void writeSize(std::ofstream& out, uint64_t value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void writeString(std::ofstream& out, const std::wstring& text) {
+        writeSize(out, text.size());
+        out.write(reinterpret_cast<const char*>(text.data()), static_cast<std::streamsize>(text.size() * sizeof(wchar_t)));
+    }
+
+    // Patches the recorded modification time after the content hash proved the sidecar still matches
+    void restamp(const std::wstring& cachePath, int64_t modified) {
+        std::fstream file(std::filesystem::path(cachePath), std::ios::binary | std::ios::in | std::ios::out);
+        if (!file.is_open()) {
+            return;
+        }
+        file.seekp(offsetof(CacheHeader, sourceModified));
+        file.write(reinterpret_cast<const char*>(&modified), sizeof(modified));
+    }
+}
+
+std::wstring OutputCache::cachePathFor(const std::wstring& sourcePath) {
+    return sourcePath + L".xtc";
+}
+
+bool OutputCache::stampSource(const std::wstring& sourcePath, SourceStamp& stamp) {
+    std::error_code ec;
+    std::filesystem::path path(sourcePath);
+    uintmax_t size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return false;
+    }
+    auto modified = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return false;
+    }
+    stamp.size = static_cast<uint64_t>(size);
+    stamp.modified = static_cast<int64_t>(modified.time_since_epoch().count());
+    return true;
+}
+
+// Validates the sidecar against the source and decodes it into local containers first, so a corrupt file never leaves data half filled
+bool OutputCache::load(const std::wstring& sourcePath, const SourceStamp& stamp, OutputData& data) {
+    std::wstring cachePath = cachePathFor(sourcePath);
+    MappedFile file(cachePath);
+    if (!file.isOpen()) {
+        return false;
+    }
+    std::string_view content = file.view();
+    CacheHeader header;
+    if (content.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, content.data(), sizeof(header));
+    if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 || header.version != cacheVersion
+        || header.wcharSize != sizeof(wchar_t) || header.payloadSize != content.size() - sizeof(header)) {
+        LOG_DEBUG(L"Ignoring incompatible cache " + cachePath);
+        return false;
+    }
+    if (header.sourceSize != stamp.size) {
+        return false;
+    }
+    if (header.sourceModified != stamp.modified) {
+        uint64_t hash;
+        if (!hashSource(sourcePath, hash) || hash != header.sourceHash) {
+            return false;
+        }
+        restamp(cachePath, stamp.modified);
+    }
+
+    PayloadReader reader(content.substr(sizeof(header)));
+    std::map<std::wstring, std::wstring> singleValues;
+    std::wstring headerText;
+    std::vector<OutputData::Table> tables;
+    uint64_t valueCount;
+    if (!reader.readSize(valueCount)) {
+        return false;
+    }
+    for (uint64_t i = 0; i < valueCount; ++i) {
+        std::wstring key, value;
+        if (!reader.readString(key) || !reader.readString(value)) {
+            return false;
+        }
+        singleValues[key] = std::move(value);
+    }
+    uint64_t tableCount;
+    if (!reader.readString(headerText) || !reader.readSize(tableCount)) {
+        return false;
+    }
+    for (uint64_t t = 0; t < tableCount; ++t) {
+        uint64_t columnCount, rowCount;
+        if (!reader.readSize(columnCount) || !reader.readSize(rowCount) || columnCount > header.payloadSize) {
+            return false;
+        }
+        OutputData::Table table;
+        table.headers.resize(static_cast<size_t>(columnCount));
+        table.columns.resize(static_cast<size_t>(columnCount));
+        for (auto& name : table.headers) {
+            if (!reader.readString(name)) return false;
+        }
+        for (auto& column : table.columns) {
+            if (!reader.readColumn(column, rowCount)) return false;
+        }
+        tables.push_back(std::move(table));
+    }
+    if (!reader.atEnd()) {
+        Logger::logError(L"Corrupt output cache, rebuilding: " + cachePath);
+        return false;
+    }
+
+    for (auto& entry : singleValues) {
+        data.singleValues[entry.first] = std::move(entry.second);
+    }
+    data.headerText += headerText;
+    for (auto& table : tables) {
+        data.tables.push_back(std::move(table));
+    }
+    return true;
+}
+
+// Writes to a temporary file and renames it over the sidecar, so readers never see a partially written cache.
+// Failing to write is not an error for the caller; the file just gets parsed again next time.
+bool OutputCache::store(const std::wstring& sourcePath, const SourceStamp& stamp, const OutputData& data) {
+    uint64_t hash;
+    SourceStamp current;
+    if (!hashSource(sourcePath, hash) || !stampSource(sourcePath, current)
+        || current.size != stamp.size || current.modified != stamp.modified) {
+        LOG_DEBUG(L"Source changed while parsing, not caching " + sourcePath);
+        return false;
+    }
+
+    std::wstring cachePath = cachePathFor(sourcePath);
+    std::filesystem::path tempPath(cachePath + uniqueTempSuffix()); // Two processes may cache the same output at once
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            LOG_DEBUG(L"Cannot write output cache " + cachePath);
+            return false;
+        }
+        CacheHeader header = {};
+        std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+        header.version = cacheVersion;
+        header.wcharSize = sizeof(wchar_t);
+        header.sourceSize = stamp.size;
+        header.sourceModified = stamp.modified;
+        header.sourceHash = hash;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        writeSize(out, data.singleValues.size());
+        for (const auto& entry : data.singleValues) {
+            writeString(out, entry.first);
+            writeString(out, entry.second);
+        }
+        writeString(out, data.headerText);
+        writeSize(out, data.tables.size());
+        for (const auto& table : data.tables) {
+            writeSize(out, table.columnCount());
+            writeSize(out, table.rowCount());
+            for (size_t c = 0; c < table.columnCount(); ++c) {
+                writeString(out, c < table.headers.size() ? table.headers[c] : std::wstring());
+            }
+            for (const auto& column : table.columns) {
+                out.write(reinterpret_cast<const char*>(column.data()), static_cast<std::streamsize>(column.size() * sizeof(double)));
+            }
+        }
+
+        // The payload size goes in last, once it is known
+        header.payloadSize = static_cast<uint64_t>(out.tellp()) - sizeof(header);
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!out.good()) {
+            out.close();
+            std::error_code ignored;
+            std::filesystem::remove(tempPath, ignored);
+            LOG_DEBUG(L"Cannot write output cache " + cachePath);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, std::filesystem::path(cachePath), ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        LOG_DEBUG(L"Cannot replace output cache " + cachePath);
+        return false;
+    }
+    LOG_DEBUG(L"Output cache written: " + cachePath);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+class OutputData;
+
+// Binary sidecar cache of parsed output files. XTurb_Output1.dat is cached as XTurb_Output1.dat.xtc next to it, holding the single values,
+// the header text and the raw column buffers of every table. Loading maps the sidecar and copies the columns out in bulk, so reopening
+// a file skips the text parsing entirely.
+// A sidecar is valid while the source has the recorded size and modification time. If only the time differs (file copied or touched),
+// the content hash decides and the sidecar is re-stamped when the content is unchanged.
+class OutputCache {
+public:
+    // Identity of the source file at the time it was parsed
+    struct SourceStamp {
+        uint64_t size = 0;
+        int64_t modified = 0;
+    };
+
+    static std::wstring cachePathFor(const std::wstring& sourcePath);
+    static bool stampSource(const std::wstring& sourcePath, SourceStamp& stamp);
+
+    // Appends the cached contents to data. Returns false without touching data if there is no valid sidecar.
+    static bool load(const std::wstring& sourcePath, const SourceStamp& stamp, OutputData& data);
+    // Writes the sidecar for data, which was parsed from the source as it was at stamp. Skipped if the source changed in the meantime.
+    static bool store(const std::wstring& sourcePath, const SourceStamp& stamp, const OutputData& data);
+};
\ No newline at end of file
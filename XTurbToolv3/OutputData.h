@@ -1,16 +1,110 @@
 #pragma once
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
-#include <map>
+
+// Byte counter for all table column buffers in the process. Lets the tools and the benchmark check that handing parse results around
+// does not duplicate them: after a parse, peak() should stay close to current() however many windows show the data.
+struct ColumnMemory {
+    static inline std::atomic<size_t> currentBytes{ 0 };
+    static inline std::atomic<size_t> peakBytes{ 0 };
+
+    static size_t current() { return currentBytes.load(); }
+    static size_t peak() { return peakBytes.load(); }
+    static void resetPeak() { peakBytes = currentBytes.load(); }
+
+    static void allocated(size_t bytes) {
+        size_t now = currentBytes += bytes;
+        size_t previousPeak = peakBytes.load();
+        while (now > previousPeak && !peakBytes.compare_exchange_weak(previousPeak, now)) {}
+    }
+    static void released(size_t bytes) { currentBytes -= bytes; }
+};
+
+// std::allocator that reports to ColumnMemory. Only counts on (re)allocation, so appending rows costs nothing extra.
+template <class T>
+struct ColumnAllocator {
+    using value_type = T;
+
+    ColumnAllocator() = default;
+    template <class U> ColumnAllocator(const ColumnAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        T* values = std::allocator<T>().allocate(count);
+        ColumnMemory::allocated(count * sizeof(T));
+        return values;
+    }
+    void deallocate(T* values, size_t count) {
+        ColumnMemory::released(count * sizeof(T));
+        std::allocator<T>().deallocate(values, count);
+    }
+
+    template <class U> bool operator==(const ColumnAllocator<U>&) const { return true; }
+    template <class U> bool operator!=(const ColumnAllocator<U>&) const { return false; }
+};
 
 // This class is storing the output data from XTurb. The BEMTOutputParser class is using this to store the data.
+// It is movable and (deliberately) copyable, but parse results are meant to be moved into an OutputSnapshot and shared from there.
 class OutputData {
 public:
-    std::map<std::wstring, std::wstring> singleValues;
+    using Column = std::vector<double, ColumnAllocator<double>>;
+
+    // Read-only view of one contiguous column. Does not own the data, so it is only valid as long as the table it came from.
+    class ColumnView {
+    public:
+        ColumnView() : values(nullptr), count(0) {}
+        ColumnView(const double* values, size_t count) : values(values), count(count) {}
+        const double* data() const { return values; }
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        const double* begin() const { return values; }
+        const double* end() const { return values + count; }
+        double operator[](size_t i) const { return values[i]; }
+
+    private:
+        const double* values;
+        size_t count;
+    };
+
+    struct Table;
+
+    // Read-only view of one row. The values are gathered from the columns on access, nothing is copied.
+    class RowView {
+    public:
+        RowView(const Table& table, size_t index) : table(&table), index(index) {}
+        size_t size() const { return table->columns.size(); }
+        double operator[](size_t column) const { return table->columns[column][index]; }
+
+    private:
+        const Table* table;
+        size_t index;
+    };
+
+    // Tables are stored column by column (one contiguous buffer per header), so a column can be handed out as a view without copying
     struct Table {
         std::vector<std::wstring> headers;
-        std::vector<std::vector<double>> rows;
+        std::vector<Column> columns;
+
+        size_t rowCount() const { return columns.empty() ? 0 : columns[0].size(); }
+        size_t columnCount() const { return columns.size(); }
+        bool empty() const { return rowCount() == 0; }
+        ColumnView column(size_t index) const { return ColumnView(columns[index].data(), columns[index].size()); }
+        RowView row(size_t index) const { return RowView(*this, index); }
+
+        // Appends one row. The caller makes sure the row has one value per header.
+        void addRow(const std::vector<double>& values) {
+            if (columns.size() != values.size()) columns.resize(values.size());
+            for (size_t i = 0; i < values.size(); ++i) columns[i].push_back(values[i]);
+        }
+        // Removes all rows but keeps the headers
+        void clearRows() {
+            for (auto& column : columns) column.clear();
+        }
     };
+    std::map<std::wstring, std::wstring> singleValues;
     std::vector<Table> tables;
     std::wstring headerText;
 
@@ -19,15 +113,7 @@ public:
         tables.clear();
         headerText.clear();
     }
+};
 
-    OutputData() = default;
-    OutputData(const OutputData& other) : singleValues(other.singleValues), tables(other.tables), headerText(other.headerText) {}
-    OutputData& operator=(const OutputData& other) {
-        if (this != &other) {
-            singleValues = other.singleValues;
-            tables = other.tables;
-            headerText = other.headerText;
-        }
-        return *this;
-    }
-};
\ No newline at end of file
+// Immutable, shared parse result. Windows and graphs hold one of these instead of their own copy of the tables.
+using OutputSnapshot = std::shared_ptr<const OutputData>;
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <string>
 
 class OutputData;
+class OutputHandler;
 
 // This class is the base class to parse output data from XTurb
 class OutputFileParser {
@@ -9,8 +10,10 @@ public:
     OutputFileParser(const std::wstring& filePath);
     virtual ~OutputFileParser() = default;
     virtual bool parse(OutputData& data) = 0;
+    // Streaming variant: reports the contents to the handler while reading instead of building an OutputData
+    virtual bool parse(OutputHandler& handler) = 0;
 
 protected:
     std::wstring filePath;
-    virtual bool processLine(const std::wstring& line, OutputData& data) = 0;
+    virtual bool processLine(const std::wstring& line, OutputHandler& handler) = 0;
 };
\ No newline at end of file
@@ -0,0 +1,39 @@
+#include "OutputHandler.h"
+
+// Replays a prebuilt table through the row callbacks
+void OutputHandler::onTable(OutputData::Table&& table) {
+    onTableStart(table.headers);
+    std::vector<double> row(table.columnCount());
+    for (size_t r = 0; r < table.rowCount(); ++r) {
+        for (size_t c = 0; c < row.size(); ++c) row[c] = table.columns[c][r];
+        onRow(row.data(), row.size());
+    }
+    onTableEnd();
+}
+
+// Header lines end up in headerText with the line breaks the display window expects
+void OutputDataBuilder::onHeaderLine(const std::wstring& line) {
+    data.headerText += line;
+    data.headerText += L"\r\n";
+}
+
+void OutputDataBuilder::onSingleValue(const std::wstring& key, const std::wstring& value) {
+    data.singleValues[key] = value;
+}
+
+void OutputDataBuilder::onTableStart(const std::vector<std::wstring>& headers) {
+    data.tables.emplace_back();
+    data.tables.back().headers = headers;
+    data.tables.back().columns.resize(headers.size());
+}
+
+// Rows go straight into the column buffers of the open table
+void OutputDataBuilder::onRow(const double* values, size_t count) {
+    auto& columns = data.tables.back().columns;
+    for (size_t i = 0; i < count && i < columns.size(); ++i) columns[i].push_back(values[i]);
+}
+
+// Prebuilt tables are moved in as they are
+void OutputDataBuilder::onTable(OutputData::Table&& table) {
+    data.tables.push_back(std::move(table));
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+#include "OutputData.h"
+#include <string>
+#include <vector>
+
+// Push-style consumer of an output file. The parser reports the contents in file order while it reads, so consumers like
+// statistics, downsampling or export can process arbitrarily large outputs without materializing an OutputData.
+// A table is announced with onTableStart before its first row and closed with onTableEnd; tables without rows are never reported.
+// The strings passed in are only valid during the call.
+class OutputHandler {
+public:
+    virtual ~OutputHandler() = default;
+    virtual void onHeaderLine(const std::wstring& /*line*/) {}
+    virtual void onSingleValue(const std::wstring& /*key*/, const std::wstring& /*value*/) {}
+    virtual void onTableStart(const std::vector<std::wstring>& /*headers*/) {}
+    virtual void onRow(const double* /*values*/, size_t /*count*/) {}
+    virtual void onTableEnd() {}
+
+    // A complete table that was parsed ahead (e.g. by a chunk worker). The default replays it row by row.
+    virtual void onTable(OutputData::Table&& table);
+};
+
+// Handler that materializes everything into an OutputData. BEMTOutputParser::parse(OutputData&) is built on this.
+class OutputDataBuilder : public OutputHandler {
+public:
+    explicit OutputDataBuilder(OutputData& data) : data(data) {}
+    void onHeaderLine(const std::wstring& line) override;
+    void onSingleValue(const std::wstring& key, const std::wstring& value) override;
+    void onTableStart(const std::vector<std::wstring>& headers) override;
+    void onRow(const double* values, size_t count) override;
+    void onTable(OutputData::Table&& table) override;
+
+private:
+    OutputData& data;
+};
\ No newline at end of file
@@ -0,0 +1,269 @@
+#include "ResultCache.h"
+#include "BEMTOutputParser.h"
+#include "HelperFunctions.h"
+#include "MappedFile.h"
+#include "Logger.h"
+#include <algorithm>
+#include <filesystem>
+#ifdef _WIN32
+#include "header.h"
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // Bump when the key material changes, so old entries stop matching instead of being misused
+    const char keyVersion[] = "xturb-result-v1";
+    // A second, unrelated start value gives 128 bits of key from the same hash function
+    constexpr uint64_t secondSeed = 0x9E3779B97F4A7C15ull;
+
+    uint64_t directorySize(const std::filesystem::path& directory) {
+        uint64_t bytes = 0;
+        std::error_code ec;
+        for (auto it = std::filesystem::directory_iterator(directory, ec); !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+            if (it->is_regular_file(ec)) bytes += it->file_size(ec);
+        }
+        return bytes;
+    }
+
+    bool isOutputFile(const std::filesystem::path& path) {
+        return path.extension() == L".dat";
+    }
+}
+
+// Picks up the entries of earlier sessions, oldest first, and drops half-written ones. Holding the lock on the root makes every
+// .tmp directory left there one of a process that died while storing.
+ResultCache::ResultCache(const std::wstring& root, uint64_t maxBytes) : root(root), maxBytes(maxBytes), enabled(false),
+#ifdef _WIN32
+    lockHandle(INVALID_HANDLE_VALUE),
+#else
+    lockFile(-1),
+#endif
+    useClock(0) {
+    std::error_code ec;
+    std::filesystem::create_directories(root, ec);
+    if (!lockRoot()) {
+        Logger::logError(L"Result cache " + root + L" is in use by another process, running without it");
+        return;
+    }
+    enabled = true;
+    std::vector<std::pair<std::filesystem::file_time_type, std::wstring>> found;
+    for (auto it = std::filesystem::directory_iterator(root, ec); !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        if (!it->is_directory()) continue;
+        std::wstring name = it->path().filename().wstring();
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, L".tmp") == 0) {
+            std::error_code ignored;
+            std::filesystem::remove_all(it->path(), ignored);
+            continue;
+        }
+        std::error_code timeError;
+        found.emplace_back(std::filesystem::last_write_time(it->path(), timeError), name);
+    }
+    std::sort(found.begin(), found.end());
+    for (const auto& [time, name] : found) {
+        Entry entry;
+        entry.bytes = directorySize(std::filesystem::path(root) / name);
+        entry.lastUsed = ++useClock;
+        counters.bytes += entry.bytes;
+        entries[name] = entry;
+    }
+    counters.entries = entries.size();
+    std::lock_guard<std::mutex> lock(mutex);
+    evictLocked(std::wstring());
+}
+
+ResultCache::~ResultCache() {
+#ifdef _WIN32
+    if (lockHandle != INVALID_HANDLE_VALUE) CloseHandle(lockHandle);
+#else
+    if (lockFile >= 0) close(lockFile); // Releases the flock
+#endif
+}
+
+// The lock is released by the operating system when the process ends, so a crashed session never leaves the root locked
+bool ResultCache::lockRoot() {
+    std::filesystem::path lockPath = std::filesystem::path(root) / L"cache.lock";
+#ifdef _WIN32
+    lockHandle = CreateFileW(lockPath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    return lockHandle != INVALID_HANDLE_VALUE;
+#else
+    lockFile = open(lockPath.string().c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (lockFile >= 0 && flock(lockFile, LOCK_EX | LOCK_NB) == 0) return true;
+    if (lockFile >= 0) close(lockFile);
+    lockFile = -1;
+    return false;
+#endif
+}
+
+bool ResultCache::hashFile(const std::wstring& path, uint64_t& hash) {
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    int64_t modified = static_cast<int64_t>(std::filesystem::last_write_time(path, ec).time_since_epoch().count());
+    if (ec) return false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = fileHashes.find(path);
+        if (it != fileHashes.end() && it->second.size == size && it->second.modified == modified) {
+            hash = it->second.hash;
+            return true;
+        }
+    }
+    MappedFile file(path);
+    if (!file.isOpen()) return false;
+    hash = hashContent(file.view());
+    std::lock_guard<std::mutex> lock(mutex);
+    fileHashes[path] = FileHash{ size, modified, hash };
+    return true;
+}
+
+// Polars are resolved the way the RunScheduler places them: relative paths against the solver directory
+std::wstring ResultCache::keyFor(const InputData& input, const std::wstring& solverPath) {
+    if (!enabled) {
+        return std::wstring();
+    }
+    std::string material = keyVersion;
+    material += '\n';
+    material += input.serialize();
+
+    uint64_t hash;
+    if (!hashFile(solverPath, hash)) {
+        Logger::logError(L"Result cache cannot read solver " + solverPath);
+        return std::wstring();
+    }
+    material.append(reinterpret_cast<const char*>(&hash), sizeof(hash));
+
+    std::filesystem::path solverDir = std::filesystem::path(solverPath).parent_path();
+    for (const auto& polar : input.AIRFDATA) {
+        std::filesystem::path polarPath(polar);
+        if (polarPath.empty()) continue;
+        std::filesystem::path source = polarPath.is_absolute() ? polarPath : solverDir / polarPath;
+        if (!hashFile(source.wstring(), hash)) {
+            Logger::logError(L"Result cache cannot read polar " + source.wstring());
+            return std::wstring();
+        }
+        material.append(reinterpret_cast<const char*>(&hash), sizeof(hash));
+    }
+    return to_hex(hashContent(material)) + to_hex(hashContent(material, secondSeed));
+}
+
+// The links are made under the lock, so a concurrent store cannot evict the entry halfway through
+bool ResultCache::restore(const std::wstring& key, const std::wstring& directory, std::vector<std::wstring>& outputFiles) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        ++counters.misses;
+        return false;
+    }
+
+    std::filesystem::path entryDir = std::filesystem::path(root) / key;
+    std::filesystem::path target(directory);
+    std::error_code ec;
+    std::filesystem::create_directories(target, ec);
+    std::vector<std::wstring> restored;
+    for (auto file = std::filesystem::directory_iterator(entryDir, ec); !ec && file != std::filesystem::directory_iterator(); file.increment(ec)) {
+        if (!linkOrCopyFile(file->path().wstring(), (target / file->path().filename()).wstring())) {
+            Logger::logError(L"Failed to restore cached result into " + directory);
+            ++counters.misses;
+            return false;
+        }
+        if (isOutputFile(file->path())) restored.push_back((target / file->path().filename()).wstring());
+    }
+    if (ec || restored.empty()) {
+        ++counters.misses;
+        return false;
+    }
+    std::sort(restored.begin(), restored.end());
+    outputFiles = std::move(restored);
+    it->second.lastUsed = ++useClock;
+    std::filesystem::last_write_time(entryDir, std::filesystem::file_time_type::clock::now(), ec);
+    ++counters.hits;
+    return true;
+}
+
+// The entry is assembled in a temporary directory of its own (<key>.<unique>.tmp) and renamed into place, so an interrupted store
+// never leaves a partial entry behind and workers storing the same key at once never copy into each other's directory.
+// Parsing each file here writes its sidecar, which is what makes later hits free of text parsing.
+bool ResultCache::store(const std::wstring& key, const std::vector<std::wstring>& outputFiles) {
+    if (key.empty() || outputFiles.empty()) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (entries.count(key)) return true;
+    }
+
+    std::filesystem::path entryDir = std::filesystem::path(root) / key;
+    std::filesystem::path tempDir = std::filesystem::path(root) / (key + uniqueTempSuffix());
+    std::error_code ec;
+    std::filesystem::create_directories(tempDir, ec);
+    for (const auto& file : outputFiles) {
+        std::filesystem::path target = tempDir / std::filesystem::path(file).filename();
+        std::filesystem::copy_file(file, target, std::filesystem::copy_options::overwrite_existing, ec);
+        if (ec) {
+            Logger::logError(L"Failed to store result in cache: " + file);
+            std::filesystem::remove_all(tempDir, ec);
+            return false;
+        }
+        OutputData data;
+        BEMTOutputParser(target.wstring()).parse(data);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (entries.count(key)) {
+        std::filesystem::remove_all(tempDir, ec); // Another worker stored the same result meanwhile
+        return true;
+    }
+    std::filesystem::rename(tempDir, entryDir, ec);
+    if (ec) {
+        Logger::logError(L"Failed to store result in cache: " + entryDir.wstring());
+        std::filesystem::remove_all(tempDir, ec);
+        return false;
+    }
+    Entry entry;
+    entry.bytes = directorySize(entryDir);
+    entry.lastUsed = ++useClock;
+    entries[key] = entry;
+    counters.bytes += entry.bytes;
+    counters.entries = entries.size();
+    ++counters.stores;
+    evictLocked(key);
+    return true;
+}
+
+// Removes least recently used entries until the cache fits. The entry that was just stored is kept even if it alone is too big.
+void ResultCache::evictLocked(const std::wstring& keep) {
+    while (counters.bytes > maxBytes && entries.size() > (keep.empty() ? 0 : 1)) {
+        auto oldest = entries.end();
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (it->first == keep) continue;
+            if (oldest == entries.end() || it->second.lastUsed < oldest->second.lastUsed) oldest = it;
+        }
+        if (oldest == entries.end()) break;
+        std::error_code ec;
+        std::filesystem::remove_all(std::filesystem::path(root) / oldest->first, ec);
+        counters.bytes -= oldest->second.bytes;
+        ++counters.evictions;
+        LOG_DEBUG(L"Result cache evicted " + oldest->first);
+        entries.erase(oldest);
+    }
+    counters.entries = entries.size();
+}
+
+std::map<std::wstring, OutputSnapshot> ResultCache::loadOutputs(const std::vector<std::wstring>& outputFiles) {
+    std::map<std::wstring, OutputSnapshot> outputs;
+    for (const auto& file : outputFiles) {
+        OutputData data;
+        if (BEMTOutputParser(file).parse(data)) {
+            outputs[file] = std::make_shared<const OutputData>(std::move(data));
+        }
+    }
+    return outputs;
+}
+
+ResultCache::Stats ResultCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
\ No newline at end of file
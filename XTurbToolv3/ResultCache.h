@@ -0,0 +1,75 @@
+#pragma once
+#include "InputData.h"
+#include "OutputData.h"
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Content-addressed store of solver results. The key is a hash of everything that determines a run: the serialized .inp text,
+// the solver binary and the contents of every polar file the input references. Each entry is a directory under the cache root
+// holding the run's XTurb_Output*.dat files together with their .xtc sidecars, so a hit gives back both the files and the parsed
+// OutputData without starting the solver. The total size is bounded; the least recently used entries are evicted first.
+// The bookkeeping lives in this object, so a cache root belongs to one process at a time: the constructor locks it (cache.lock), and
+// a second process opening the same root runs without the cache (keyFor returns nothing) instead of evicting under the first.
+class ResultCache {
+public:
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t stores = 0;
+        size_t evictions = 0;
+        size_t entries = 0;
+        uint64_t bytes = 0;
+    };
+
+    ResultCache(const std::wstring& root, uint64_t maxBytes);
+    ~ResultCache();
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    // False if another process holds the cache root
+    bool isEnabled() const { return enabled; }
+
+    // Empty if the solver or a referenced polar cannot be read, or the cache is not enabled; such runs are simply not cached
+    std::wstring keyFor(const InputData& input, const std::wstring& solverPath);
+
+    // On a hit, links the cached output files (and sidecars) into directory and returns their paths there
+    bool restore(const std::wstring& key, const std::wstring& directory, std::vector<std::wstring>& outputFiles);
+    // Copies the output files of a finished run into the cache and evicts old entries if the size limit is exceeded
+    bool store(const std::wstring& key, const std::vector<std::wstring>& outputFiles);
+    // Parsed outputs of restored files, keyed by path. Served from the sidecars, so this does not parse any text.
+    static std::map<std::wstring, OutputSnapshot> loadOutputs(const std::vector<std::wstring>& outputFiles);
+
+    Stats stats() const;
+
+private:
+    struct Entry {
+        uint64_t bytes = 0;
+        uint64_t lastUsed = 0;
+    };
+    struct FileHash {
+        uint64_t size = 0;
+        int64_t modified = 0;
+        uint64_t hash = 0;
+    };
+
+    bool lockRoot();
+    bool hashFile(const std::wstring& path, uint64_t& hash);
+    void evictLocked(const std::wstring& keep);
+
+    std::wstring root;
+    uint64_t maxBytes;
+    bool enabled;
+#ifdef _WIN32
+    void* lockHandle;
+#else
+    int lockFile;
+#endif
+    mutable std::mutex mutex;
+    std::map<std::wstring, Entry> entries;
+    std::map<std::wstring, FileHash> fileHashes; // The solver binary is large, so its hash is only recomputed when the file changes
+    uint64_t useClock;
+    Stats counters;
+};
\ No newline at end of file
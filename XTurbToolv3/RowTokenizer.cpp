@@ -0,0 +1,255 @@
+#include "RowTokenizer.h"
+#include "CpuFeatures.h"
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#ifdef XTURB_X86
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+    }
+
+    int countTrailingZeros(uint32_t mask) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    // Slow path, also used for everything the fast path does not handle: prefix semantics of std::stod via from_chars
+    double parseGeneric(std::string_view field) {
+        if (field == "Infinity") {
+            return std::numeric_limits<double>::infinity();
+        }
+        const char* first = field.data();
+        const char* last = field.data() + field.size();
+        while (first != last && isSpace(*first)) ++first;
+        // from_chars does not accept an explicit plus sign; a sign after the plus is invalid for stod as well
+        if (first != last && *first == '+') {
+            ++first;
+            if (first != last && (*first == '-' || *first == '+')) return std::numeric_limits<double>::quiet_NaN();
+        }
+        // Hexadecimal ("0x1A", "-0x1.8p3") as stod reads it; from_chars wants the digits without the prefix and sign. Without a
+        // hex digit after the prefix stod stops after the 0.
+        double value;
+        const bool negative = first != last && *first == '-';
+        const char* hex = first + (negative ? 1 : 0);
+        if (last - hex >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) {
+            bool digit = last - hex > 2 && (std::isxdigit(static_cast<unsigned char>(hex[2]))
+                || (hex[2] == '.' && last - hex > 3 && std::isxdigit(static_cast<unsigned char>(hex[3]))));
+            if (!digit) {
+                return negative ? -0.0 : 0.0;
+            }
+            if (std::from_chars(hex + 2, last, value, std::chars_format::hex).ec != std::errc()) {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+            return negative ? -value : value;
+        }
+        auto result = std::from_chars(first, last, value);
+        // stod reports underflow into the subnormal range as out of range too
+        if (result.ec != std::errc() || (value != 0 && std::fabs(value) < std::numeric_limits<double>::min())) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return value;
+    }
+
+    // Exactly representable powers of ten for the fast path
+    const double powersOfTen[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+    // Fast path for the fixed and E formats the solver writes ([-]d.dddd[E[+-]dd]). When the mantissa fits in 53 bits and the
+    // decimal exponent is within +-22, one multiplication or division by an exact power of ten is correctly rounded, so the
+    // result is identical to from_chars. Returns false for anything else.
+    bool parseFast(const char* p, const char* end, double& value) {
+        bool negative = false;
+        if (p != end && (*p == '-' || *p == '+')) {
+            negative = *p == '-';
+            ++p;
+        }
+        uint64_t mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+        bool anyDigit = false;
+        while (p != end && static_cast<unsigned>(*p - '0') < 10) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                if (mantissa != 0) ++digits;
+            }
+            else {
+                return false;
+            }
+            anyDigit = true;
+            ++p;
+        }
+        if (p != end && *p == '.') {
+            ++p;
+            while (p != end && static_cast<unsigned>(*p - '0') < 10) {
+                if (digits >= 19) return false;
+                mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                if (mantissa != 0) ++digits;
+                --exponent;
+                anyDigit = true;
+                ++p;
+            }
+        }
+        if (!anyDigit) return false;
+        if (p != end && (*p == 'e' || *p == 'E')) {
+            ++p;
+            bool negativeExponent = false;
+            if (p != end && (*p == '-' || *p == '+')) {
+                negativeExponent = *p == '-';
+                ++p;
+            }
+            if (p == end) return false;
+            int explicitExponent = 0;
+            while (p != end && static_cast<unsigned>(*p - '0') < 10) {
+                explicitExponent = explicitExponent * 10 + (*p - '0');
+                if (explicitExponent > 1000) return false;
+                ++p;
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+        if (p != end) return false; // Trailing characters: let the generic path apply the prefix rule
+        if (mantissa > (uint64_t(1) << 53) || exponent < -22 || exponent > 22) return false;
+
+        double result = static_cast<double>(mantissa);
+        result = exponent < 0 ? result / powersOfTen[-exponent] : result * powersOfTen[exponent];
+        value = negative ? -result : result;
+        return true;
+    }
+
+    double convertField(const char* first, size_t length) {
+        double value;
+        if (parseFast(first, first + length, value)) {
+            return value;
+        }
+        return parseGeneric(std::string_view(first, length));
+    }
+
+    // Boundary state carried from one block to the next
+    struct ScanState {
+        bool inField = false;
+        size_t fieldStart = 0;
+    };
+
+    // Walks the space bitmask of one block (bit set = space) and emits every field that ends inside the block
+    size_t scanBlock(const char* data, size_t blockStart, uint32_t spaces, int width, ScanState& state, std::vector<double>& out) {
+        const uint32_t full = width == 32 ? 0xFFFFFFFFu : ((1u << width) - 1);
+        size_t count = 0;
+        int i = 0;
+        while (i < width) {
+            if (state.inField) {
+                uint32_t remaining = spaces >> i;
+                if (remaining == 0) break; // Field continues into the next block
+                int end = i + countTrailingZeros(remaining);
+                size_t fieldEnd = blockStart + end;
+                out.push_back(convertField(data + state.fieldStart, fieldEnd - state.fieldStart));
+                ++count;
+                state.inField = false;
+                i = end + 1;
+            }
+            else {
+                uint32_t remaining = (~spaces & full) >> i;
+                if (remaining == 0) break; // Only spaces left in this block
+                int start = i + countTrailingZeros(remaining);
+                state.fieldStart = blockStart + start;
+                state.inField = true;
+                i = start + 1;
+            }
+        }
+        return count;
+    }
+
+    // Byte-wise boundary search for the tail of a row (and the whole row in the scalar implementation)
+    size_t scanScalar(const char* data, size_t from, size_t size, ScanState& state, std::vector<double>& out) {
+        size_t count = 0;
+        for (size_t i = from; i < size; ++i) {
+            bool space = data[i] == ' ';
+            if (state.inField && space) {
+                out.push_back(convertField(data + state.fieldStart, i - state.fieldStart));
+                ++count;
+                state.inField = false;
+            }
+            else if (!state.inField && !space) {
+                state.fieldStart = i;
+                state.inField = true;
+            }
+        }
+        if (state.inField) {
+            out.push_back(convertField(data + state.fieldStart, size - state.fieldStart));
+            ++count;
+            state.inField = false;
+        }
+        return count;
+    }
+
+#ifdef XTURB_X86
+    size_t tokenizeSSE2(const char* data, size_t size, std::vector<double>& out) {
+        ScanState state;
+        size_t count = 0;
+        size_t pos = 0;
+        const __m128i space = _mm_set1_epi8(' ');
+        for (; pos + 16 <= size; pos += 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            uint32_t spaces = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, space)));
+            count += scanBlock(data, pos, spaces, 16, state, out);
+        }
+        return count + scanScalar(data, pos, size, state, out);
+    }
+
+    XTURB_TARGET_AVX2 size_t tokenizeAVX2(const char* data, size_t size, std::vector<double>& out) {
+        ScanState state;
+        size_t count = 0;
+        size_t pos = 0;
+        const __m256i space = _mm256_set1_epi8(' ');
+        for (; pos + 32 <= size; pos += 32) {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            uint32_t spaces = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, space)));
+            count += scanBlock(data, pos, spaces, 32, state, out);
+        }
+        return count + scanScalar(data, pos, size, state, out);
+    }
+#endif
+}
+
+RowTokenizer::Implementation RowTokenizer::bestImplementation() {
+#ifdef XTURB_X86
+    static const Implementation best = CpuFeatures::hasAVX2() ? Implementation::AVX2 : Implementation::SSE2;
+    return best;
+#else
+    return Implementation::Scalar;
+#endif
+}
+
+size_t RowTokenizer::tokenize(std::string_view row, std::vector<double>& out) {
+    return tokenize(row, out, bestImplementation());
+}
+
+size_t RowTokenizer::tokenize(std::string_view row, std::vector<double>& out, Implementation implementation) {
+#ifdef XTURB_X86
+    if (implementation == Implementation::AVX2) {
+        return tokenizeAVX2(row.data(), row.size(), out);
+    }
+    if (implementation == Implementation::SSE2) {
+        return tokenizeSSE2(row.data(), row.size(), out);
+    }
+#endif
+    ScanState state;
+    return scanScalar(row.data(), 0, row.size(), state, out);
+}
+
+double RowTokenizer::parseField(std::string_view field) {
+    return convertField(field.data(), field.size());
+}
\ No newline at end of file
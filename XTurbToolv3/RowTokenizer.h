@@ -0,0 +1,21 @@
+#pragma once
+#include <string_view>
+#include <vector>
+
+// Splits a row of an XTurb output table into numbers. Fields are separated by single spaces (runs of spaces give empty fields,
+// which are skipped), "Infinity" is infinity and a field that does not start with a number is NaN, exactly like the original
+// std::stod based row loop in BEMTOutputParser (ParseMode::Stream), hexadecimal fields such as 0x1A included.
+// Field boundaries are found 16 (SSE2) or 32 (AVX2) bytes at a time; plain fixed-format decimals are converted by a fast path.
+class RowTokenizer {
+public:
+    enum class Implementation { Scalar, SSE2, AVX2 };
+
+    // Appends the values of the row to out and returns how many were added. Uses the best implementation the CPU supports.
+    static size_t tokenize(std::string_view row, std::vector<double>& out);
+    static size_t tokenize(std::string_view row, std::vector<double>& out, Implementation implementation);
+
+    // Converts one field with the semantics described above
+    static double parseField(std::string_view field);
+
+    static Implementation bestImplementation();
+};
\ No newline at end of file
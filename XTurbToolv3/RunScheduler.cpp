@@ -0,0 +1,304 @@
+#include "RunScheduler.h"
+#include "NativeBemtSolver.h"
+#include "NativeHvmSolver.h"
+#include "OutputBatchParser.h"
+#include "HelperFunctions.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cwchar>
+#include <filesystem>
+
+namespace {
+    bool nativeSupports(const InputData& input) {
+        return NativeBemtSolver::supports(input) || NativeHvmSolver::supports(input);
+    }
+
+    // The in-process solver for the input's METHOD. HVM spreads its wake over threads, at most its share of the cores.
+    bool solveNative(const InputData& input, const std::wstring& polarDirectory, size_t threads, bool continuation, NamedOutputs& outputs) {
+        if (NativeHvmSolver::supports(input)) {
+            NativeHvmSolver solver(input, polarDirectory);
+            NativeHvmSolver::Settings settings;
+            settings.threads = threads;
+            settings.continuation = continuation;
+            solver.setSettings(settings);
+            return solver.solve(outputs);
+        }
+        NativeBemtSolver solver(input, polarDirectory);
+        solver.setContinuation(continuation);
+        return solver.solve(outputs);
+    }
+
+    // Continues the numbering of an existing scratch root, so results of earlier sessions are never overwritten
+    size_t firstFreeRunId(const std::filesystem::path& scratchRoot) {
+        size_t highest = 0;
+        std::error_code ec;
+        for (auto it = std::filesystem::directory_iterator(scratchRoot, ec); !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+            std::wstring name = it->path().filename().wstring();
+            if (name.rfind(L"run_", 0) == 0) {
+                highest = std::max(highest, static_cast<size_t>(wcstoull(name.c_str() + 4, nullptr, 10)));
+            }
+        }
+        return highest + 1;
+    }
+
+    std::wstring runDirectoryName(size_t id) {
+        std::wstring number = std::to_wstring(id);
+        return L"run_" + std::wstring(number.size() < 4 ? 4 - number.size() : 0, L'0') + number;
+    }
+}
+
+void RunRegistry::update(const RunRecord& record) {
+    std::lock_guard<std::mutex> lock(mutex);
+    runs[record.id] = record;
+}
+
+bool RunRegistry::find(size_t id, RunRecord& record) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = runs.find(id);
+    if (it == runs.end()) {
+        return false;
+    }
+    record = it->second;
+    return true;
+}
+
+std::vector<RunRecord> RunRegistry::records() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<RunRecord> result;
+    result.reserve(runs.size());
+    for (const auto& entry : runs) result.push_back(entry.second);
+    return result;
+}
+
+RunScheduler::RunScheduler(const std::wstring& solverPath, const std::wstring& scratchRoot, size_t maxParallel, std::unique_ptr<ExecutionBackend> backend)
+    : solverPath(solverPath), scratchRoot(scratchRoot), backend(backend ? std::move(backend) : ExecutionBackend::createDefault()),
+    runWatchdog((std::filesystem::path(scratchRoot) / L"run_history.csv").wstring()), resultCache(nullptr), abortOnDivergence(false), cancelling(false), nativeMode(NativeMode::Off), continuation(false), nextId(firstFreeRunId(scratchRoot)), pool(maxParallel) {
+    Logger::logError(L"RunScheduler using " + scratchRoot + L" with " + std::to_wstring(pool.size()) + L" parallel runs");
+}
+
+void RunScheduler::enableWarmStart(size_t spareSlots) {
+    warmPool = std::make_unique<WarmSolverPool>(*backend, solverPath, (std::filesystem::path(scratchRoot) / L"slots").wstring(), pool.size() + spareSlots);
+    if (!warmPool->isEnabled()) {
+        warmPool.reset();
+    }
+}
+
+std::wstring LaunchLatency::summary() const {
+    wchar_t line[160];
+    std::swprintf(line, 160, L"Solver launch latency over %zu runs: p50 %.1f ms, p90 %.1f ms, p99 %.1f ms, max %.1f ms",
+        runs, p50 * 1000.0, p90 * 1000.0, p99 * 1000.0, max * 1000.0);
+    return line;
+}
+
+LaunchLatency RunScheduler::launchLatency() const {
+    std::vector<double> sorted;
+    {
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        sorted = launchSamples;
+    }
+    LaunchLatency latency;
+    if (sorted.empty()) {
+        return latency;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double p) { return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))]; };
+    latency.runs = sorted.size();
+    latency.p50 = percentile(0.50);
+    latency.p90 = percentile(0.90);
+    latency.p99 = percentile(0.99);
+    latency.max = sorted.back();
+    return latency;
+}
+
+void RunScheduler::cancelPending() {
+    cancelling = true;
+    size_t dropped = pool.clearPending();
+    LOG_INFO(L"Runs cancelled, " + std::to_wstring(dropped) + L" queued runs dropped");
+}
+
+size_t RunScheduler::submit(const InputData& input, const std::wstring& label, CompletionHandler onComplete, ProgressHandler onProgress) {
+    RunRecord record;
+    record.id = nextId++;
+    record.label = label;
+    record.directory = (std::filesystem::path(scratchRoot) / runDirectoryName(record.id)).wstring();
+    runs.update(record);
+    pool.submit([this, record, input, onComplete, onProgress]() { execute(record, input, onComplete, onProgress); });
+    return record.id;
+}
+
+// Sets up the scratch directory: the solver, every relative polar path from AIRFDATA (resolved against the solver directory,
+// which is where the solver used to run) and the input file. Absolute polar paths are read in place by the solver.
+bool RunScheduler::prepareDirectory(const InputData& input, const std::wstring& directory, std::wstring& solverCopy) {
+    std::filesystem::path runDir(directory);
+    std::filesystem::path solver(solverPath);
+    std::error_code ec;
+    std::filesystem::create_directories(runDir, ec);
+    if (ec) {
+        Logger::logError(L"Failed to create run directory: " + directory);
+        return false;
+    }
+
+    std::filesystem::path solverTarget = runDir / solver.filename();
+    if (!linkOrCopyFile(solver.wstring(), solverTarget.wstring())) {
+        Logger::logError(L"Failed to place solver in " + directory);
+        return false;
+    }
+    solverCopy = solverTarget.wstring();
+
+    for (const auto& polar : input.AIRFDATA) {
+        std::filesystem::path polarPath(polar);
+        if (polarPath.empty() || polarPath.is_absolute()) {
+            continue;
+        }
+        std::filesystem::path source = solver.parent_path() / polarPath;
+        if (!linkOrCopyFile(source.wstring(), (runDir / polarPath).wstring())) {
+            Logger::logError(L"Failed to place polar " + source.wstring() + L" in " + directory);
+            return false;
+        }
+    }
+
+    std::wstring inputFile = (runDir / L"output.inp").wstring();
+    input.writeToFile(inputFile);
+    if (!std::filesystem::exists(inputFile)) {
+        Logger::logError(L"Failed to write " + inputFile);
+        return false;
+    }
+    return true;
+}
+
+void RunScheduler::execute(RunRecord record, const InputData& input, const CompletionHandler& onComplete, const ProgressHandler& onProgress) {
+    auto start = std::chrono::steady_clock::now();
+    record.state = RunRecord::State::Running;
+    runs.update(record);
+
+    const NativeMode native = nativeSupports(input) ? nativeMode.load() : NativeMode::Off;
+    const bool nativeContinuation = continuation;
+    const std::wstring polarDirectory = std::filesystem::path(solverPath).parent_path().wstring();
+    const size_t nativeThreads = std::max<size_t>(1, std::thread::hardware_concurrency() / std::max<size_t>(pool.size(), 1));
+    const std::wstring method = NativeHvmSolver::supports(input) ? L"HVM" : L"BEMT";
+    ResultCache* cache = resultCache;
+    std::wstring cacheKey = cache && native != NativeMode::Replace ? cache->keyFor(input, solverPath) : std::wstring();
+    if (native == NativeMode::Replace) {
+        NamedOutputs outputs;
+        record.native = true;
+        record.attempts = 1;
+        if (solveNative(input, polarDirectory, nativeThreads, nativeContinuation, outputs)) {
+            for (auto& [file, data] : outputs) {
+                record.nativeOutputs.emplace_back(file, std::make_shared<const OutputData>(std::move(data)));
+            }
+            record.exitCode = 0;
+            record.state = RunRecord::State::Succeeded;
+        }
+        else {
+            record.state = RunRecord::State::Failed;
+        }
+    }
+    else if (!cacheKey.empty() && cache->restore(cacheKey, record.directory, record.outputFiles)) {
+        input.writeToFile((std::filesystem::path(record.directory) / L"output.inp").wstring());
+        record.exitCode = 0;
+        record.cached = true;
+        record.state = RunRecord::State::Succeeded;
+    }
+    else {
+        std::filesystem::path runDir(record.directory);
+        ExecutionRequest request;
+        request.workingDirectory = record.directory;
+        request.stdinPath = (runDir / L"output.inp").wstring();
+        request.logPath = (runDir / L"XTurb_Execution_Log.txt").wstring();
+        request.cancel = &cancelling;
+        SolverMonitor monitor;
+        const bool abortDiverging = abortOnDivergence;
+        request.onLine = [&](std::string_view line) {
+            SolverProgress progress;
+            if (!monitor.processLine(line, progress)) {
+                return true;
+            }
+            if (onProgress && !cancelling) {
+                onProgress(record.id, progress);
+            }
+            if (progress.kind == SolverProgress::Kind::Diverged && abortDiverging) {
+                LOG_INFO(L"Run " + std::to_wstring(record.id) + L" diverged, aborting: " + progress.line);
+                return false;
+            }
+            return true;
+        };
+
+        // Only runs stopped by a limit or that never started are retried, each time with longer limits. A warm slot is used when
+        // one is available; otherwise the run directory gets its own solver copy and the solver is started the usual way.
+        const RetryPolicy retry = runWatchdog.retryPolicy();
+        record.estimatedSeconds = runWatchdog.estimateSeconds(input);
+        ExecutionResult result;
+        bool prepared = false;
+        do {
+            ++record.attempts;
+            RunLimits limits = runWatchdog.limitsFor(input, record.attempts);
+            request.timeoutMs = limits.wallMs;
+            request.inactivityTimeoutMs = limits.inactivityMs;
+            request.cpuLimitSeconds = limits.cpuSeconds;
+            if (record.attempts > 1) {
+                // Outputs the stopped attempt left behind must not be taken for this attempt's, so the directory starts over
+                std::error_code ec;
+                std::filesystem::remove_all(runDir, ec);
+                prepared = false;
+            }
+            monitor = SolverMonitor();
+            result = ExecutionResult();
+            double queuedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            bool warm = warmPool && warmPool->run(input, record.directory, request, result);
+            if (!warm) {
+                if (!prepared && !(prepared = prepareDirectory(input, record.directory, request.executablePath))) {
+                    break;
+                }
+                result = backend->execute(request);
+            }
+            record.cpuSeconds += result.cpuSeconds;
+            if (record.attempts == 1 && result.started) {
+                record.warmStart = warm;
+                record.launchSeconds = queuedSeconds + result.launchSeconds;
+                std::lock_guard<std::mutex> lock(latencyMutex);
+                launchSamples.push_back(record.launchSeconds);
+            }
+            if (result.timedOut && record.attempts < retry.maxAttempts) {
+                LOG_INFO(L"Run " + std::to_wstring(record.id) + L" stopped after " + std::to_wstring(result.wallSeconds)
+                    + L" s (estimate " + std::to_wstring(record.estimatedSeconds) + L" s), retrying with longer limits");
+            }
+        } while ((result.timedOut || !result.started) && !result.aborted && record.attempts < retry.maxAttempts);
+
+        record.exitCode = result.exitCode;
+        record.timedOut = result.timedOut;
+        record.limitHit = result.limitHit;
+        record.aborted = result.aborted;
+        if (cancelling) {
+            record.state = RunRecord::State::Failed;
+            runs.update(record);
+            return;
+        }
+        record.outputFiles = OutputBatchParser::findOutputFiles(record.directory);
+        // A solver that crashed or stopped on an error is a failure even when it wrote some output files
+        record.state = result.started && !result.timedOut && !result.aborted && result.exitCode == 0 ? RunRecord::State::Succeeded : RunRecord::State::Failed;
+        if (record.state == RunRecord::State::Succeeded && !cacheKey.empty()) {
+            cache->store(cacheKey, record.outputFiles);
+        }
+        if (result.started) {
+            runWatchdog.record(input, record.label, record.state == RunRecord::State::Succeeded, record.attempts,
+                result.wallSeconds, result.cpuSeconds);
+        }
+    }
+    if (native == NativeMode::Validate && record.state == RunRecord::State::Succeeded) {
+        NamedOutputs outputs;
+        if (solveNative(input, polarDirectory, nativeThreads, nativeContinuation, outputs)) {
+            NativeValidation validation = NativeBemtSolver::validate(outputs, record.directory);
+            record.nativeDeviation = validation.columns.empty() ? -1.0 : validation.maxRelative(); // Nothing in common is not a match
+            LOG_INFO(L"Run " + std::to_wstring(record.id) + L" native " + method + L" against the solver: " + validation.summary());
+        }
+    }
+    record.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    runs.update(record);
+
+    LOG_INFO(L"Run " + std::to_wstring(record.id) + L" (" + record.label + L") " + (record.state == RunRecord::State::Succeeded ? (record.cached ? L"answered from cache" : record.native ? L"solved in-process" : L"succeeded") : L"failed")
+        + L" in " + std::to_wstring(record.wallSeconds) + L" s with " + std::to_wstring(record.outputFiles.size() + record.nativeOutputs.size()) + L" output files");
+    if (onComplete) {
+        onComplete(record);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+#include "ExecutionBackend.h"
+#include "InputData.h"
+#include "OutputData.h"
+#include "ResultCache.h"
+#include "RunWatchdog.h"
+#include "SolverMonitor.h"
+#include "ThreadPool.h"
+#include "WarmSolverPool.h"
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// State and results of one scheduled solver run
+struct RunRecord {
+    enum class State { Queued, Running, Succeeded, Failed };
+
+    size_t id = 0;
+    std::wstring label;
+    std::wstring directory; // Scratch directory holding output.inp, the solver log and the XTurb_Output*.dat files
+    State state = State::Queued;
+    int exitCode = -1;
+    bool timedOut = false; // Stopped by the watchdog on every attempt, limitHit says why
+    RunLimit limitHit = RunLimit::None;
+    bool cached = false; // Outputs were restored from the result cache, the solver did not run
+    bool aborted = false; // Stopped as soon as the solver output showed divergence, or by RunScheduler::cancelPending
+    unsigned attempts = 0;
+    double estimatedSeconds = 0.0;
+    double wallSeconds = 0.0; // Including retries and directory setup
+    double cpuSeconds = 0.0;  // Solver CPU time, summed over all attempts
+    double launchSeconds = 0.0; // From taking the job until the solver had its input (first attempt)
+    bool warmStart = false;     // The solver process was started ahead of time in a warm slot
+    std::vector<std::wstring> outputFiles;
+    bool native = false; // Solved in-process by NativeBemtSolver or NativeHvmSolver: nativeOutputs holds the results and there are no output files
+    std::vector<std::pair<std::wstring, OutputSnapshot>> nativeOutputs; // Output file name (XTurb_Output1.dat) and its content
+    double nativeDeviation = -1.0; // NativeMode::Validate: largest relative deviation of the native results from the solver's, -1 if no column could be compared
+};
+
+// Percentiles of the time from taking a job to a solver that has its input, over all runs so far (seconds)
+struct LaunchLatency {
+    size_t runs = 0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+
+    // One line for the logs, with the times in milliseconds
+    std::wstring summary() const;
+};
+
+// Thread-safe record of every run a scheduler has accepted. Lookups return copies, so readers never see a run half updated.
+class RunRegistry {
+public:
+    void update(const RunRecord& record);
+    bool find(size_t id, RunRecord& record) const;
+    std::vector<RunRecord> records() const;
+
+private:
+    mutable std::mutex mutex;
+    std::map<size_t, RunRecord> runs;
+};
+
+// Runs solver jobs in parallel. Every job gets its own scratch directory (scratchRoot/run_<id>) with the solver and the polars
+// it references linked in, so jobs never share output.inp, the execution log or the output files and any number can overlap.
+// At most maxParallel jobs run at once (0 means one per hardware core); the rest wait in the queue. The limits and retries of each
+// run come from the watchdog, whose history lives in scratchRoot/run_history.csv.
+class RunScheduler {
+public:
+    // Off: every run starts the solver. Replace: inputs are solved in-process by NativeBemtSolver or NativeHvmSolver (by METHOD),
+    // without scratch directory or process. Validate: runs start the solver as usual and are solved in-process as well, and
+    // RunRecord::nativeDeviation says how far the two are apart.
+    enum class NativeMode { Off, Replace, Validate };
+
+    using CompletionHandler = std::function<void(const RunRecord&)>;
+    using ProgressHandler = std::function<void(size_t runId, const SolverProgress&)>;
+
+    RunScheduler(const std::wstring& solverPath, const std::wstring& scratchRoot, size_t maxParallel = 0, std::unique_ptr<ExecutionBackend> backend = nullptr);
+    RunScheduler(const RunScheduler&) = delete;
+    RunScheduler& operator=(const RunScheduler&) = delete;
+
+    // Queues a run of the given input and returns its id. onComplete is called from the worker thread once the run is finished,
+    // onProgress from the same thread for every progress line while the solver runs.
+    size_t submit(const InputData& input, const std::wstring& label, CompletionHandler onComplete = nullptr, ProgressHandler onProgress = nullptr);
+
+    const RunRegistry& registry() const { return runs; }
+    const std::wstring& getSolverPath() const { return solverPath; }
+    size_t maxParallel() const { return pool.size(); }
+    void setTimeout(unsigned timeoutMs) { runWatchdog.setFixedTimeout(timeoutMs); }
+    RunWatchdog& watchdog() { return runWatchdog; }
+    // Runs with a cached result are answered from the cache; successful runs are added to it. Not owned, may be null.
+    void setResultCache(ResultCache* cache) { resultCache = cache; }
+    // Kill a run as soon as its output shows divergence instead of letting it run into the timeout. Off by default.
+    void setAbortOnDivergence(bool abort) { abortOnDivergence = abort; }
+    void setNativeMode(NativeMode mode) { nativeMode = mode; }
+    // The in-process solvers start each operating point from a solved neighbour (see NativeBemtSolver::setContinuation). Faster on
+    // dense grids, but the results are not identical to cold solves. Off by default.
+    void setContinuation(bool enabled) { continuation = enabled; }
+    // Starts solver processes ahead of time in maxParallel() + spareSlots warm slots (scratchRoot/slots), so short runs do not
+    // wait for process creation. Call before the first submit.
+    void enableWarmStart(size_t spareSlots = 2);
+    LaunchLatency launchLatency() const;
+    // For shutdown: drops the queued runs and kills the solvers that are running, so the destructor only waits for runs solved
+    // in-process. Cancelled runs end as Failed without being cached, recorded by the watchdog or reported to onComplete.
+    void cancelPending();
+
+private:
+    bool prepareDirectory(const InputData& input, const std::wstring& directory, std::wstring& solverCopy);
+    void execute(RunRecord record, const InputData& input, const CompletionHandler& onComplete, const ProgressHandler& onProgress);
+
+    std::wstring solverPath;
+    std::wstring scratchRoot;
+    std::unique_ptr<ExecutionBackend> backend;
+    RunWatchdog runWatchdog;
+    std::atomic<ResultCache*> resultCache;
+    std::atomic<bool> abortOnDivergence;
+    std::atomic<bool> cancelling; // Handed to every ExecutionRequest
+    std::atomic<NativeMode> nativeMode;
+    std::atomic<bool> continuation;
+    std::atomic<size_t> nextId;
+    RunRegistry runs;
+    mutable std::mutex latencyMutex;
+    std::vector<double> launchSamples;
+    std::unique_ptr<WarmSolverPool> warmPool; // Uses the backend, so declared after it
+    ThreadPool pool; // Declared last so the workers are joined before anything they use is destroyed
+};
\ No newline at end of file
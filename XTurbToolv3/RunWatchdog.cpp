@@ -0,0 +1,147 @@
+#include "RunWatchdog.h"
+#include "HelperFunctions.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    // Rates used until the history has successful runs of a METHOD; the history replaces them after the first runs
+    constexpr double defaultBemtSecondsPerUnit = 2e-5;
+    constexpr double defaultHvmSecondsPerUnit = 3e-5;
+    constexpr double startupSeconds = 0.2;
+
+    // Limits are this many times the estimate, but never below the floors; short runs keep the old 30 s timeout
+    constexpr double safetyFactor = 4.0;
+    constexpr double wallPerCpu = 3.0; // Parallel runs share the cores, so wall-clock time may well exceed CPU time
+    constexpr double minCpuSeconds = 20.0;
+    constexpr unsigned minWallMs = 30000;
+    constexpr unsigned maxWallMs = 24u * 3600u * 1000u;
+
+    constexpr size_t samplesPerMethod = 32; // Only recent runs count, the solver binary or machine may have changed
+    const char historyHeader[] = "label,method,workUnits,succeeded,attempts,wallSeconds,cpuSeconds";
+
+    unsigned scaledMs(double ms) {
+        return static_cast<unsigned>(std::min<double>(ms, maxWallMs));
+    }
+}
+
+// Reads the history of earlier sessions; a missing or unreadable file just means no history yet
+RunWatchdog::RunWatchdog(const std::wstring& historyPath) : historyPath(historyPath), fixedTimeoutMs(0), inactivityMs(60000) {
+    std::ifstream file(std::filesystem::path{historyPath});
+    std::string line;
+    size_t loaded = 0;
+    while (std::getline(file, line)) {
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, ',')) fields.push_back(field);
+        if (fields.size() != 7 || fields[1] == "method") continue;
+        int method = std::atoi(fields[1].c_str());
+        double units = std::atof(fields[2].c_str());
+        double wall = std::atof(fields[5].c_str());
+        double cpu = std::atof(fields[6].c_str());
+        if (fields[3] == "1" && units > 0.0) {
+            addSampleLocked(method, (cpu > 0.0 ? cpu : wall) / units);
+            ++loaded;
+        }
+    }
+    LOG_DEBUG(L"Run history: " + std::to_wstring(loaded) + L" runs from " + historyPath);
+}
+
+// Cost model of the solver: every operating point solves all JX stations; the vortex method additionally sums the influence of
+// all JX * NSEC wake elements on every station, which is what makes fine HVM cases expensive
+double RunWatchdog::workUnits(const InputData& input) {
+    double cases = 0.0;
+    if (input.DESIGN) cases += std::max(input.NTSR, 1) * std::max(input.NPITCH, 1);
+    if (input.ANALYSIS) cases += std::max(input.NANA, 1);
+    if (input.PREDICTION) cases += std::max(input.NPRE, 1);
+    cases = std::max(cases, 1.0);
+    double stations = std::max(input.JX, 1);
+    if (input.METHOD == InputData::METHOD_HVM) {
+        return cases * stations * stations * std::max(input.NSEC, 1);
+    }
+    return cases * stations;
+}
+
+double RunWatchdog::secondsPerUnitLocked(int method) const {
+    auto it = samples.find(method);
+    if (it == samples.end() || it->second.empty()) {
+        return method == InputData::METHOD_HVM ? defaultHvmSecondsPerUnit : defaultBemtSecondsPerUnit;
+    }
+    std::vector<double> sorted = it->second;
+    std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+    return sorted[sorted.size() / 2]; // The median ignores the odd run that shared the machine with something else
+}
+
+void RunWatchdog::addSampleLocked(int method, double secondsPerUnit) {
+    std::vector<double>& recent = samples[method];
+    recent.push_back(secondsPerUnit);
+    if (recent.size() > samplesPerMethod) recent.erase(recent.begin());
+}
+
+double RunWatchdog::estimateSeconds(const InputData& input) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return startupSeconds + workUnits(input) * secondsPerUnitLocked(input.METHOD);
+}
+
+RunLimits RunWatchdog::limitsFor(const InputData& input, unsigned attempt) const {
+    double estimate = estimateSeconds(input);
+    std::lock_guard<std::mutex> lock(mutex);
+    double growth = std::pow(retry.limitGrowth, attempt > 0 ? attempt - 1 : 0);
+    RunLimits limits;
+    if (fixedTimeoutMs > 0) {
+        limits.wallMs = scaledMs(fixedTimeoutMs * growth);
+    }
+    else {
+        limits.cpuSeconds = std::max(minCpuSeconds, safetyFactor * estimate) * growth;
+        limits.wallMs = scaledMs(std::max<double>(minWallMs, limits.cpuSeconds * wallPerCpu * 1000.0));
+    }
+    limits.inactivityMs = inactivityMs > 0 ? std::min(scaledMs(inactivityMs * growth), limits.wallMs) : 0;
+    return limits;
+}
+
+// CPU time is what the rate is learned from, since wall-clock time depends on how many other runs shared the machine
+void RunWatchdog::record(const InputData& input, const std::wstring& label, bool succeeded, unsigned attempts, double wallSeconds, double cpuSeconds) {
+    double units = workUnits(input);
+    std::wstring cleanLabel = label;
+    std::replace(cleanLabel.begin(), cleanLabel.end(), L',', L' ');
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (succeeded && units > 0.0) {
+        addSampleLocked(input.METHOD, (cpuSeconds > 0.0 ? cpuSeconds : wallSeconds) / units);
+    }
+    bool newFile = !std::filesystem::exists(historyPath);
+    std::ofstream file(std::filesystem::path{historyPath}, std::ios::app);
+    if (!file.is_open()) {
+        Logger::logError(L"Failed to write run history: " + historyPath);
+        return;
+    }
+    if (newFile) file << historyHeader << "\n";
+    file << wstring_to_string(cleanLabel) << "," << input.METHOD << "," << units << "," << (succeeded ? 1 : 0) << ","
+        << attempts << "," << wallSeconds << "," << cpuSeconds << "\n";
+}
+
+void RunWatchdog::setFixedTimeout(unsigned wallMs) {
+    std::lock_guard<std::mutex> lock(mutex);
+    fixedTimeoutMs = wallMs;
+}
+
+void RunWatchdog::setInactivityTimeout(unsigned inactivityMs) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->inactivityMs = inactivityMs;
+}
+
+void RunWatchdog::setRetryPolicy(const RetryPolicy& policy) {
+    std::lock_guard<std::mutex> lock(mutex);
+    retry = policy;
+    retry.maxAttempts = std::max(retry.maxAttempts, 1u);
+}
+
+RetryPolicy RunWatchdog::retryPolicy() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return retry;
+}
\ No newline at end of file
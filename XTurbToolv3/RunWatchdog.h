@@ -0,0 +1,56 @@
+#pragma once
+#include "InputData.h"
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Limits for one attempt of a run, see ExecutionRequest
+struct RunLimits {
+    unsigned wallMs = 30000;
+    unsigned inactivityMs = 0;
+    double cpuSeconds = 0.0;
+};
+
+// A run that was stopped by one of its limits (or could not be started) is tried again with the limits multiplied by limitGrowth,
+// up to maxAttempts attempts in total. Divergence aborts and solver errors are not retried; they would only fail again.
+struct RetryPolicy {
+    unsigned maxAttempts = 2;
+    double limitGrowth = 2.0;
+};
+
+// Sets the limits of each run from its expected runtime instead of one fixed timeout for everything. The estimate is the amount of
+// work in the input (operating points times radial stations, times wake elements for HVM) multiplied by the CPU seconds per unit of
+// work measured on earlier runs of the same METHOD. Every finished run is appended to a CSV history file, which feeds the estimates
+// of later sessions and doubles as a record of wall and CPU time for capacity planning. Thread-safe.
+class RunWatchdog {
+public:
+    explicit RunWatchdog(const std::wstring& historyPath);
+    RunWatchdog(const RunWatchdog&) = delete;
+    RunWatchdog& operator=(const RunWatchdog&) = delete;
+
+    static double workUnits(const InputData& input);
+    double estimateSeconds(const InputData& input) const;
+    // attempt counts from 1; later attempts get proportionally longer limits
+    RunLimits limitsFor(const InputData& input, unsigned attempt) const;
+    // wallSeconds and cpuSeconds are those of the final attempt, so runs that needed retries do not inflate the learned rate
+    void record(const InputData& input, const std::wstring& label, bool succeeded, unsigned attempts, double wallSeconds, double cpuSeconds);
+
+    // A non-zero fixed timeout replaces the estimated wall-clock and CPU limits, as in the old single 30 s timeout
+    void setFixedTimeout(unsigned wallMs);
+    // No output for this long means the solver hangs; 0 disables the check
+    void setInactivityTimeout(unsigned inactivityMs);
+    void setRetryPolicy(const RetryPolicy& policy);
+    RetryPolicy retryPolicy() const;
+
+private:
+    double secondsPerUnitLocked(int method) const;
+    void addSampleLocked(int method, double secondsPerUnit);
+
+    std::wstring historyPath;
+    mutable std::mutex mutex;
+    std::map<int, std::vector<double>> samples; // Seconds per work unit of recent successful runs, per METHOD
+    unsigned fixedTimeoutMs;
+    unsigned inactivityMs;
+    RetryPolicy retry;
+};
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "SolverMonitor.h"
+#include "RowTokenizer.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+    std::vector<std::string_view> splitFields(std::string_view line) {
+        std::vector<std::string_view> fields;
+        size_t i = 0;
+        while (i < line.size()) {
+            while (i < line.size() && std::isspace(static_cast<unsigned char>(line[i]))) ++i;
+            size_t start = i;
+            while (i < line.size() && !std::isspace(static_cast<unsigned char>(line[i]))) ++i;
+            if (i > start) fields.push_back(line.substr(start, i - start));
+        }
+        return fields;
+    }
+
+    // Fortran style numbers: 12, -0.5, .25, 0.123E-03
+    bool isNumber(std::string_view field) {
+        size_t i = 0;
+        if (i < field.size() && (field[i] == '-' || field[i] == '+')) ++i;
+        if (i < field.size() && field[i] == '.') ++i;
+        return i < field.size() && std::isdigit(static_cast<unsigned char>(field[i]));
+    }
+
+    bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(),
+            [](char x, char y) { return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y)); });
+    }
+
+    bool isNotFinite(std::string_view field) {
+        if (!field.empty() && (field[0] == '-' || field[0] == '+')) field.remove_prefix(1);
+        return equalsIgnoreCase(field, "nan") || equalsIgnoreCase(field, "inf") || equalsIgnoreCase(field, "infinity");
+    }
+
+    // Fortran fills a numeric field that is too narrow for its value with asterisks
+    bool isOverflow(std::string_view field) {
+        return field.size() > 1 && field.find_first_not_of('*') == std::string_view::npos;
+    }
+
+    int firstInteger(const std::vector<std::string_view>& fields) {
+        for (auto field : fields) {
+            if (isNumber(field)) return static_cast<int>(RowTokenizer::parseField(field));
+        }
+        return 0;
+    }
+
+    std::wstring widen(std::string_view text) {
+        return std::wstring(text.begin(), text.end());
+    }
+}
+
+// Result tables and summaries may legitimately hold Infinity (a power coefficient at zero wind speed, for example), so only the
+// convergence columns of an iteration row are checked
+bool SolverMonitor::isDivergence(std::string_view line, const std::vector<std::string_view>& fields) const {
+    if (line.find("Fortran runtime error") != std::string_view::npos || line.find("Floating point exception") != std::string_view::npos) {
+        return true;
+    }
+    if (iterationColumn < 0 || fields.size() != columnCount || !isNumber(fields[iterationColumn])) {
+        return false;
+    }
+    for (size_t column : residualColumns) {
+        if (isNotFinite(fields[column]) || isOverflow(fields[column])) return true;
+    }
+    return false;
+}
+
+bool SolverMonitor::processLine(std::string_view line, SolverProgress& progress) {
+    std::vector<std::string_view> fields = splitFields(line);
+    if (fields.empty()) {
+        return false;
+    }
+    progress = SolverProgress();
+    progress.line = widen(line);
+
+    if (isDivergence(line, fields)) {
+        progress.kind = SolverProgress::Kind::Diverged;
+        return true;
+    }
+    size_t found = line.find("Convergence was achieved in");
+    if (found != std::string_view::npos) {
+        progress.kind = SolverProgress::Kind::Converged;
+        progress.iteration = firstInteger(splitFields(line.substr(found)));
+        return true;
+    }
+    if (line.find("did not lead to convergence") != std::string_view::npos) {
+        progress.kind = SolverProgress::Kind::NotConverged;
+        progress.iteration = firstInteger(fields);
+        return true;
+    }
+
+    bool numeric = std::all_of(fields.begin(), fields.end(), isNumber);
+    if (!numeric) {
+        // A new iteration table starts with a header of plain column names
+        auto it = std::find(fields.begin(), fields.end(), "IT");
+        bool header = it != fields.end() && std::none_of(fields.begin(), fields.end(), isNumber);
+        if (header) {
+            columnCount = fields.size();
+            iterationColumn = static_cast<int>(it - fields.begin());
+            changeColumn = -1;
+            changeName.clear();
+            residualColumns.clear();
+            for (size_t i = 0; i < fields.size(); ++i) {
+                if (fields[i].size() > 1 && fields[i][0] == 'D') {
+                    residualColumns.push_back(i);
+                }
+            }
+            if (!residualColumns.empty()) {
+                changeColumn = static_cast<int>(residualColumns.front());
+                changeName = widen(fields[changeColumn]);
+            }
+        }
+        return false;
+    }
+    if (iterationColumn < 0 || fields.size() != columnCount) {
+        return false;
+    }
+    progress.kind = SolverProgress::Kind::Iteration;
+    progress.iteration = static_cast<int>(RowTokenizer::parseField(fields[iterationColumn]));
+    if (changeColumn >= 0) {
+        progress.change = RowTokenizer::parseField(fields[changeColumn]);
+        progress.quantity = changeName;
+    }
+    return true;
+}
\ No newline at end of file
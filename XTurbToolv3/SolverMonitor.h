@@ -0,0 +1,39 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+// One progress report recognised in the solver's console output
+struct SolverProgress {
+    enum class Kind {
+        Iteration,    // A row of an iteration table (the columns headed IT, DCP, DGAM, ...)
+        Converged,    // "Convergence was achieved in N iterations"
+        NotConverged, // The solver gave up on a case ("... did not lead to convergence") and carries on with the next one
+        Diverged      // NaN/Infinity or overflowed fields in the change columns of an iteration row, or a Fortran runtime error
+    };
+
+    Kind kind = Kind::Iteration;
+    int iteration = 0;
+    double change = 0.0;   // The convergence quantity of the row (DCP, DGAM, DAX, ...), 0 if the table has none
+    std::wstring quantity; // Its column name
+    std::wstring line;     // The solver line the report was made from
+};
+
+// Follows the console output of one solver run line by line. Iteration tables are recognised by their header line: once a header
+// with an IT column was seen, numeric rows with the same number of fields are iterations, and the first column whose name starts
+// with D (the change per iteration, DCP, DGAM, ...) is taken as the convergence quantity. Divergence is only read from those change
+// columns, never from result tables or summary lines. Not thread-safe; one monitor per run.
+class SolverMonitor {
+public:
+    // Returns true and fills progress if the line is a progress report
+    bool processLine(std::string_view line, SolverProgress& progress);
+
+private:
+    bool isDivergence(std::string_view line, const std::vector<std::string_view>& fields) const;
+
+    size_t columnCount = 0;
+    int iterationColumn = -1;
+    int changeColumn = -1;
+    std::wstring changeName;
+    std::vector<size_t> residualColumns; // Every column whose name starts with D
+};
\ No newline at end of file
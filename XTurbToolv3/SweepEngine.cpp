@@ -0,0 +1,276 @@
+#include "SweepEngine.h"
+#include "BEMTOutputParser.h"
+#include "DistributedRunner.h"
+#include "Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cwchar>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <set>
+
+namespace {
+    // Value of a single value entry if it is a plain number, e.g. "7.5" but not "'NREL'"
+    bool parseNumber(const std::wstring& text, double& value) {
+        const wchar_t* begin = text.c_str();
+        wchar_t* end = nullptr;
+        value = std::wcstod(begin, &end);
+        if (end == begin) return false;
+        while (*end == L' ' || *end == L'\t') ++end;
+        return *end == L'\0';
+    }
+
+    // Shared state of one sweep. Every case has its own slot, so the workers only meet on the remaining counter.
+    struct Sweep {
+        std::vector<std::wstring> parameterNames;
+        std::vector<std::vector<double>> points;
+        std::vector<std::map<std::wstring, double>> metrics;
+        std::vector<char> succeeded;
+        std::atomic<size_t> remaining{ 0 };
+        SweepEngine::CompletionHandler onComplete;
+    };
+
+    // Numeric single values of one output file, keyed "<file>:<key>"
+    void addMetrics(const std::wstring& file, const OutputData& data, std::map<std::wstring, double>& metrics) {
+        std::wstring prefix = std::filesystem::path(file).stem().wstring() + L":";
+        for (const auto& [key, text] : data.singleValues) {
+            double value;
+            if (parseNumber(text, value)) metrics[prefix + key] = value;
+        }
+    }
+
+    // Numeric single values of every output file of a finished run
+    bool collectMetrics(const RunRecord& record, std::map<std::wstring, double>& metrics) {
+        if (record.state != RunRecord::State::Succeeded || (record.outputFiles.empty() && record.nativeOutputs.empty())) {
+            return false;
+        }
+        for (const auto& [file, data] : record.nativeOutputs) {
+            addMetrics(file, *data, metrics);
+        }
+        for (const auto& file : record.outputFiles) {
+            OutputData data;
+            BEMTOutputParser parser(file);
+            parser.setCacheEnabled(false); // Read once, a sidecar per case would only cost disk space
+            if (!parser.parse(data)) {
+                return false;
+            }
+            addMetrics(file, data, metrics);
+        }
+        return true;
+    }
+
+    // The same for a job a worker ran, whose outputs arrive parsed
+    bool collectMetrics(const JobResult& result, std::map<std::wstring, double>& metrics) {
+        if (!result.succeeded || result.outputs.empty()) {
+            return false;
+        }
+        for (const auto& [file, data] : result.outputs) {
+            addMetrics(file, data, metrics);
+        }
+        return true;
+    }
+
+    SweepResult aggregate(Sweep& sweep) {
+        SweepResult result;
+        result.parameterCount = sweep.parameterNames.size();
+        std::set<std::wstring> metricNames;
+        for (size_t i = 0; i < sweep.points.size(); ++i) {
+            if (!sweep.succeeded[i]) continue;
+            for (const auto& entry : sweep.metrics[i]) metricNames.insert(entry.first);
+        }
+        result.table.headers = sweep.parameterNames;
+        result.table.headers.insert(result.table.headers.end(), metricNames.begin(), metricNames.end());
+        result.table.columns.resize(result.table.headers.size());
+
+        std::vector<double> row(result.table.headers.size());
+        for (size_t i = 0; i < sweep.points.size(); ++i) {
+            if (!sweep.succeeded[i]) {
+                result.failedCases.push_back(sweep.points[i]);
+                continue;
+            }
+            std::copy(sweep.points[i].begin(), sweep.points[i].end(), row.begin());
+            size_t column = result.parameterCount;
+            for (const auto& name : metricNames) {
+                auto it = sweep.metrics[i].find(name);
+                row[column++] = it != sweep.metrics[i].end() ? it->second : std::numeric_limits<double>::quiet_NaN();
+            }
+            result.table.addRow(row);
+        }
+        return result;
+    }
+}
+
+SweepParameter SweepParameter::list(const std::wstring& name, const std::vector<double>& values) {
+    return SweepParameter{ name, values };
+}
+
+SweepParameter SweepParameter::range(const std::wstring& name, double first, double last, size_t count) {
+    SweepParameter parameter{ name, {} };
+    for (size_t i = 0; i < count; ++i) {
+        parameter.values.push_back(count == 1 ? first : first + (last - first) * static_cast<double>(i) / static_cast<double>(count - 1));
+    }
+    return parameter;
+}
+
+size_t SweepResult::findRow(const std::vector<double>& point) const {
+    if (point.size() != parameterCount) {
+        return SIZE_MAX;
+    }
+    for (size_t r = 0; r < table.rowCount(); ++r) {
+        size_t c = 0;
+        while (c < parameterCount && table.columns[c][r] == point[c]) ++c;
+        if (c == parameterCount) return r;
+    }
+    return SIZE_MAX;
+}
+
+SweepEngine::SweepEngine(RunScheduler& scheduler) : scheduler(&scheduler), coordinator(nullptr) {}
+
+SweepEngine::SweepEngine(DistributedCoordinator& coordinator) : scheduler(nullptr), coordinator(&coordinator) {}
+
+// Full factorial: every combination, the last parameter varying fastest.
+// Latin hypercube: each parameter's [min, max] is cut into samples strata and every stratum is used exactly once, in random pairing.
+// Listed: the given points, as long as every one has a value for each parameter.
+std::vector<std::vector<double>> SweepEngine::designPoints(const SweepSpec& spec) {
+    std::vector<std::vector<double>> points;
+    const size_t dimensions = spec.parameters.size();
+    if (dimensions == 0) {
+        return points;
+    }
+
+    if (spec.design == SweepSpec::Design::FullFactorial) {
+        size_t total = 1;
+        for (const auto& parameter : spec.parameters) total *= parameter.values.size();
+        points.reserve(total);
+        std::vector<size_t> index(dimensions, 0);
+        for (size_t n = 0; n < total; ++n) {
+            std::vector<double> point(dimensions);
+            for (size_t d = 0; d < dimensions; ++d) point[d] = spec.parameters[d].values[index[d]];
+            points.push_back(std::move(point));
+            for (size_t d = dimensions; d-- > 0;) {
+                if (++index[d] < spec.parameters[d].values.size()) break;
+                index[d] = 0;
+            }
+        }
+        return points;
+    }
+
+    if (spec.design == SweepSpec::Design::Listed) {
+        for (const auto& point : spec.points) {
+            if (point.size() != dimensions) return {};
+        }
+        return spec.points;
+    }
+
+    const size_t samples = spec.samples;
+    std::mt19937 rng(spec.seed);
+    std::uniform_real_distribution<double> jitter(0.0, 1.0);
+    points.assign(samples, std::vector<double>(dimensions));
+    std::vector<size_t> strata(samples);
+    for (size_t d = 0; d < dimensions; ++d) {
+        const auto& values = spec.parameters[d].values;
+        if (values.empty()) return {};
+        auto [low, high] = std::minmax_element(values.begin(), values.end());
+        std::iota(strata.begin(), strata.end(), 0);
+        std::shuffle(strata.begin(), strata.end(), rng);
+        for (size_t s = 0; s < samples; ++s) {
+            points[s][d] = *low + (*high - *low) * (static_cast<double>(strata[s]) + jitter(rng)) / static_cast<double>(samples);
+        }
+    }
+    return points;
+}
+
+bool SweepEngine::applyParameter(InputData& input, const std::wstring& name, double value) {
+    if (double InputData::* field = InputData::doubleField(name)) {
+        input.*field = value;
+        return true;
+    }
+    if (int InputData::* field = InputData::intField(name)) {
+        input.*field = static_cast<int>(std::lround(value));
+        return true;
+    }
+
+    // Array forms: NAME[i], NAME* and NAME+
+    size_t bracket = name.find(L'[');
+    std::wstring base = bracket != std::wstring::npos ? name.substr(0, bracket)
+        : (!name.empty() && (name.back() == L'*' || name.back() == L'+')) ? name.substr(0, name.size() - 1) : std::wstring();
+    std::vector<double> InputData::* arrayField = InputData::arrayField(base);
+    if (!arrayField) {
+        return false;
+    }
+    std::vector<double>& values = input.*arrayField;
+    if (bracket != std::wstring::npos) {
+        wchar_t* end = nullptr;
+        unsigned long index = std::wcstoul(name.c_str() + bracket + 1, &end, 10);
+        if (!end || *end != L']' || index >= values.size()) {
+            return false;
+        }
+        values[index] = value;
+    }
+    else if (name.back() == L'*') {
+        for (double& v : values) v *= value;
+    }
+    else {
+        for (double& v : values) v += value;
+    }
+    return true;
+}
+
+bool SweepEngine::run(const InputData& base, const SweepSpec& spec, CompletionHandler onComplete) {
+    auto sweep = std::make_shared<Sweep>();
+    for (const auto& parameter : spec.parameters) {
+        InputData probe = base;
+        if (!applyParameter(probe, parameter.name, parameter.values.empty() ? 0.0 : parameter.values.front())) {
+            Logger::logError(L"Unknown sweep parameter: " + parameter.name);
+            return false;
+        }
+        sweep->parameterNames.push_back(parameter.name);
+    }
+    sweep->points = designPoints(spec);
+    if (sweep->points.empty()) {
+        Logger::logError(L"Sweep has no cases");
+        return false;
+    }
+    sweep->metrics.resize(sweep->points.size());
+    sweep->succeeded.assign(sweep->points.size(), 0);
+    sweep->remaining = sweep->points.size();
+    sweep->onComplete = std::move(onComplete);
+    LOG_INFO(L"Starting sweep with " + std::to_wstring(sweep->points.size()) + L" cases");
+
+    for (size_t i = 0; i < sweep->points.size(); ++i) {
+        InputData input = base;
+        std::wstring label = L"Sweep case " + std::to_wstring(i + 1);
+        for (size_t d = 0; d < sweep->parameterNames.size(); ++d) {
+            applyParameter(input, sweep->parameterNames[d], sweep->points[i][d]);
+        }
+        auto finish = [sweep, i](bool succeeded) {
+            sweep->succeeded[i] = succeeded ? 1 : 0;
+            if (sweep->remaining.fetch_sub(1) == 1) {
+                LOG_INFO(L"Sweep finished with " + std::to_wstring(sweep->points.size()) + L" cases");
+                sweep->onComplete(aggregate(*sweep));
+            }
+        };
+        if (coordinator) {
+            coordinator->submit(input, label, [sweep, i, finish](size_t, JobResult&& result) { finish(collectMetrics(result, sweep->metrics[i])); });
+        }
+        else {
+            scheduler->submit(input, label, [sweep, i, finish](const RunRecord& record) { finish(collectMetrics(record, sweep->metrics[i])); });
+        }
+    }
+    return true;
+}
+
+std::future<SweepResult> SweepEngine::run(const InputData& base, const SweepSpec& spec) {
+    auto promise = std::make_shared<std::promise<SweepResult>>();
+    std::future<SweepResult> future = promise->get_future();
+    if (!run(base, spec, [promise](SweepResult&& result) { promise->set_value(std::move(result)); })) {
+        promise->set_value(SweepResult());
+    }
+    return future;
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+#include "InputData.h"
+#include "OutputData.h"
+#include "RunScheduler.h"
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+class DistributedCoordinator;
+
+// One varied input. The name selects the InputData field:
+//   BPITCH, JX, ...   a scalar field (integer fields are rounded)
+//   DTWIST[3]         one element of an array field
+//   CTAPER*           scales every element of an array field, e.g. 0.9 .. 1.1 for a chord study
+//   DTWIST+           adds to every element of an array field, e.g. a twist offset
+struct SweepParameter {
+    std::wstring name;
+    std::vector<double> values; // Full factorial uses the values as they are, Latin hypercube samples between their min and max
+
+    static SweepParameter list(const std::wstring& name, const std::vector<double>& values);
+    // count evenly spaced values from first to last
+    static SweepParameter range(const std::wstring& name, double first, double last, size_t count);
+};
+
+struct SweepSpec {
+    enum class Design { FullFactorial, LatinHypercube, Listed };
+
+    Design design = Design::FullFactorial;
+    std::vector<SweepParameter> parameters;
+    size_t samples = 0;  // Number of cases for Latin hypercube designs
+    unsigned seed = 1;   // Latin hypercube designs are reproducible for a given seed
+    std::vector<std::vector<double>> points; // Cases of a Listed design (e.g. a job file), one value per parameter; values are unused
+};
+
+// Aggregated results: one row per successful case. The leading columns are the parameter values, followed by every numeric
+// single value of every output file, named "<file>:<key>" (NaN where a case did not report the value).
+struct SweepResult {
+    OutputData::Table table;
+    size_t parameterCount = 0;
+    std::vector<std::vector<double>> failedCases; // Parameter values of the cases whose run or parse failed
+
+    // Row of the case with exactly these parameter values, or SIZE_MAX
+    size_t findRow(const std::vector<double>& point) const;
+};
+
+// Expands a sweep over a base InputData into cases, runs them through the RunScheduler (which writes each case's .inp with
+// InputData::writeToFile into its own run directory) and parses the outputs as runs finish. As many cases run at once as the
+// scheduler allows, so large sweeps go at the rate of the machine's cores. With a DistributedCoordinator the cases go to the
+// workers of its queue instead and come back already parsed.
+class SweepEngine {
+public:
+    using CompletionHandler = std::function<void(SweepResult&&)>;
+
+    explicit SweepEngine(RunScheduler& scheduler);
+    explicit SweepEngine(DistributedCoordinator& coordinator);
+
+    // The parameter values of every case, in submission order
+    static std::vector<std::vector<double>> designPoints(const SweepSpec& spec);
+    // Sets the named field; returns false for unknown names or out-of-range indices
+    static bool applyParameter(InputData& input, const std::wstring& name, double value);
+
+    // Returns false without running anything if the spec names an unknown field or yields no cases.
+    // onComplete is called from the worker that finishes the last case.
+    bool run(const InputData& base, const SweepSpec& spec, CompletionHandler onComplete);
+    std::future<SweepResult> run(const InputData& base, const SweepSpec& spec);
+
+private:
+    RunScheduler* scheduler;
+    DistributedCoordinator* coordinator;
+};
\ No newline at end of file
@@ -0,0 +1,131 @@
+// Checks that every BEMTOutputParser mode and the .xtc sidecar give the same OutputData for one output file. The file mixes the
+// fields the solver writes with the ones where RowTokenizer has to match std::stod (Infinity, hexadecimal, words, a plus sign) and
+// is large enough for ChunkParallel to split. Runs on the Linux build agents (ctest); not part of the XTurbToolv3 project.
+#include "BEMTOutputParser.h"
+#include "OutputCache.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <unistd.h>
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::fprintf(stderr, "FAILED: %s\n", what);
+            ++failures;
+        }
+    }
+
+    // Header lines with single values, then tables of 12 columns separated by --- lines, as XTurb writes them
+    void writeOutput(const std::filesystem::path& path, size_t tables, size_t rows) {
+        const char* specials[] = { "Infinity", "0x1A", "-0x1.8p3", "+1.5", "-0.0", "12.5", "abc", "7e-3", "1.0E+400" };
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> values(-50.0, 50.0);
+        std::ofstream file(path, std::ios::binary);
+        file << " XTurb test output\n Tip speed ratio =   5.0\n Number of blades = 3\n\n";
+        file << " r/R    c/R    Twist    alpha    phi    a    a'    F    cl    cd    dCT    dCP\n";
+        char buffer[32];
+        for (size_t t = 0; t < tables; ++t) {
+            file << " ------------------------------------------------------------\n";
+            for (size_t r = 0; r < rows; ++r) {
+                file << "  ";
+                for (size_t c = 0; c < 12; ++c) {
+                    if ((t * rows + r) % 37 == 0 && c == (t + r) % 12) {
+                        file << specials[(t + r) % (sizeof(specials) / sizeof(specials[0]))];
+                    }
+                    else {
+                        std::snprintf(buffer, sizeof(buffer), "%.6E", values(rng));
+                        file << buffer;
+                    }
+                    file << (c % 3 == 0 ? "    " : "   ");
+                }
+                file << "\n";
+                if (r == rows / 2) file << "   1.0   2.0   3.0\n"; // Too few values, dropped by every mode
+            }
+        }
+    }
+
+    bool sameValue(double a, double b) {
+        return (std::isnan(a) && std::isnan(b)) || std::memcmp(&a, &b, sizeof(double)) == 0;
+    }
+
+    bool sameData(const OutputData& a, const OutputData& b) {
+        if (a.singleValues != b.singleValues || a.headerText != b.headerText || a.tables.size() != b.tables.size()) {
+            return false;
+        }
+        for (size_t t = 0; t < a.tables.size(); ++t) {
+            const OutputData::Table& x = a.tables[t];
+            const OutputData::Table& y = b.tables[t];
+            if (x.headers != y.headers || x.columnCount() != y.columnCount() || x.rowCount() != y.rowCount()) {
+                return false;
+            }
+            for (size_t c = 0; c < x.columnCount(); ++c) {
+                for (size_t r = 0; r < x.rowCount(); ++r) {
+                    if (!sameValue(x.columns[c][r], y.columns[c][r])) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool contains(const OutputData& data, double value) {
+        for (const OutputData::Table& table : data.tables) {
+            for (const auto& column : table.columns) {
+                for (size_t r = 0; r < table.rowCount(); ++r) {
+                    if (column[r] == value) return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool parseWith(const std::filesystem::path& path, BEMTOutputParser::ParseMode mode, bool cache, ThreadPool& pool, OutputData& data) {
+        BEMTOutputParser parser(path.wstring(), mode, &pool);
+        parser.setCacheEnabled(cache);
+        return parser.parse(data);
+    }
+}
+
+int main() {
+    std::filesystem::path root = std::filesystem::temp_directory_path() / ("xturb_test_output_parser_" + std::to_string(getpid()));
+    std::filesystem::create_directories(root);
+    std::filesystem::path path = root / "XTurb_Output1.dat";
+    writeOutput(path, 250, 100);
+    check(std::filesystem::file_size(path) > (2u << 20), "the file is large enough to be split into chunks");
+    ThreadPool pool(4);
+
+    // Stream is the original std::stod based parser, the reference for the others
+    OutputData stream, mapped, chunked;
+    check(parseWith(path, BEMTOutputParser::ParseMode::Stream, false, pool, stream), "Stream parses the file");
+    check(stream.tables.size() == 250 && stream.tables[0].rowCount() == 100, "Stream finds every table and row");
+    check(stream.singleValues[L"Tip speed ratio"] == L"5.0", "Stream reads the single values");
+    check(contains(stream, 26.0) && contains(stream, -12.0), "Stream reads the hexadecimal fields");
+    check(parseWith(path, BEMTOutputParser::ParseMode::MemoryMapped, false, pool, mapped), "MemoryMapped parses the file");
+    check(sameData(stream, mapped), "MemoryMapped gives the same data as Stream");
+    check(parseWith(path, BEMTOutputParser::ParseMode::ChunkParallel, false, pool, chunked), "ChunkParallel parses the file");
+    check(sameData(stream, chunked), "ChunkParallel gives the same data as Stream");
+    check(!std::filesystem::exists(OutputCache::cachePathFor(path.wstring())), "no sidecar is written with the cache turned off");
+
+    // The first cached parse writes the sidecar, the second is answered from it
+    OutputData first, second, loaded;
+    check(parseWith(path, BEMTOutputParser::ParseMode::MemoryMapped, true, pool, first), "the cached parse succeeds");
+    check(std::filesystem::exists(OutputCache::cachePathFor(path.wstring())), "the cached parse writes the sidecar");
+    check(parseWith(path, BEMTOutputParser::ParseMode::MemoryMapped, true, pool, second), "the parse from the sidecar succeeds");
+    OutputCache::SourceStamp stamp;
+    check(OutputCache::stampSource(path.wstring(), stamp) && OutputCache::load(path.wstring(), stamp, loaded), "the sidecar is valid");
+    check(sameData(stream, first), "the parse that writes the sidecar gives the same data as Stream");
+    check(sameData(stream, second), "the parse from the sidecar gives the same data as Stream");
+    check(sameData(stream, loaded), "the sidecar holds the same data as Stream");
+
+    std::error_code ec;
+    std::filesystem::remove_all(root, ec);
+    if (failures == 0) std::printf("TestOutputParser passed\n");
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -15,10 +15,11 @@ int main() {
                 headers += header + L"\t";
             }
             Logger::logError(headers);
-            for (const auto& row : table.rows) {
+            for (size_t r = 0; r < table.rowCount(); ++r) {
+                OutputData::RowView row = table.row(r);
                 std::wstring rowStr;
-                for (double val : row) {
-                    rowStr += std::to_wstring(val) + L"\t";
+                for (size_t c = 0; c < row.size(); ++c) {
+                    rowStr += std::to_wstring(row[c]) + L"\t";
                 }
                 Logger::logError(rowStr);
             }
@@ -0,0 +1,72 @@
+// Checks that only runs whose solver exits cleanly reach the result cache. Stands in for the solver with shell scripts that write
+// an output file, so it runs on the Linux build agents (ctest) without the real solver; not part of the XTurbToolv3 project.
+#include "RunScheduler.h"
+#include "ResultCache.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <string>
+#include <unistd.h>
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::fprintf(stderr, "FAILED: %s\n", what);
+            ++failures;
+        }
+    }
+
+    // A stand-in solver that writes one output file and exits with exitCode
+    std::wstring writeSolver(const std::filesystem::path& directory, const std::string& name, int exitCode) {
+        std::filesystem::path path = directory / name;
+        std::ofstream script(path);
+        script << "#!/bin/sh\n"
+            << "cat > /dev/null\n"
+            << "printf ' Tip speed ratio = 5.0\\n' > XTurb_Output1.dat\n"
+            << "exit " << exitCode << "\n";
+        script.close();
+        std::filesystem::permissions(path, std::filesystem::perms::owner_all, std::filesystem::perm_options::add);
+        return path.wstring();
+    }
+
+    RunRecord runOnce(const std::wstring& solver, const std::filesystem::path& scratch, ResultCache& cache) {
+        RunScheduler scheduler(solver, scratch.wstring(), 1);
+        scheduler.setResultCache(&cache);
+        std::promise<RunRecord> finished;
+        scheduler.submit(InputData(), L"test", [&finished](const RunRecord& record) { finished.set_value(record); });
+        return finished.get_future().get();
+    }
+}
+
+int main() {
+    std::filesystem::path root = std::filesystem::temp_directory_path() / ("xturb_test_run_scheduler_" + std::to_string(getpid()));
+    std::filesystem::create_directories(root / "solvers");
+    std::ofstream(root / "solvers" / "s80905.polar") << "0.0 0.0 0.0\n"; // The polar the default input references
+
+    ResultCache cache((root / "cache").wstring(), 1 << 20);
+
+    // The solver wrote its output but exited with an error: a failed run, kept out of the cache
+    std::wstring failing = writeSolver(root / "solvers", "failing.sh", 3);
+    RunRecord first = runOnce(failing, root / "scratch", cache);
+    check(first.state == RunRecord::State::Failed, "a run exiting with code 3 is failed");
+    check(first.exitCode == 3, "the exit code of the failed run is kept");
+    check(cache.stats().stores == 0, "a failed run is not stored");
+    RunRecord second = runOnce(failing, root / "scratch", cache);
+    check(!second.cached, "the same input is not answered from the cache after a failed run");
+
+    // The same output with a clean exit is stored and answers the next identical run
+    std::wstring succeeding = writeSolver(root / "solvers", "succeeding.sh", 0);
+    RunRecord stored = runOnce(succeeding, root / "scratch", cache);
+    check(stored.state == RunRecord::State::Succeeded, "a run exiting with code 0 succeeds");
+    check(cache.stats().stores == 1, "a successful run is stored");
+    RunRecord restored = runOnce(succeeding, root / "scratch", cache);
+    check(restored.cached, "the same input is answered from the cache after a successful run");
+
+    std::error_code ec;
+    std::filesystem::remove_all(root, ec);
+    if (failures == 0) std::printf("TestRunScheduler passed\n");
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "ThreadPool.h"
+
+// Starts the workers. Falls back to a single thread if the core count is unknown.
+ThreadPool::ThreadPool(size_t threadCount) : stopping(false) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 1;
+    }
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+// Lets the workers drain the queue, then joins them
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::clearPending() {
+    std::deque<std::function<void()>> discarded;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        discarded.swap(tasks);
+    }
+    return discarded.size(); // Destroyed outside the lock, a task's captures may be large
+}
+
+// Takes tasks from the queue until the pool is stopping and the queue is empty
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed size pool of worker threads. Used for everything that has to run off the UI thread in parallel (batch parsing etc.).
+// The destructor finishes all queued tasks before joining the workers.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount = 0); // 0 means one thread per hardware core
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    // Discards the tasks that have not started (their futures report a broken promise) and returns how many there were.
+    // Tasks already running are not interrupted.
+    size_t clearPending();
+
+    // Queues a task and returns a future for its result
+    template <typename Task>
+    auto submit(Task&& task) -> std::future<decltype(task())> {
+        using Result = decltype(task());
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+        std::future<Result> future = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace_back([packaged]() { (*packaged)(); });
+        }
+        condition.notify_one();
+        return future;
+    }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping;
+};
\ No newline at end of file
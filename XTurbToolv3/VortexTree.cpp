@@ -0,0 +1,213 @@
+#include "VortexTree.h"
+#include "CpuFeatures.h"
+#include "ThreadPool.h"
+#include "VortexTreeDirect.h"
+#include <algorithm>
+#include <cmath>
+#include <future>
+
+namespace {
+    using BiotSavart::fourPi;
+    using BiotSavart::segmentFactor;
+    using VortexDirect::SegmentArrays;
+    using VortexDirect::directRange;
+    constexpr uint32_t leafSize = 32;
+
+    void directGeneric(const SegmentArrays& s, uint32_t first, uint32_t end, double x, double y, double z, double& u, double& v, double& w) {
+        directRange(s, first, end, x, y, z, u, v, w);
+    }
+}
+
+VortexTree::Implementation VortexTree::bestImplementation() {
+#ifdef XTURB_X86
+    static const Implementation best = CpuFeatures::hasAVX2FMA() ? Implementation::AVX2 : Implementation::Generic;
+    return best;
+#else
+    return Implementation::Generic;
+#endif
+}
+
+void VortexTree::velocity(const Segment& segment, double strength, double x, double y, double z, double& u, double& v, double& w) {
+    double cx, cy, cz;
+    double factor = strength * segmentFactor(x - segment.x1, y - segment.y1, z - segment.z1, x - segment.x2, y - segment.y2, z - segment.z2,
+        segment.core * segment.core * segment.core * segment.core, cx, cy, cz);
+    u += factor * cx;
+    v += factor * cy;
+    w += factor * cz;
+}
+
+void VortexTree::build(const std::vector<Segment>& segments) {
+    const uint32_t count = static_cast<uint32_t>(segments.size());
+    std::vector<uint32_t> indices(count);
+    for (uint32_t i = 0; i < count; ++i) indices[i] = i;
+    nodes.clear();
+    nodes.reserve(2 * (count / leafSize + 1));
+    if (count > 0) {
+        buildNode(indices, segments, 0, count);
+    }
+
+    order = indices;
+    for (auto* column : { &x1, &y1, &z1, &x2, &y2, &z2, &core4, &strength }) column->resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const Segment& segment = segments[indices[i]];
+        x1[i] = segment.x1;
+        y1[i] = segment.y1;
+        z1[i] = segment.z1;
+        x2[i] = segment.x2;
+        y2[i] = segment.y2;
+        z2[i] = segment.z2;
+        core4[i] = segment.core * segment.core * segment.core * segment.core;
+        strength[i] = 0.0;
+    }
+}
+
+// Median split of the midpoints along the longest side of their bounding box. Parents come before their children in nodes.
+int32_t VortexTree::buildNode(std::vector<uint32_t>& indices, const std::vector<Segment>& segments, uint32_t first, uint32_t count) {
+    auto midpoint = [&](uint32_t index, int axis) {
+        const Segment& s = segments[index];
+        return axis == 0 ? 0.5 * (s.x1 + s.x2) : axis == 1 ? 0.5 * (s.y1 + s.y2) : 0.5 * (s.z1 + s.z2);
+    };
+    double low[3], high[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        low[axis] = high[axis] = midpoint(indices[first], axis);
+    }
+    for (uint32_t i = first; i < first + count; ++i) {
+        for (int axis = 0; axis < 3; ++axis) {
+            double value = midpoint(indices[i], axis);
+            low[axis] = std::min(low[axis], value);
+            high[axis] = std::max(high[axis], value);
+        }
+    }
+
+    int32_t index = static_cast<int32_t>(nodes.size());
+    nodes.emplace_back();
+    Node node;
+    node.first = first;
+    node.count = count;
+    for (int axis = 0; axis < 3; ++axis) node.center[axis] = 0.5 * (low[axis] + high[axis]);
+    for (uint32_t i = first; i < first + count; ++i) {
+        const Segment& s = segments[indices[i]];
+        double d1 = std::hypot(s.x1 - node.center[0], s.y1 - node.center[1], s.z1 - node.center[2]);
+        double d2 = std::hypot(s.x2 - node.center[0], s.y2 - node.center[1], s.z2 - node.center[2]);
+        node.radius = std::max({ node.radius, d1, d2 });
+    }
+
+    if (count > leafSize) {
+        int axis = 0;
+        for (int a = 1; a < 3; ++a) {
+            if (high[a] - low[a] > high[axis] - low[axis]) axis = a;
+        }
+        uint32_t half = count / 2;
+        std::nth_element(indices.begin() + first, indices.begin() + first + half, indices.begin() + first + count,
+            [&](uint32_t a, uint32_t b) { return midpoint(a, axis) < midpoint(b, axis); });
+        node.children[0] = buildNode(indices, segments, first, half);
+        node.children[1] = buildNode(indices, segments, first + half, count - half);
+    }
+    nodes[index] = node;
+    return index;
+}
+
+// Children follow their parent in nodes, so walking backwards has every child's moments ready before its parent needs them
+void VortexTree::setStrengths(const std::vector<double>& strengths) {
+    for (size_t i = 0; i < order.size(); ++i) strength[i] = strengths[order[i]];
+    for (size_t n = nodes.size(); n-- > 0;) {
+        Node& node = nodes[n];
+        std::fill(std::begin(node.total), std::end(node.total), 0.0);
+        std::fill(std::begin(node.moment), std::end(node.moment), 0.0);
+        if (node.children[0] < 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                double s[3] = { strength[i] * (x2[i] - x1[i]), strength[i] * (y2[i] - y1[i]), strength[i] * (z2[i] - z1[i]) };
+                double d[3] = { 0.5 * (x1[i] + x2[i]) - node.center[0], 0.5 * (y1[i] + y2[i]) - node.center[1], 0.5 * (z1[i] + z2[i]) - node.center[2] };
+                for (int a = 0; a < 3; ++a) {
+                    node.total[a] += s[a];
+                    for (int b = 0; b < 3; ++b) node.moment[3 * a + b] += s[a] * d[b];
+                }
+            }
+            continue;
+        }
+        // Moments shift to the parent centre by the child's total times the offset of the centres
+        for (int32_t c : node.children) {
+            const Node& child = nodes[c];
+            double offset[3] = { child.center[0] - node.center[0], child.center[1] - node.center[1], child.center[2] - node.center[2] };
+            for (int a = 0; a < 3; ++a) {
+                node.total[a] += child.total[a];
+                for (int b = 0; b < 3; ++b) node.moment[3 * a + b] += child.moment[3 * a + b] + child.total[a] * offset[b];
+            }
+        }
+    }
+}
+
+void VortexTree::direct(uint32_t first, uint32_t end, double x, double y, double z, double& u, double& v, double& w) const {
+    const SegmentArrays arrays = { x1.data(), y1.data(), z1.data(), x2.data(), y2.data(), z2.data(), core4.data(), strength.data() };
+#ifdef XTURB_X86
+    if (implementation == Implementation::AVX2) {
+        VortexDirect::directAVX2(arrays, first, end, x, y, z, u, v, w);
+        return;
+    }
+#endif
+    directGeneric(arrays, first, end, x, y, z, u, v, w);
+}
+
+size_t VortexTree::evaluateTarget(double x, double y, double z, double& u, double& v, double& w) const {
+    if (nodes.empty()) {
+        return 0;
+    }
+    if (accuracy <= 0.0) {
+        direct(0, static_cast<uint32_t>(order.size()), x, y, z, u, v, w);
+        return order.size();
+    }
+    size_t interactions = 0;
+    int32_t stack[128];
+    int depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0) {
+        const Node& node = nodes[stack[--depth]];
+        double d[3] = { x - node.center[0], y - node.center[1], z - node.center[2] };
+        double distance2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+        if (node.radius * node.radius < accuracy * accuracy * distance2) {
+            // u = 1/4pi [ total x d / |d|^3 - (eps : moment) / |d|^3 + 3 (moment d) x d / |d|^5 ]
+            const double* t = node.total;
+            const double* m = node.moment;
+            double inverse = 1.0 / std::sqrt(distance2);
+            double inverse3 = inverse * inverse * inverse;
+            double inverse5 = 3.0 * inverse3 / distance2;
+            double md[3] = { m[0] * d[0] + m[1] * d[1] + m[2] * d[2], m[3] * d[0] + m[4] * d[1] + m[5] * d[2], m[6] * d[0] + m[7] * d[1] + m[8] * d[2] };
+            double antisymmetric[3] = { m[5] - m[7], m[6] - m[2], m[1] - m[3] };
+            u += ((t[1] * d[2] - t[2] * d[1] - antisymmetric[0]) * inverse3 + (md[1] * d[2] - md[2] * d[1]) * inverse5) / fourPi;
+            v += ((t[2] * d[0] - t[0] * d[2] - antisymmetric[1]) * inverse3 + (md[2] * d[0] - md[0] * d[2]) * inverse5) / fourPi;
+            w += ((t[0] * d[1] - t[1] * d[0] - antisymmetric[2]) * inverse3 + (md[0] * d[1] - md[1] * d[0]) * inverse5) / fourPi;
+            ++interactions;
+        }
+        else if (node.children[0] < 0) {
+            direct(node.first, node.first + node.count, x, y, z, u, v, w);
+            interactions += node.count;
+        }
+        else {
+            stack[depth++] = node.children[1];
+            stack[depth++] = node.children[0];
+        }
+    }
+    return interactions;
+}
+
+size_t VortexTree::evaluate(const double* x, const double* y, const double* z, size_t count, double* u, double* v, double* w,
+    ThreadPool* pool) const {
+    auto range = [&](size_t first, size_t last) {
+        size_t interactions = 0;
+        for (size_t i = first; i < last; ++i) interactions += evaluateTarget(x[i], y[i], z[i], u[i], v[i], w[i]);
+        return interactions;
+    };
+    if (!pool || pool->size() < 2 || count < 2) {
+        return range(0, count);
+    }
+    // A few chunks per thread, so targets near the dense part of the wake do not leave the other threads idle
+    size_t chunks = std::min(count, pool->size() * 4);
+    std::vector<std::future<size_t>> futures;
+    for (size_t c = 0; c < chunks; ++c) {
+        size_t first = count * c / chunks, last = count * (c + 1) / chunks;
+        futures.push_back(pool->submit([&range, first, last]() { return range(first, last); }));
+    }
+    size_t interactions = 0;
+    for (auto& future : futures) interactions += future.get();
+    return interactions;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+// Velocity induced by straight vortex segments, evaluated with a treecode. build() sorts the segments into a kd-tree of their
+// midpoints; setStrengths() sums every node's moments bottom-up (total vorticity and its first moment about the node centre). A
+// target then takes the dipole-accurate expansion of every node whose radius is below accuracy times its distance, and the exact
+// segments of the leaves that are closer. The error falls roughly with accuracy^3; accuracy 0 sums every segment directly, the
+// O(N) per target reference.
+// Segments have a Vatistas (n = 2) core of their own radius, so a target on or next to a filament gets a finite velocity.
+class VortexTree {
+public:
+    struct Segment {
+        double x1 = 0.0, y1 = 0.0, z1 = 0.0; // From
+        double x2 = 0.0, y2 = 0.0, z2 = 0.0; // To; the vorticity points from 1 to 2
+        double core = 0.0;
+    };
+
+    void build(const std::vector<Segment>& segments);
+    // One circulation per segment, in the order given to build()
+    void setStrengths(const std::vector<double>& strengths);
+
+    // The direct segment sums run on AVX2 when the CPU has it (see bestImplementation)
+    enum class Implementation { Generic, AVX2 };
+    static Implementation bestImplementation();
+    void setImplementation(Implementation choice) { implementation = choice; }
+
+    void setAccuracy(double theta) { accuracy = theta; }
+    double getAccuracy() const { return accuracy; }
+    size_t size() const { return order.size(); }
+
+    // Adds the velocities at count targets to u, v, w. With a pool the targets are split over its threads.
+    // Returns the number of segment and node interactions, a measure of the work done.
+    size_t evaluate(const double* x, const double* y, const double* z, size_t count, double* u, double* v, double* w,
+        ThreadPool* pool = nullptr) const;
+    // Adds the velocity of a single segment at (x, y, z), with the same core as the tree
+    static void velocity(const Segment& segment, double strength, double x, double y, double z, double& u, double& v, double& w);
+
+private:
+    struct Node {
+        double center[3] = {};
+        double radius = 0.0;       // Encloses every endpoint of the node's segments
+        uint32_t first = 0;        // Range in the sorted segment arrays
+        uint32_t count = 0;
+        int32_t children[2] = { -1, -1 };
+        double total[3] = {};      // Sum of circulation times segment vector
+        double moment[9] = {};     // Sum of (circulation times segment vector) x (midpoint - center), row major
+    };
+
+    int32_t buildNode(std::vector<uint32_t>& indices, const std::vector<Segment>& segments, uint32_t first, uint32_t count);
+    size_t evaluateTarget(double x, double y, double z, double& u, double& v, double& w) const;
+    void direct(uint32_t first, uint32_t end, double x, double y, double z, double& u, double& v, double& w) const;
+
+    double accuracy = 0.3;
+    Implementation implementation = bestImplementation();
+    std::vector<Node> nodes;
+    std::vector<uint32_t> order;   // Sorted position -> index given to build()
+    // Segments in tree order, structure of arrays for the direct kernel
+    std::vector<double> x1, y1, z1, x2, y2, z2, core4, strength;
+};
\ No newline at end of file
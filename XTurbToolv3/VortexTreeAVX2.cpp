@@ -0,0 +1,7 @@
+// Built with -mavx2 -mfma (/arch:AVX2), and only called when CpuFeatures::hasAVX2FMA()
+#include "VortexTreeDirect.h"
+
+void VortexDirect::directAVX2(const SegmentArrays& s, uint32_t first, uint32_t end, double x, double y, double z, double& u, double& v,
+    double& w) {
+    directRange(s, first, end, x, y, z, u, v, w);
+}
\ No newline at end of file
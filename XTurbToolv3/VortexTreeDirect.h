@@ -0,0 +1,43 @@
+#pragma once
+// The direct segment loop of VortexTree, included by VortexTree.cpp and VortexTreeAVX2.cpp so it is compiled once for the baseline
+// instruction set and once for AVX2 / FMA. directRange has internal linkage, so each file keeps its own copy (see CpuFeatures.h).
+#include "BiotSavart.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace VortexDirect {
+    constexpr size_t W = 8; // Segments per step of the direct kernel
+
+    struct SegmentArrays {
+        const double *x1, *y1, *z1, *x2, *y2, *z2, *core4, *strength;
+    };
+
+    // directRange built for AVX2 / FMA (VortexTreeAVX2.cpp)
+    void directAVX2(const SegmentArrays& s, uint32_t first, uint32_t end, double x, double y, double z, double& u, double& v, double& w);
+
+    namespace {
+        // Exact segments, W at a time into per-lane sums so the compiler can vectorize the loop without reordering additions
+        XTURB_FORCE_INLINE void directRange(const SegmentArrays& s, uint32_t first, uint32_t end, double x, double y, double z,
+            double& u, double& v, double& w) {
+            double su[W] = {}, sv[W] = {}, sw[W] = {};
+            auto add = [&](size_t i, size_t l) XTURB_LAMBDA_INLINE {
+                double cx, cy, cz;
+                double factor = s.strength[i] * BiotSavart::segmentFactor(x - s.x1[i], y - s.y1[i], z - s.z1[i], x - s.x2[i],
+                    y - s.y2[i], z - s.z2[i], s.core4[i], cx, cy, cz);
+                su[l] += factor * cx;
+                sv[l] += factor * cy;
+                sw[l] += factor * cz;
+            };
+            uint32_t i = first;
+            for (; i + W <= end; i += W) {
+                for (size_t l = 0; l < W; ++l) add(i + l, l);
+            }
+            for (; i < end; ++i) add(i, 0);
+            for (size_t l = 0; l < W; ++l) {
+                u += su[l];
+                v += sv[l];
+                w += sw[l];
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "WarmSolverPool.h"
+#include "HelperFunctions.h"
+#include "Logger.h"
+#include <chrono>
+#include <filesystem>
+
+WarmSolverPool::WarmSolverPool(ExecutionBackend& backend, const std::wstring& solverPath, const std::wstring& root, size_t slotCount)
+    : backend(backend), solverPath(solverPath), enabled(false), broken(0), stopping(false) {
+    std::filesystem::path solver(solverPath);
+    for (size_t i = 0; i < slotCount; ++i) {
+        auto slot = std::make_unique<Slot>();
+        std::filesystem::path directory = std::filesystem::path(root) / (L"slot_" + std::to_wstring(i + 1));
+        std::error_code ec;
+        std::filesystem::remove_all(directory, ec); // Leftovers of a session that ended during a run
+        std::filesystem::create_directories(directory, ec);
+        slot->directory = directory.wstring();
+        if (!linkOrCopyFile(solverPath, (directory / solver.filename()).wstring())) {
+            Logger::logError(L"Failed to place solver in " + slot->directory);
+            continue;
+        }
+        slot->staged.insert(solver.filename().wstring());
+        slots.push_back(std::move(slot));
+    }
+
+    // The first slot is started here to find out whether the backend supports it; the others are started in the background
+    if (slots.empty() || !refill(*slots[0])) {
+        Logger::logError(L"Warm solver slots are not available, solvers are started per run");
+        return;
+    }
+    enabled = true;
+    ready.push_back(slots[0].get());
+    for (size_t i = 1; i < slots.size(); ++i) toRefill.push_back(slots[i].get());
+    refiller = std::thread(&WarmSolverPool::refillLoop, this);
+}
+
+// Stops the refill thread; the destructors of the waiting processes kill them
+WarmSolverPool::~WarmSolverPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    refillRequested.notify_all();
+    readyChanged.notify_all();
+    if (refiller.joinable()) refiller.join();
+}
+
+bool WarmSolverPool::refill(Slot& slot) {
+    ExecutionRequest request;
+    request.executablePath = (std::filesystem::path(slot.directory) / std::filesystem::path(solverPath).filename()).wstring();
+    request.workingDirectory = slot.directory;
+    slot.process = backend.prepare(request);
+    return slot.process != nullptr;
+}
+
+void WarmSolverPool::refillLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        refillRequested.wait(lock, [this]() { return stopping || !toRefill.empty(); });
+        if (stopping) return;
+        Slot* slot = toRefill.front();
+        toRefill.pop_front();
+        lock.unlock();
+        bool started = refill(*slot);
+        lock.lock();
+        if (started) {
+            ready.push_back(slot);
+        }
+        else {
+            ++broken;
+            Logger::logError(L"Failed to start a warm solver in " + slot->directory);
+        }
+        readyChanged.notify_all();
+    }
+}
+
+// Relative polar paths are resolved against the solver directory, as for cold runs. They stay linked for later jobs.
+bool WarmSolverPool::stagePolars(const InputData& input, Slot& slot) {
+    std::filesystem::path solverDir = std::filesystem::path(solverPath).parent_path();
+    for (const auto& polar : input.AIRFDATA) {
+        std::filesystem::path polarPath(polar);
+        if (polarPath.empty() || polarPath.is_absolute()) {
+            continue;
+        }
+        std::filesystem::path target = (std::filesystem::path(slot.directory) / polarPath).lexically_normal();
+        if (!linkOrCopyFile((solverDir / polarPath).wstring(), target.wstring())) {
+            Logger::logError(L"Failed to place polar " + (solverDir / polarPath).wstring() + L" in " + slot.directory);
+            return false;
+        }
+        slot.staged.insert(target.lexically_relative(slot.directory).wstring());
+    }
+    return true;
+}
+
+// Moves the files the solver wrote (output files, convergence log, ...) from the slot into the run directory
+void WarmSolverPool::collectOutputs(Slot& slot, const std::wstring& directory) {
+    std::error_code ec;
+    for (auto it = std::filesystem::directory_iterator(slot.directory, ec); !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        std::wstring name = it->path().filename().wstring();
+        if (!it->is_regular_file() || slot.staged.count(name)) {
+            continue;
+        }
+        std::filesystem::path target = std::filesystem::path(directory) / name;
+        std::error_code moveError;
+        std::filesystem::rename(it->path(), target, moveError);
+        if (moveError) {
+            std::filesystem::copy_file(it->path(), target, std::filesystem::copy_options::overwrite_existing, moveError);
+            std::filesystem::remove(it->path(), moveError);
+        }
+    }
+}
+
+bool WarmSolverPool::run(const InputData& input, const std::wstring& directory, const ExecutionRequest& request, ExecutionResult& result) {
+    if (!enabled) {
+        return false;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    Slot* slot = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        readyChanged.wait(lock, [this]() { return stopping || !ready.empty() || broken == slots.size(); });
+        if (ready.empty()) {
+            return false;
+        }
+        slot = ready.front();
+        ready.pop_front();
+    }
+
+    bool ran = false;
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (stagePolars(input, *slot)) {
+        input.writeToFile((std::filesystem::path(directory) / L"output.inp").wstring()); // Kept with the results, as for cold runs
+        std::unique_ptr<PreparedExecution> process = std::move(slot->process);
+        double stagingSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result = process->run(input.serialize(), request);
+        result.launchSeconds += stagingSeconds; // Waiting for the slot and staging count as launch time too
+        collectOutputs(*slot, directory);
+        ran = true;
+    }
+    else {
+        slot->process.reset();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        toRefill.push_back(slot);
+    }
+    refillRequested.notify_one();
+    return ran;
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+#include "ExecutionBackend.h"
+#include "InputData.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Solver processes started ahead of time, so a job does not pay for process creation. Every slot has its own directory
+// (root/slot_K) with the solver linked in and a solver process already waiting for its input on a pipe (PreparedExecution).
+// A job takes the next slot whose process is ready, links its polars in, sends the input and afterwards moves everything the
+// solver wrote into the job's run directory. The used slot is then refilled with a new process by a background thread, off the
+// path of the next job. Keep a few more slots than parallel runs so a ready one is available while others refill.
+class WarmSolverPool {
+public:
+    WarmSolverPool(ExecutionBackend& backend, const std::wstring& solverPath, const std::wstring& root, size_t slotCount);
+    ~WarmSolverPool();
+    WarmSolverPool(const WarmSolverPool&) = delete;
+    WarmSolverPool& operator=(const WarmSolverPool&) = delete;
+
+    // False if the backend cannot start processes ahead of time; run() then always fails
+    bool isEnabled() const { return enabled; }
+
+    // Runs the input in a ready slot. request supplies the limits, logPath and onLine; the output files end up in directory.
+    // Returns false (with result.started false) if no slot could be used, so the caller can start the solver the usual way.
+    bool run(const InputData& input, const std::wstring& directory, const ExecutionRequest& request, ExecutionResult& result);
+
+private:
+    struct Slot {
+        std::wstring directory;
+        std::unique_ptr<PreparedExecution> process;
+        std::set<std::wstring> staged; // Files linked into the slot (solver, polars); everything else was written by the solver
+    };
+
+    bool refill(Slot& slot);
+    bool stagePolars(const InputData& input, Slot& slot);
+    void collectOutputs(Slot& slot, const std::wstring& directory);
+    void refillLoop();
+
+    ExecutionBackend& backend;
+    std::wstring solverPath;
+    bool enabled;
+    std::vector<std::unique_ptr<Slot>> slots;
+
+    std::mutex mutex;
+    std::condition_variable readyChanged;
+    std::condition_variable refillRequested;
+    std::deque<Slot*> ready;   // Slots with a waiting solver process
+    std::deque<Slot*> toRefill;
+    size_t broken;             // Slots whose process could not be started
+    bool stopping;
+    std::thread refiller;
+};
\ No newline at end of file
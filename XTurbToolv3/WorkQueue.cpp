@@ -0,0 +1,364 @@
+#include "WorkQueue.h"
+#include "HelperFunctions.h"
+#include "Logger.h"
+#include <zlib.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr char resultMagic[4] = { 'X', 'T', 'R', '1' };
+
+    class PacketWriter {
+    public:
+        void u64(uint64_t value) {
+            for (int i = 0; i < 8; ++i) bytes += static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+        void f64(double value) {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            u64(bits);
+        }
+        void str(const std::wstring& text) {
+            std::string utf8 = wstring_to_string(text);
+            u64(utf8.size());
+            bytes += utf8;
+        }
+        std::string bytes;
+    };
+
+    // Bounds-checked, like the PayloadReader of the output cache
+    class PacketReader {
+    public:
+        explicit PacketReader(std::string_view bytes) : bytes(bytes), pos(0) {}
+        bool u64(uint64_t& value) {
+            if (bytes.size() - pos < 8) return false;
+            value = 0;
+            for (int i = 0; i < 8; ++i) value |= static_cast<uint64_t>(static_cast<unsigned char>(bytes[pos + i])) << (8 * i);
+            pos += 8;
+            return true;
+        }
+        bool f64(double& value) {
+            uint64_t bits;
+            if (!u64(bits)) return false;
+            std::memcpy(&value, &bits, sizeof(value));
+            return true;
+        }
+        bool str(std::wstring& text) {
+            uint64_t length;
+            if (!u64(length) || length > bytes.size() - pos) return false;
+            text = string_to_wstring(std::string(bytes.substr(pos, static_cast<size_t>(length))));
+            pos += static_cast<size_t>(length);
+            return true;
+        }
+        size_t remaining() const { return bytes.size() - pos; }
+        bool atEnd() const { return pos == bytes.size(); }
+
+    private:
+        std::string_view bytes;
+        size_t pos;
+    };
+
+    bool readFile(const fs::path& path, std::string& content) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return false;
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return !file.bad();
+    }
+
+    // Written next to the target and renamed into place, so readers never see half a file. The temporary name is unique, as the
+    // coordinator and the workers (possibly on other hosts) can write the same target at once.
+    bool writeFileAtomically(const fs::path& path, const std::string& content) {
+        fs::path temp = path;
+        temp += uniqueTempSuffix();
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) return false;
+            file.write(content.data(), static_cast<std::streamsize>(content.size()));
+            if (!file.good()) return false;
+        }
+        std::error_code ec;
+        fs::rename(temp, path, ec);
+        if (ec) fs::remove(temp, ec);
+        return !ec;
+    }
+
+    // Job names of the files with the given extension, in name order (the coordinator numbers jobs, so this is submission order)
+    std::vector<std::wstring> jobsIn(const fs::path& directory, const wchar_t* extension) {
+        std::vector<std::wstring> jobs;
+        std::error_code ec;
+        for (auto it = fs::directory_iterator(directory, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+            if (it->path().extension() == extension) jobs.push_back(it->path().stem().wstring());
+        }
+        std::sort(jobs.begin(), jobs.end());
+        return jobs;
+    }
+
+    bool moveFile(const fs::path& from, const fs::path& to) {
+        std::error_code ec;
+        fs::rename(from, to, ec);
+        return !ec;
+    }
+}
+
+WorkQueue::WorkQueue(const std::wstring& root) : root(root) {
+    std::error_code ec;
+    fs::create_directories(fs::path(root) / L"pending", ec);
+    fs::create_directories(fs::path(root) / L"workers", ec);
+    fs::create_directories(fs::path(root) / L"results", ec);
+}
+
+bool WorkQueue::post(const std::wstring& job, const std::string& input) {
+    if (!writeFileAtomically(fs::path(root) / L"pending" / (job + L".inp"), input)) {
+        Logger::logError(L"Failed to queue job " + job + L" in " + root);
+        return false;
+    }
+    return true;
+}
+
+bool WorkQueue::cancel(const std::wstring& job) {
+    std::error_code ec;
+    return fs::remove(fs::path(root) / L"pending" / (job + L".inp"), ec);
+}
+
+std::vector<std::wstring> WorkQueue::finishedJobs() const {
+    return jobsIn(fs::path(root) / L"results", L".xtr");
+}
+
+bool WorkQueue::takeResult(const std::wstring& job, JobResult& result) {
+    fs::path path = fs::path(root) / L"results" / (job + L".xtr");
+    std::string packet;
+    bool ok = readFile(path, packet) && decodeResult(packet, result);
+    if (!ok) {
+        Logger::logError(L"Unreadable result for job " + job);
+    }
+    std::error_code ec;
+    fs::remove(path, ec);
+    return ok;
+}
+
+std::vector<std::wstring> WorkQueue::workers() const {
+    std::vector<std::wstring> names;
+    std::error_code ec;
+    for (auto it = fs::directory_iterator(fs::path(root) / L"workers", ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        if (it->is_directory()) names.push_back(it->path().filename().wstring());
+    }
+    return names;
+}
+
+bool WorkQueue::readHeartbeat(const std::wstring& worker, std::string& beat) const {
+    return readFile(fs::path(root) / L"workers" / worker / L"heartbeat", beat);
+}
+
+std::vector<std::wstring> WorkQueue::requeueWorker(const std::wstring& worker, bool removeWorker) {
+    fs::path directory = fs::path(root) / L"workers" / worker;
+    std::vector<std::wstring> requeued;
+    for (const wchar_t* extension : { L".inp", L".run" }) {
+        for (const auto& job : jobsIn(directory, extension)) {
+            if (moveFile(directory / (job + extension), fs::path(root) / L"pending" / (job + L".inp"))) {
+                requeued.push_back(job);
+            }
+        }
+    }
+    if (removeWorker) {
+        std::error_code ec;
+        fs::remove_all(directory, ec);
+    }
+    return requeued;
+}
+
+void WorkQueue::setStop(bool stop) {
+    fs::path path = fs::path(root) / L"stop";
+    std::error_code ec;
+    if (stop) writeFileAtomically(path, "stop\n");
+    else fs::remove(path, ec);
+}
+
+void WorkQueue::clear() {
+    std::error_code ec;
+    for (const wchar_t* directory : { L"pending", L"results" }) {
+        for (auto it = fs::directory_iterator(fs::path(root) / directory, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+            std::error_code ignored;
+            fs::remove(it->path(), ignored);
+        }
+    }
+}
+
+void WorkQueue::heartbeat(const std::wstring& worker, uint64_t beat) {
+    fs::path directory = fs::path(root) / L"workers" / worker;
+    std::error_code ec;
+    fs::create_directories(directory, ec); // Recreated if the coordinator gave the worker up while it was unreachable
+    writeFileAtomically(directory / L"heartbeat", std::to_string(beat) + "\n");
+}
+
+bool WorkQueue::stopRequested() const {
+    std::error_code ec;
+    return fs::exists(fs::path(root) / L"stop", ec);
+}
+
+bool WorkQueue::hasPending() const {
+    std::error_code ec;
+    for (auto it = fs::directory_iterator(fs::path(root) / L"pending", ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        if (it->path().extension() == L".inp") return true;
+    }
+    return false;
+}
+
+std::vector<std::wstring> WorkQueue::claimed(const std::wstring& worker) const {
+    return jobsIn(fs::path(root) / L"workers" / worker, L".inp");
+}
+
+std::vector<std::wstring> WorkQueue::claim(const std::wstring& worker, size_t count) {
+    std::vector<std::wstring> taken;
+    fs::path directory = fs::path(root) / L"workers" / worker;
+    for (const auto& job : jobsIn(fs::path(root) / L"pending", L".inp")) {
+        if (taken.size() >= count) break;
+        if (moveFile(fs::path(root) / L"pending" / (job + L".inp"), directory / (job + L".inp"))) {
+            taken.push_back(job);
+        }
+    }
+    return taken;
+}
+
+// Steals from the back of the busiest worker's backlog, the jobs it would have started last
+std::vector<std::wstring> WorkQueue::steal(const std::wstring& worker, size_t count) {
+    std::wstring victim;
+    std::vector<std::wstring> backlog;
+    for (const auto& other : workers()) {
+        if (other == worker) continue;
+        std::vector<std::wstring> jobs = claimed(other);
+        if (jobs.size() > backlog.size()) {
+            victim = other;
+            backlog = std::move(jobs);
+        }
+    }
+    std::vector<std::wstring> taken;
+    fs::path from = fs::path(root) / L"workers" / victim;
+    fs::path to = fs::path(root) / L"workers" / worker;
+    for (auto it = backlog.rbegin(); it != backlog.rend() && taken.size() < count; ++it) {
+        if (moveFile(from / (*it + L".inp"), to / (*it + L".inp"))) {
+            taken.push_back(*it);
+        }
+    }
+    if (!taken.empty()) {
+        LOG_INFO(worker + L" stole " + std::to_wstring(taken.size()) + L" jobs from " + victim);
+    }
+    return taken;
+}
+
+bool WorkQueue::start(const std::wstring& worker, const std::wstring& job, std::string& input) {
+    fs::path directory = fs::path(root) / L"workers" / worker;
+    return moveFile(directory / (job + L".inp"), directory / (job + L".run")) && readFile(directory / (job + L".run"), input);
+}
+
+bool WorkQueue::finish(const std::wstring& worker, const std::wstring& job, const JobResult& result) {
+    bool written = writeFileAtomically(fs::path(root) / L"results" / (job + L".xtr"), encodeResult(result));
+    if (!written) {
+        Logger::logError(L"Failed to write the result of job " + job + L" to " + root);
+    }
+    std::error_code ec;
+    fs::remove(fs::path(root) / L"workers" / worker / (job + L".run"), ec);
+    return written;
+}
+
+std::string WorkQueue::encodeResult(const JobResult& result) {
+    PacketWriter payload;
+    payload.u64(result.succeeded ? 1 : 0);
+    payload.str(result.worker);
+    payload.f64(result.wallSeconds);
+    payload.f64(result.cpuSeconds);
+    payload.u64(result.outputs.size());
+    for (const auto& [file, data] : result.outputs) {
+        payload.str(file);
+        payload.u64(data.singleValues.size());
+        for (const auto& [key, value] : data.singleValues) {
+            payload.str(key);
+            payload.str(value);
+        }
+        payload.str(data.headerText);
+        payload.u64(data.tables.size());
+        for (const auto& table : data.tables) {
+            payload.u64(table.columnCount());
+            payload.u64(table.rowCount());
+            for (size_t c = 0; c < table.columnCount(); ++c) {
+                payload.str(c < table.headers.size() ? table.headers[c] : std::wstring());
+            }
+            for (const auto& column : table.columns) {
+                for (double value : column) payload.f64(value);
+            }
+        }
+    }
+
+    uLongf compressedSize = compressBound(static_cast<uLong>(payload.bytes.size()));
+    std::string packet(sizeof(resultMagic) + 8 + compressedSize, '\0');
+    std::memcpy(&packet[0], resultMagic, sizeof(resultMagic));
+    PacketWriter size;
+    size.u64(payload.bytes.size());
+    std::memcpy(&packet[sizeof(resultMagic)], size.bytes.data(), 8);
+    compress2(reinterpret_cast<Bytef*>(&packet[sizeof(resultMagic) + 8]), &compressedSize,
+        reinterpret_cast<const Bytef*>(payload.bytes.data()), static_cast<uLong>(payload.bytes.size()), Z_BEST_SPEED);
+    packet.resize(sizeof(resultMagic) + 8 + compressedSize);
+    return packet;
+}
+
+bool WorkQueue::decodeResult(std::string_view packet, JobResult& result) {
+    constexpr size_t headerSize = sizeof(resultMagic) + 8;
+    uint64_t payloadSize;
+    if (packet.size() < headerSize || std::memcmp(packet.data(), resultMagic, sizeof(resultMagic)) != 0
+        || !PacketReader(packet.substr(sizeof(resultMagic), 8)).u64(payloadSize) || payloadSize > (1ull << 34)) {
+        return false;
+    }
+    std::string payload(static_cast<size_t>(payloadSize), '\0');
+    uLongf unpackedSize = static_cast<uLongf>(payloadSize);
+    if (uncompress(reinterpret_cast<Bytef*>(&payload[0]), &unpackedSize, reinterpret_cast<const Bytef*>(packet.data() + headerSize),
+        static_cast<uLong>(packet.size() - headerSize)) != Z_OK || unpackedSize != payloadSize) {
+        return false;
+    }
+
+    PacketReader reader(payload);
+    JobResult decoded;
+    uint64_t succeeded, fileCount;
+    if (!reader.u64(succeeded) || !reader.str(decoded.worker) || !reader.f64(decoded.wallSeconds) || !reader.f64(decoded.cpuSeconds)
+        || !reader.u64(fileCount)) {
+        return false;
+    }
+    decoded.succeeded = succeeded != 0;
+    for (uint64_t f = 0; f < fileCount; ++f) {
+        std::wstring file;
+        OutputData data;
+        uint64_t valueCount, tableCount;
+        if (!reader.str(file) || !reader.u64(valueCount)) return false;
+        for (uint64_t i = 0; i < valueCount; ++i) {
+            std::wstring key, value;
+            if (!reader.str(key) || !reader.str(value)) return false;
+            data.singleValues[key] = std::move(value);
+        }
+        if (!reader.str(data.headerText) || !reader.u64(tableCount)) return false;
+        for (uint64_t t = 0; t < tableCount; ++t) {
+            uint64_t columnCount, rowCount;
+            if (!reader.u64(columnCount) || !reader.u64(rowCount) || columnCount > reader.remaining()) return false;
+            OutputData::Table table;
+            table.headers.resize(static_cast<size_t>(columnCount));
+            for (auto& header : table.headers) {
+                if (!reader.str(header)) return false;
+            }
+            if (columnCount > 0 && rowCount > reader.remaining() / 8 / columnCount) return false;
+            table.columns.resize(static_cast<size_t>(columnCount));
+            for (auto& column : table.columns) {
+                column.resize(static_cast<size_t>(rowCount));
+                for (double& value : column) reader.f64(value);
+            }
+            data.tables.push_back(std::move(table));
+        }
+        decoded.outputs.emplace_back(std::move(file), std::move(data));
+    }
+    if (!reader.atEnd()) {
+        return false;
+    }
+    result = std::move(decoded);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+#include "OutputData.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// What a worker sends back for one job
+struct JobResult {
+    bool succeeded = false;
+    std::wstring worker;
+    double wallSeconds = 0.0;
+    double cpuSeconds = 0.0;
+    std::vector<std::pair<std::wstring, OutputData>> outputs; // Output file name (XTurb_Output1.dat) and its parsed content
+};
+
+// Job queue in a directory that the coordinator and all workers can reach (a network share, or a local directory for workers on
+// the same machine). Every state change is a rename of one file, which is atomic on a single file system, so no locks are needed:
+//   pending/<job>.inp             queued job: the .inp text of the run
+//   workers/<worker>/heartbeat    a counter the worker rewrites every second; the coordinator watches it change
+//   workers/<worker>/<job>.inp    claimed by the worker but not started, so other workers may still steal it
+//   workers/<worker>/<job>.run    being run
+//   results/<job>.xtr             finished: JobResult, zlib compressed (format below)
+//   stop                          the coordinator is done; workers exit once their own jobs are finished
+// When two workers race for a file, one rename fails and that worker just moves on to the next file.
+class WorkQueue {
+public:
+    explicit WorkQueue(const std::wstring& root);
+
+    const std::wstring& getRoot() const { return root; }
+
+    // Coordinator side
+    bool post(const std::wstring& job, const std::string& input);
+    bool cancel(const std::wstring& job); // Removes the job from pending/, e.g. a requeued copy of a job that finished after all
+    std::vector<std::wstring> finishedJobs() const;
+    // Decodes and removes the result. False for unreadable results, which are removed as well.
+    bool takeResult(const std::wstring& job, JobResult& result);
+    std::vector<std::wstring> workers() const;
+    bool readHeartbeat(const std::wstring& worker, std::string& beat) const;
+    // Moves every claimed or running job of the worker back to pending/ and removes its directory. Returns the requeued jobs.
+    std::vector<std::wstring> requeueWorker(const std::wstring& worker, bool removeWorker = true);
+    void setStop(bool stop);
+    // Removes queued jobs and results left over from earlier sessions
+    void clear();
+
+    // Worker side
+    void heartbeat(const std::wstring& worker, uint64_t beat);
+    bool stopRequested() const;
+    bool hasPending() const;
+    std::vector<std::wstring> claimed(const std::wstring& worker) const; // Own jobs that are not started yet
+    std::vector<std::wstring> claim(const std::wstring& worker, size_t count);
+    // Takes up to count unstarted jobs from the worker with the most of them, for when pending/ is empty
+    std::vector<std::wstring> steal(const std::wstring& worker, size_t count);
+    // Marks a claimed job as running and reads its input. False if another worker stole it in the meantime.
+    bool start(const std::wstring& worker, const std::wstring& job, std::string& input);
+    bool finish(const std::wstring& worker, const std::wstring& job, const JobResult& result);
+
+    // Result format: "XTR1", u64 size of the uncompressed payload, then the zlib compressed payload:
+    //   u64 succeeded, string worker, f64 wallSeconds, f64 cpuSeconds, u64 fileCount,
+    //   { string file, u64 singleValueCount, { string key, string value }..., string headerText,
+    //     u64 tableCount, { u64 columnCount, u64 rowCount, string header..., f64 column[rowCount]... }... }...
+    // Integers and doubles are little endian, strings a u64 byte length and UTF-8, so nodes of any platform can share the queue.
+    static std::string encodeResult(const JobResult& result);
+    static bool decodeResult(std::string_view packet, JobResult& result);
+
+private:
+    std::wstring root;
+};
\ No newline at end of file
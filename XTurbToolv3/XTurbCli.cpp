@@ -0,0 +1,399 @@
+// Headless front end for build agents and cluster job scripts: runs a job file or a sweep spec through the RunScheduler and writes
+// the parsed single values of every case as CSV or as a binary table. Uses no windowing code, so it builds on Linux as well
+// (see CMakeLists.txt) and in the XTurbCli console project on Windows.
+// With --coordinate the cases are served through a queue directory to worker processes (--work) on any number of nodes.
+//
+// Job file: the first line names the parameters (SweepEngine names: BPITCH, DTWIST[3], CTAPER*, ...), every further line is one
+// case with a value for each of them. Sweep spec: one directive per line,
+//   set NAME VALUE               changes the base input
+//   range NAME FIRST LAST COUNT  evenly spaced values
+//   list NAME V1 V2 ...          explicit values
+//   design full | lhs SAMPLES [SEED]
+// Values are separated by blanks or commas, # starts a comment.
+#include "DistributedRunner.h"
+#include "FileCompressor.h"
+#include "HelperFunctions.h"
+#include "InputData.h"
+#include "Logger.h"
+#include "ResultCache.h"
+#include "RunScheduler.h"
+#include "SweepEngine.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Options {
+        std::wstring solverPath;
+        std::wstring jobPath;
+        std::wstring sweepPath;
+        std::vector<std::pair<std::wstring, double>> overrides;
+        size_t parallel = 0;
+        std::wstring scratchRoot = L"xturb_runs";
+        std::wstring cacheRoot;
+        bool warm = false;
+        RunScheduler::NativeMode native = RunScheduler::NativeMode::Off;
+        bool continuation = false;
+        bool compress = false;
+        std::wstring outPath = L"results.csv";
+        bool binary = false;
+        std::wstring coordinateRoot;
+        std::wstring workRoot;
+        std::wstring workerName;
+        DistributedOptions distributed;
+        bool stopWorkers = false;
+    };
+
+    const char usage[] =
+        "Usage: XTurbCli --solver EXE (--job FILE | --sweep FILE) [options]\n"
+        "       XTurbCli --coordinate DIR (--job FILE | --sweep FILE) [--worker-timeout S] [--stop-workers] [options]\n"
+        "       XTurbCli --solver EXE --work DIR [--name NAME] [--parallel N] [--scratch DIR] [--cache DIR] [--warm]\n"
+        "  --set NAME=VALUE     change the base input before the cases are applied (repeatable)\n"
+        "  --parallel N         runs at once, default one per core\n"
+        "  --scratch DIR        run directories, default xturb_runs\n"
+        "  --cache DIR          answer identical runs from a result cache in DIR (one process at a time)\n"
+        "  --warm               start solver processes ahead of the runs\n"
+        "  --native             solve BEMT and HVM cases in-process instead of starting the solver (polars from the solver directory)\n"
+        "  --validate           run the solver and the in-process BEMT / HVM solver and report how far they are apart\n"
+        "  --continuation       in-process solves start each operating point from a solved neighbour (faster, not bit-identical)\n"
+        "  --compress           gzip the output files of every run\n"
+        "  --out FILE           results file, default results.csv\n"
+        "  --format csv|binary  default: binary for .xtb files, CSV otherwise\n"
+        "  --coordinate DIR     queue the cases in DIR for worker processes instead of running them here\n"
+        "  --worker-timeout S   give up a worker whose heartbeat stopped for S seconds and requeue its jobs, default 15\n"
+        "  --stop-workers       let the workers exit once all cases are done\n"
+        "  --work DIR           run as a worker for the queue in DIR until the coordinator stops the workers\n"
+        "  --name NAME          worker name, default <host>-<pid>\n";
+
+    std::wstring widen(const std::string& text) {
+        return std::wstring(text.begin(), text.end()); // Parameter names and numbers are ASCII
+    }
+
+    // Splits at blanks and commas and drops everything after #
+    std::vector<std::string> tokens(std::string line) {
+        line = line.substr(0, line.find('#'));
+        for (char& c : line) {
+            if (c == ',' || c == '\t' || c == '\r') c = ' ';
+        }
+        std::vector<std::string> result;
+        std::istringstream stream(line);
+        std::string token;
+        while (stream >> token) result.push_back(token);
+        return result;
+    }
+
+    bool parseDouble(const std::string& text, double& value) {
+        char* end = nullptr;
+        value = std::strtod(text.c_str(), &end);
+        return end != text.c_str() && *end == '\0';
+    }
+
+    bool fail(const std::string& message) {
+        std::cerr << message << "\n";
+        return false;
+    }
+
+    bool parseArguments(int argc, char** argv, Options& options) {
+        bool formatGiven = false;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&](std::string& value) {
+                if (i + 1 >= argc) return fail(arg + " needs a value");
+                value = argv[++i];
+                return true;
+            };
+            std::string value;
+            if (arg == "--warm") options.warm = true;
+            else if (arg == "--native") options.native = RunScheduler::NativeMode::Replace;
+            else if (arg == "--validate") options.native = RunScheduler::NativeMode::Validate;
+            else if (arg == "--continuation") options.continuation = true;
+            else if (arg == "--compress") options.compress = true;
+            else if (arg == "--stop-workers") options.stopWorkers = true;
+            else if (!next(value)) return false;
+            else if (arg == "--solver") options.solverPath = std::filesystem::absolute(value).wstring();
+            else if (arg == "--job") options.jobPath = std::filesystem::path(value).wstring();
+            else if (arg == "--sweep") options.sweepPath = std::filesystem::path(value).wstring();
+            else if (arg == "--scratch") options.scratchRoot = std::filesystem::path(value).wstring();
+            else if (arg == "--cache") options.cacheRoot = std::filesystem::path(value).wstring();
+            else if (arg == "--out") options.outPath = std::filesystem::path(value).wstring();
+            else if (arg == "--coordinate") options.coordinateRoot = std::filesystem::path(value).wstring();
+            else if (arg == "--work") options.workRoot = std::filesystem::path(value).wstring();
+            else if (arg == "--name") options.workerName = widen(value);
+            else if (arg == "--worker-timeout") options.distributed.workerLossMs = static_cast<unsigned>(std::strtod(value.c_str(), nullptr) * 1000.0);
+            else if (arg == "--parallel") options.parallel = std::strtoul(value.c_str(), nullptr, 10);
+            else if (arg == "--format") {
+                if (value != "csv" && value != "binary") return fail("Unknown format " + value);
+                options.binary = value == "binary";
+                formatGiven = true;
+            }
+            else if (arg == "--set") {
+                size_t equals = value.find('=');
+                double number;
+                if (equals == std::string::npos || !parseDouble(value.substr(equals + 1), number)) return fail("Expected NAME=VALUE: " + value);
+                options.overrides.emplace_back(widen(value.substr(0, equals)), number);
+            }
+            else return fail("Unknown option " + arg);
+        }
+        if (!formatGiven) {
+            options.binary = std::filesystem::path(options.outPath).extension() == L".xtb";
+        }
+        if (!options.workRoot.empty()) {
+            if (options.solverPath.empty() || !options.jobPath.empty() || !options.sweepPath.empty()) return fail("A worker needs a solver and no cases");
+        }
+        else if ((options.solverPath.empty() && options.coordinateRoot.empty()) || options.jobPath.empty() == options.sweepPath.empty()) {
+            return fail("A solver (or a queue to coordinate) and exactly one of --job and --sweep are required");
+        }
+        return true;
+    }
+
+    bool readJobFile(const std::wstring& path, SweepSpec& spec) {
+        std::ifstream file(std::filesystem::path{ path });
+        if (!file.is_open()) return fail("Cannot open job file " + wstring_to_string(path));
+        spec.design = SweepSpec::Design::Listed;
+        std::string line;
+        size_t lineNumber = 0;
+        while (std::getline(file, line)) {
+            ++lineNumber;
+            std::vector<std::string> fields = tokens(line);
+            if (fields.empty()) continue;
+            if (spec.parameters.empty()) {
+                for (const auto& name : fields) spec.parameters.push_back(SweepParameter{ widen(name), {} });
+                continue;
+            }
+            std::vector<double> point(fields.size());
+            for (size_t i = 0; i < fields.size(); ++i) {
+                if (!parseDouble(fields[i], point[i])) return fail("Job file line " + std::to_string(lineNumber) + ": not a number: " + fields[i]);
+            }
+            if (point.size() != spec.parameters.size()) {
+                return fail("Job file line " + std::to_string(lineNumber) + ": expected " + std::to_string(spec.parameters.size()) + " values");
+            }
+            spec.points.push_back(std::move(point));
+        }
+        return true;
+    }
+
+    bool readSweepSpec(const std::wstring& path, SweepSpec& spec, InputData& base) {
+        std::ifstream file(std::filesystem::path{ path });
+        if (!file.is_open()) return fail("Cannot open sweep spec " + wstring_to_string(path));
+        std::string line;
+        size_t lineNumber = 0;
+        while (std::getline(file, line)) {
+            ++lineNumber;
+            std::vector<std::string> fields = tokens(line);
+            if (fields.empty()) continue;
+            const std::string where = "Sweep spec line " + std::to_string(lineNumber) + ": ";
+            std::vector<double> numbers;
+            for (size_t i = 2; i < fields.size(); ++i) {
+                double value;
+                if (!parseDouble(fields[i], value)) return fail(where + "not a number: " + fields[i]);
+                numbers.push_back(value);
+            }
+            const std::string& directive = fields[0];
+            if (directive == "set" && numbers.size() == 1) {
+                if (!SweepEngine::applyParameter(base, widen(fields[1]), numbers[0])) return fail(where + "unknown field " + fields[1]);
+            }
+            else if (directive == "range" && numbers.size() == 3 && numbers[2] >= 1) {
+                spec.parameters.push_back(SweepParameter::range(widen(fields[1]), numbers[0], numbers[1], static_cast<size_t>(numbers[2])));
+            }
+            else if (directive == "list" && !numbers.empty()) {
+                spec.parameters.push_back(SweepParameter::list(widen(fields[1]), numbers));
+            }
+            else if (directive == "design" && fields.size() == 2 && fields[1] == "full") {
+                spec.design = SweepSpec::Design::FullFactorial;
+            }
+            else if (directive == "design" && fields.size() >= 3 && fields[1] == "lhs") {
+                double samples, seed = 1;
+                if (!parseDouble(fields[2], samples) || samples < 1 || (fields.size() > 3 && !parseDouble(fields[3], seed))) {
+                    return fail(where + "expected design lhs SAMPLES [SEED]");
+                }
+                spec.design = SweepSpec::Design::LatinHypercube;
+                spec.samples = static_cast<size_t>(samples);
+                spec.seed = static_cast<unsigned>(seed);
+            }
+            else return fail(where + "cannot read " + line);
+        }
+        return true;
+    }
+
+    // One row per case in case order: succeeded (1 or 0), the parameter values, then the metrics (NaN for failed cases)
+    OutputData::Table resultTable(const SweepResult& result, const std::vector<std::vector<double>>& points) {
+        OutputData::Table table;
+        table.headers.push_back(L"succeeded");
+        table.headers.insert(table.headers.end(), result.table.headers.begin(), result.table.headers.end());
+        table.columns.resize(table.headers.size());
+        std::vector<double> row(table.headers.size());
+        for (const auto& point : points) {
+            size_t found = result.findRow(point);
+            row[0] = found != SIZE_MAX ? 1.0 : 0.0;
+            for (size_t c = 0; c < result.table.columns.size(); ++c) {
+                row[c + 1] = c < result.parameterCount ? point[c]
+                    : found != SIZE_MAX ? result.table.columns[c][found] : std::numeric_limits<double>::quiet_NaN();
+            }
+            table.addRow(row);
+        }
+        return table;
+    }
+
+    // NaN is left empty, which spreadsheet and pandas readers both take as missing
+    bool writeCsv(const std::wstring& path, const OutputData::Table& table) {
+        std::ofstream out(std::filesystem::path{ path }, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        for (size_t c = 0; c < table.headers.size(); ++c) {
+            out << (c ? "," : "") << wstring_to_string(table.headers[c]);
+        }
+        out << "\n";
+        char buffer[32];
+        for (size_t r = 0; r < table.rowCount(); ++r) {
+            for (size_t c = 0; c < table.columns.size(); ++c) {
+                if (c) out << ",";
+                if (!std::isnan(table.columns[c][r])) {
+                    std::snprintf(buffer, sizeof(buffer), "%.10g", table.columns[c][r]);
+                    out << buffer;
+                }
+            }
+            out << "\n";
+        }
+        return static_cast<bool>(out);
+    }
+
+    // "XTRB" format 1, little endian: u32 magic, u32 version, u64 rows, u64 columns, per column a u32 byte length and the UTF-8 name,
+    // then the columns one after the other as rows doubles each. Column-major, so a reader can map or bulk-read single columns.
+    bool writeBinary(const std::wstring& path, const OutputData::Table& table) {
+        std::ofstream out(std::filesystem::path{ path }, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        auto put = [&out](const auto& value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+        put(uint32_t{ 0x42525458 });
+        put(uint32_t{ 1 });
+        put(static_cast<uint64_t>(table.rowCount()));
+        put(static_cast<uint64_t>(table.columns.size()));
+        for (const auto& header : table.headers) {
+            std::string name = wstring_to_string(header);
+            put(static_cast<uint32_t>(name.size()));
+            out.write(name.data(), name.size());
+        }
+        for (const auto& column : table.columns) {
+            out.write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(double));
+        }
+        return static_cast<bool>(out);
+    }
+
+    std::unique_ptr<RunScheduler> createScheduler(const Options& options, std::unique_ptr<ResultCache>& cache) {
+        if (!options.cacheRoot.empty()) {
+            cache = std::make_unique<ResultCache>(std::filesystem::absolute(options.cacheRoot).wstring(), 2ull << 30);
+        }
+        auto scheduler = std::make_unique<RunScheduler>(options.solverPath, std::filesystem::absolute(options.scratchRoot).wstring(), options.parallel);
+        scheduler->setResultCache(cache.get());
+        scheduler->setAbortOnDivergence(true);
+        scheduler->setNativeMode(options.native);
+        scheduler->setContinuation(options.continuation);
+        if (options.warm) {
+            scheduler->enableWarmStart();
+        }
+        return scheduler;
+    }
+
+    int runWorker(const Options& options) {
+        std::unique_ptr<ResultCache> cache;
+        std::unique_ptr<RunScheduler> scheduler = createScheduler(options, cache);
+        DistributedWorker worker(std::filesystem::absolute(options.workRoot).wstring(), *scheduler,
+            options.workerName.empty() ? DistributedWorker::defaultName() : options.workerName, options.distributed);
+        size_t jobs = worker.run();
+        std::cerr << "Worker ran " << jobs << " jobs\n";
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        std::cerr << usage;
+        return 1;
+    }
+    if (!options.workRoot.empty()) {
+        return runWorker(options);
+    }
+
+    InputData base;
+    SweepSpec spec;
+    if (!(options.jobPath.empty() ? readSweepSpec(options.sweepPath, spec, base) : readJobFile(options.jobPath, spec))) {
+        return 1;
+    }
+    for (const auto& [name, value] : options.overrides) {
+        if (!SweepEngine::applyParameter(base, name, value)) {
+            std::cerr << "Unknown field " << wstring_to_string(name) << "\n";
+            return 1;
+        }
+    }
+    std::vector<std::vector<double>> points = SweepEngine::designPoints(spec);
+
+    std::unique_ptr<ResultCache> cache;
+    std::unique_ptr<RunScheduler> scheduler;
+    std::unique_ptr<DistributedCoordinator> coordinator;
+    std::unique_ptr<SweepEngine> engine;
+    if (options.coordinateRoot.empty()) {
+        scheduler = createScheduler(options, cache);
+        engine = std::make_unique<SweepEngine>(*scheduler);
+        std::cerr << "Running " << points.size() << " cases, " << scheduler->maxParallel() << " at a time\n";
+    }
+    else {
+        coordinator = std::make_unique<DistributedCoordinator>(std::filesystem::absolute(options.coordinateRoot).wstring(), options.distributed);
+        engine = std::make_unique<SweepEngine>(*coordinator);
+        std::cerr << "Queueing " << points.size() << " cases in " << wstring_to_string(options.coordinateRoot) << "\n";
+    }
+    SweepResult result = engine->run(base, spec).get();
+    if (coordinator && options.stopWorkers) {
+        coordinator->stopWorkers();
+    }
+    if (result.table.headers.empty() && result.failedCases.empty()) {
+        return 1; // Unknown parameter or no cases, already logged
+    }
+
+    if (options.compress && scheduler) {
+        for (const auto& record : scheduler->registry().records()) {
+            if (record.state == RunRecord::State::Succeeded) {
+                FileCompressor(wstring_to_string(record.directory)).compressFiles(true);
+            }
+        }
+    }
+
+    if (options.native == RunScheduler::NativeMode::Validate && scheduler) {
+        size_t compared = 0;
+        double worst = 0.0;
+        std::wstring worstLabel;
+        for (const auto& record : scheduler->registry().records()) {
+            if (record.nativeDeviation < 0.0) continue;
+            ++compared;
+            if (record.nativeDeviation >= worst) {
+                worst = record.nativeDeviation;
+                worstLabel = record.label;
+            }
+        }
+        std::cerr << "Native solver compared on " << compared << " cases";
+        if (compared > 0) std::cerr << ", largest relative deviation " << worst << " (" << wstring_to_string(worstLabel) << ", details in the log)";
+        std::cerr << "\n";
+    }
+
+    if (scheduler) {
+        LaunchLatency latency = scheduler->launchLatency();
+        if (latency.runs > 0) {
+            std::cerr << wstring_to_string(latency.summary()) << "\n";
+        }
+    }
+
+    OutputData::Table table = resultTable(result, points);
+    if (!(options.binary ? writeBinary(options.outPath, table) : writeCsv(options.outPath, table))) {
+        std::cerr << "Failed to write " << wstring_to_string(options.outPath) << "\n";
+        return 1;
+    }
+    std::cerr << points.size() - result.failedCases.size() << " of " << points.size() << " cases succeeded, results in "
+        << wstring_to_string(options.outPath) << "\n";
+    return result.failedCases.empty() ? 0 : 2;
+}
\ No newline at end of file
@@ -1,83 +1,38 @@
 #include "XTurbRunner.h"
 #include "Logger.h"
-#include <fstream>
 #include <filesystem>
 
-XTurbRunner::XTurbRunner(const std::wstring& exePath) : exePath(exePath) {}
+XTurbRunner::XTurbRunner(const std::wstring& exePath, std::unique_ptr<ExecutionBackend> backend)
+    : exePath(exePath), backend(backend ? std::move(backend) : ExecutionBackend::createDefault()) {}
 
+// Runs XTurb in its own directory with the input file on stdin. The solver output ends up in XTurb_Execution_Log.txt next to the exe.
 bool XTurbRunner::run(const std::wstring& inputFilePath) {
     std::filesystem::path exeFsPath(exePath);
-    std::wstring exeDir = exeFsPath.parent_path().wstring();
-    std::wstring batFilePath = exeDir + L"\\run_xturb_temp.bat";
-    std::wstring logFilePath = exeDir + L"\\XTurb_Execution_Log.txt"; // Log file path
-
-    // Create a .bat file to run XTurb with input redirection
-    std::wofstream batFile(batFilePath);
-    if (!batFile.is_open()) {
-        Logger::logError(L"Failed to create batch file.");
-        return false;
-    }
-
-    // Write the batch contents
-    batFile << L"@echo off\n";
-    batFile << L"cd /d \"" << exeDir << L"\"\n";
-    batFile << L"\"" << exePath << L"\" < \"" << inputFilePath << L"\" > \"" << logFilePath << L"\" 2>&1\n";
-    batFile.close();
-
-    // Command line to run the batch
-    std::wstring commandLine = L"cmd.exe /C \"" + batFilePath + L"\"";
-
-    STARTUPINFOW si = { sizeof(si) };
-    PROCESS_INFORMATION pi = { 0 };
-
-    BOOL success = CreateProcessW(
-        nullptr,
-        &commandLine[0],
-        nullptr,
-        nullptr,
-        FALSE,
-        CREATE_NO_WINDOW,
-        nullptr,
-        nullptr,
-        &si,
-        &pi
-    );
-
-    if (!success) {
-        Logger::logError(L"Failed to run batch file. Error code: " + std::to_wstring(GetLastError()));
+    ExecutionRequest request;
+    request.executablePath = exePath;
+    request.workingDirectory = exeFsPath.parent_path().wstring();
+    request.stdinPath = inputFilePath;
+    request.logPath = (exeFsPath.parent_path() / L"XTurb_Execution_Log.txt").wstring();
+    request.timeoutMs = 30000; // wait max 30s
+
+    ExecutionResult result = backend->execute(request);
+    if (!result.started) {
+        Logger::logError(L"Failed to run XTurb: " + exePath);
         return false;
     }
-
-    // Wait for the process to complete
-    DWORD waitResult = WaitForSingleObject(pi.hProcess, 30000); // wait max 30s
-    if (waitResult != WAIT_OBJECT_0) {
+    if (result.timedOut) {
         Logger::logError(L"XTurb process timed out or failed to complete.");
-        TerminateProcess(pi.hProcess, 1);
-        CloseHandle(pi.hProcess);
-        CloseHandle(pi.hThread);
-        std::filesystem::remove(batFilePath);
         return false;
     }
-
-    CloseHandle(pi.hProcess);
-    CloseHandle(pi.hThread);
-
-    // Check if the log file was created
-    if (!std::filesystem::exists(logFilePath)) {
-        Logger::logError(L"Log file not created: " + logFilePath);
-    }
-    else {
-        Logger::logError(L"XTurb completed successfully. Output logged to: " + logFilePath);
+    if (result.exitCode != 0) {
+        Logger::logError(L"XTurb exited with code " + std::to_wstring(result.exitCode));
+        return false;
     }
 
-    // Cleanup Process; Important, otherwise program freezes.
-    std::filesystem::remove(batFilePath);
-
-    Logger::logError(L"XTurb completed successfully.");
+    Logger::logError(L"XTurb completed successfully. Output logged to: " + request.logPath);
     return true;
 }
 
 std::wstring XTurbRunner::getExePath() const {
     return exePath;
-}
-
+}
\ No newline at end of file
@@ -1,14 +1,17 @@
 #pragma once
-#include <windows.h>
+#include "ExecutionBackend.h"
+#include <memory>
 #include <string>
 
 // This class runs the XTurb Executable.
 class XTurbRunner {
 public:
-    XTurbRunner(const std::wstring& exePath);
+    // Without a backend the native one for the platform is used
+    XTurbRunner(const std::wstring& exePath, std::unique_ptr<ExecutionBackend> backend = nullptr);
     bool run(const std::wstring& inputFilePath);
     std::wstring getExePath() const;
 
 private:
     std::wstring exePath;
+    std::unique_ptr<ExecutionBackend> backend;
 };
\ No newline at end of file